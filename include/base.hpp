@@ -16,8 +16,10 @@
 
 #pragma once
 
+#include <array>
 #include <boost/asio/spawn.hpp>
 #include <functional>
+#include <optional>
 
 #include "base.h"
 
@@ -82,5 +84,14 @@ bool isSupported(pldm_tid_t tid, const uint8_t type, const uint8_t cmd);
  */
 bool isSupported(pldm_tid_t tid, const uint8_t type);
 
+/**
+ * @brief Get the UUID reported by the terminus through GetTerminusUID
+ *
+ * @param tid PLDM TID of device
+ * @return UUID of the terminus, std::nullopt if the terminus did not report
+ * one
+ */
+std::optional<std::array<uint8_t, 16>> getTerminusUUID(const pldm_tid_t tid);
+
 } // namespace base
 } // namespace pldm
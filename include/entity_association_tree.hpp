@@ -0,0 +1,107 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "entity_key.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+#include "pdr.h"
+
+namespace pldm
+{
+namespace platform
+{
+
+using ContainerID = uint16_t;
+using EntityNodeIndex = uint32_t;
+
+constexpr EntityNodeIndex invalidEntityNode =
+    std::numeric_limits<EntityNodeIndex>::max();
+
+/** @brief Container entity and the contained entities of an Entity
+ * Association PDR
+ */
+struct EntityAssociation
+{
+    pldm_entity containerEntity;
+    std::vector<pldm_entity> containedEntities;
+};
+
+/** @brief Node of the entity association tree. The contained entities of a
+ * node are stored next to each other in the node array.
+ */
+struct EntityNode
+{
+    pldm_entity entity;
+    EntityNodeIndex parent;
+    EntityNodeIndex firstChild;
+    EntityNodeIndex childCount;
+};
+
+/** @brief Entity association tree representing the system hierarchy
+ *
+ * Nodes are kept in a single array in breadth first order, so that a parent
+ * always precedes its contained entities. Nodes refer to each other by index
+ * and are looked up by entity through a hash index.
+ */
+class EntityAssociationTree
+{
+  public:
+    /** @brief Build the tree from the parsed Entity Association PDRs
+     *
+     * @param associations[in] - Entity associations. Associations with the
+     * same container entity are merged in place.
+     * @param rootContainerID[in] - Container ID of the entity represented by
+     * the terminus. Associations in this container form the root node.
+     *
+     * @return false if no root association is found
+     */
+    bool build(std::vector<EntityAssociation>& associations,
+               const ContainerID rootContainerID);
+
+    /** @brief Find the node of an entity*/
+    std::optional<EntityNodeIndex> find(const pldm_entity& entity) const;
+
+    /** @brief Nodes in breadth first order. Root node is the first one*/
+    const std::vector<EntityNode>& getNodes() const
+    {
+        return nodes;
+    }
+
+    bool empty() const
+    {
+        return nodes.empty();
+    }
+
+    void clear();
+
+  private:
+    /** @brief Append a node to the tree
+     *
+     * @return false if the entity is already in the tree
+     */
+    bool addNode(const pldm_entity& entity, const EntityNodeIndex parent);
+
+    std::vector<EntityNode> nodes;
+    EntityMap<EntityNodeIndex> nodeIndex;
+};
+
+} // namespace platform
+} // namespace pldm
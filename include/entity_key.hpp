@@ -0,0 +1,92 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "flat_map.hpp"
+
+#include <cstdint>
+
+#include "pdr.h"
+
+namespace pldm
+{
+namespace platform
+{
+
+/** @brief PLDM entity packed into 48 bits
+ *
+ * Entity type, entity instance number and container ID are kept in bits
+ * 47:32, 31:16 and 15:0 respectively, so that two entities are equal only if
+ * all the three fields are equal. Implicitly constructible from pldm_entity to
+ * look up entity keyed tables directly with an entity.
+ */
+class EntityKey
+{
+  public:
+    EntityKey(const pldm_entity& entity) :
+        value((static_cast<uint64_t>(entity.entity_type) << 32) |
+              (static_cast<uint64_t>(entity.entity_instance_num) << 16) |
+              static_cast<uint64_t>(entity.entity_container_id))
+    {
+    }
+
+    /** @brief Unpack the entity*/
+    pldm_entity getEntity() const
+    {
+        return {static_cast<uint16_t>(value >> 32),
+                static_cast<uint16_t>(value >> 16),
+                static_cast<uint16_t>(value)};
+    }
+
+    uint64_t getValue() const
+    {
+        return value;
+    }
+
+    bool operator==(const EntityKey& rhs) const
+    {
+        return value == rhs.value;
+    }
+
+    bool operator!=(const EntityKey& rhs) const
+    {
+        return value != rhs.value;
+    }
+
+  private:
+    uint64_t value;
+};
+
+} // namespace platform
+
+template <>
+struct FlatHash<platform::EntityKey>
+{
+    uint64_t operator()(const platform::EntityKey& key) const
+    {
+        return mixHash(key.getValue());
+    }
+};
+
+namespace platform
+{
+
+/** @brief Table keyed by PLDM entity*/
+template <typename Value>
+using EntityMap = FlatMap<EntityKey, Value>;
+
+} // namespace platform
+} // namespace pldm
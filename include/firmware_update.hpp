@@ -18,6 +18,7 @@
 #include "fwu_utils.hpp"
 
 #include <boost/asio/steady_timer.hpp>
+#include <deque>
 #include <sdbusplus/asio/object_server.hpp>
 #include <set>
 
@@ -28,34 +29,84 @@ namespace pldm
 namespace fwu
 {
 
+struct FWUChunkData;
+class FWUTelemetry;
+
+/** @brief Firmware update session of a terminus
+ *
+ * Each session has its own update state, timers and FD request routing, thus
+ * several termini can be updated from one package concurrently.
+ */
 class FWUpdate
 {
   public:
+    /** @brief Create update session
+     *
+     * @param _tid - TID of the FD
+     * @param _deviceIDRecord - Device ID record of the package matching FD
+     */
     FWUpdate(const pldm_tid_t _tid, const uint8_t _deviceIDRecord);
     int runUpdate(const boost::asio::yield_context yield);
+    /** @brief Queue a request sent by the FD and wake the session if it is
+     * waiting for one
+     */
     void validateReqForFWUpdCmd(const pldm_tid_t tid, const uint8_t messageTag,
                                 const std::vector<uint8_t>& req);
     bool setMatchedFDDescriptors();
     void terminateFwUpdate(const boost::asio::yield_context yield);
-    template <typename propertyType>
-    void updateFWUProperty(const boost::asio::yield_context yield,
-                           const std::string& interfaceName,
-                           const std::string& propertyName,
-                           const propertyType& propertyValue);
+
+    pldm_tid_t getTid() const
+    {
+        return currentTid;
+    }
+
+    /** @brief Percentage of the applicable components processed*/
+    uint8_t getUpdateProgress() const
+    {
+        return updateProgress;
+    }
+
+    /** @brief Close the telemetry of the session
+     *
+     * @param updated[in] - true if the update completed successfully
+     */
+    void finishTelemetry(const bool updated);
 
   private:
+    /** @brief Request received from the FD*/
+    struct FDRequest
+    {
+        uint8_t msgTag;
+        std::vector<uint8_t> data;
+    };
+
     bool isComponentApplicable();
     boost::system::error_code startTimer(const boost::asio::yield_context yield,
                                          const uint32_t interval);
+    /** @brief Wait till the FD sends the given command
+     *
+     * Requests queued before the command are answered on the way. A
+     * TransferComplete also ends a wait for RequestFirmwareData.
+     *
+     * @param command[in] - FD command the session waits for
+     * @param interval[in] - Milliseconds to wait for it
+     * @return true if the command is received, it is then in fdReq
+     */
+    bool waitForFDRequest(const boost::asio::yield_context yield,
+                          const uint8_t command, const uint32_t interval);
+    /** @brief Answer a request the session is not waiting for*/
+    void dispatchFDRequest(const boost::asio::yield_context yield,
+                           const FDRequest& request);
+    /** @brief Check if the FD may send the command in the current state*/
+    bool isFDCommandValid(const uint8_t command) const;
     uint32_t findMaxNumReq(const uint32_t size)
     {
         return (1 + (size / PLDM_FWU_BASELINE_TRANSFER_SIZE)) * 3;
     }
-    uint64_t getApplicableComponents();
+    uint64_t getApplicableComponentsSize();
     uint16_t getReserveEidTimeOut();
     void cancelReserveBWTimer();
     void activateReserveBandwidth();
-    uint16_t getApplicableComponentsCount(uint64_t val) const;
     int processRequestUpdate(const boost::asio::yield_context yield);
     int requestUpdate(const boost::asio::yield_context yield,
                       struct variable_field& compImgSetVerStrn);
@@ -66,7 +117,8 @@ class FWUpdate
                           uint32_t& nextDataTransferHandle,
                           uint8_t& transferFlag);
     int processSendPackageData(const boost::asio::yield_context yield);
-    int sendPackageData(const boost::asio::yield_context yield, size_t& offset,
+    int sendPackageData(const boost::asio::yield_context yield,
+                        const std::vector<uint8_t>& pldmReq, size_t& offset,
                         size_t& length, std::set<uint32_t>& recvdRequests);
     uint8_t setTransferFlag(const size_t offset, const size_t length,
                             const size_t dataSize);
@@ -90,6 +142,7 @@ class FWUpdate
                         bitfield32_t& updateOptFlagsEnabled,
                         uint16_t& estimatedTimeReqFd);
     int processRequestFirmwareData(const boost::asio::yield_context yield);
+    int resumeComponentDownload(const boost::asio::yield_context yield);
     int requestFirmwareData(const boost::asio::yield_context yield,
                             const std ::vector<uint8_t>& pldmReq,
                             uint32_t& offset, uint32_t& length,
@@ -127,6 +180,16 @@ class FWUpdate
                          bool8_t selfContainedActivationReq,
                          uint16_t& estimatedTimeForSelfContainedActivation);
     int getStatus(const boost::asio::yield_context yield);
+    /** @brief Poll GetStatus till the FD is back to IDLE after activation
+     *
+     * @param estimatedTimeForSelfContainedActivation[in] - Seconds the FD
+     * estimated for the activation, a margin is added on top
+     *
+     * @return false if the FD did not return to IDLE in time
+     */
+    bool waitForActivation(
+        const boost::asio::yield_context yield,
+        const uint16_t estimatedTimeForSelfContainedActivation);
     int doCancelUpdateComponent(const boost::asio::yield_context yield);
     int cancelUpdateComponent(const boost::asio::yield_context yield);
     int doCancelUpdate(const boost::asio::yield_context yield,
@@ -150,14 +213,19 @@ class FWUpdate
     void compUpdateProgress(const boost::asio::yield_context yield);
 
     int processSendMetaData(const boost::asio::yield_context yield);
-    int sendMetaData(const boost::asio::yield_context yield, size_t& offset,
+    int sendMetaData(const boost::asio::yield_context yield,
+                     const std::vector<uint8_t>& pldmReq, size_t& offset,
                      size_t& length, std::set<uint32_t>& recvdRequests);
     uint16_t passCompCount = 0;
     pldm_tid_t currentTid;
-    uint8_t expectedCmd;
     uint8_t msgTag;
     std::vector<uint8_t> fdReq;
-    bool fdReqMatched = false;
+    /** @brief Requests from the FD not handled yet, in arrival order*/
+    std::deque<FDRequest> fdReqQueue;
+    /** @brief true while the session waits for a request from the FD*/
+    bool fdReqWaiting = false;
+    /** @brief Waits for the expected command from FD*/
+    std::unique_ptr<boost::asio::steady_timer> expectedCommandTimer = nullptr;
     bool isReserveBandwidthActive = false;
     std::unique_ptr<boost::asio::steady_timer> reserveBWTimer = nullptr;
     bool isComponentAvailableForUpdate = false;
@@ -170,12 +238,13 @@ class FWUpdate
     uint16_t currentComp = 0;
     uint16_t compCount = 0;
     uint8_t fdWillSendGetPkgDataCmd = 0;
-    uint64_t applicableComponentsVal = 0;
+    ApplicableComponents applicableComponents;
     uint8_t currentState = 0;
     uint8_t previousState = 0;
     uint8_t auxState = 0;
     uint8_t auxStateStatus = 0;
     uint8_t progressPercent = 0;
+    uint8_t updateProgress = 0;
     uint8_t reasonCode = 0;
     bool fdTransferCompleted = false;
     std::string componentImageSetVersionString;
@@ -188,6 +257,18 @@ class FWUpdate
     uint8_t transferHandle = 0;
     std::vector<uint8_t> packageData;
     std::vector<uint8_t> fwDeviceMetaData;
+    /** @brief RequestFirmwareData response, reused across the requests*/
+    std::vector<uint8_t> fwDataResp;
+    /** @brief Window of the component being served*/
+    std::shared_ptr<const FWUChunkData> fwDataWindow;
+    /** @brief Holds requested data spanning windows*/
+    std::vector<uint8_t> fwDataScratch;
+    /** @brief Highest offset requested by the FD in the current component.
+     * The FD holds the data below it.
+     */
+    uint32_t fwDataAckedOffset = 0;
+    /** @brief Measured progress, outlives the session on D-Bus*/
+    std::shared_ptr<FWUTelemetry> telemetry;
 };
 } // namespace fwu
 } // namespace pldm
@@ -0,0 +1,275 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace pldm
+{
+
+/** @brief Finalizer of MurmurHash3. Every input bit affects every output bit,
+ * thus the low bits can be used to index a power of two sized table.
+ */
+inline uint64_t mixHash(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+/** @brief Default hash of FlatMap. Specialize for non integral keys*/
+template <typename Key>
+struct FlatHash
+{
+    static_assert(std::is_integral_v<Key>, "FlatHash needs an integral key");
+
+    uint64_t operator()(const Key& key) const
+    {
+        return mixHash(static_cast<uint64_t>(key));
+    }
+};
+
+/** @brief Open addressing hash map with linear probing
+ *
+ * Entries are stored in a single array, which keeps lookups cache friendly
+ * and avoids an allocation per entry. The tables using it are filled once
+ * while initializing a terminus, therefore entries are never erased
+ * individually.
+ */
+template <typename Key, typename Value, typename Hash = FlatHash<Key>>
+class FlatMap
+{
+  public:
+    using value_type = std::pair<Key, Value>;
+
+    template <bool isConst>
+    class Iterator
+    {
+      public:
+        using value_type = FlatMap::value_type;
+        using Slots = std::conditional_t<
+            isConst, const std::vector<std::optional<value_type>>,
+            std::vector<std::optional<value_type>>>;
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using reference =
+            std::conditional_t<isConst, const value_type&, value_type&>;
+        using pointer =
+            std::conditional_t<isConst, const value_type*, value_type*>;
+
+        Iterator(Slots& mapSlots, size_t startSlot) :
+            slots(&mapSlots), slot(startSlot)
+        {
+            skipEmpty();
+        }
+
+        reference operator*() const
+        {
+            return *(*slots)[slot];
+        }
+
+        pointer operator->() const
+        {
+            return &*(*slots)[slot];
+        }
+
+        Iterator& operator++()
+        {
+            ++slot;
+            skipEmpty();
+            return *this;
+        }
+
+        bool operator==(const Iterator& rhs) const
+        {
+            return slot == rhs.slot;
+        }
+
+        bool operator!=(const Iterator& rhs) const
+        {
+            return slot != rhs.slot;
+        }
+
+      private:
+        void skipEmpty()
+        {
+            while (slot < slots->size() && !(*slots)[slot])
+            {
+                ++slot;
+            }
+        }
+
+        Slots* slots;
+        size_t slot;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    iterator begin()
+    {
+        return iterator(slots, 0);
+    }
+
+    iterator end()
+    {
+        return iterator(slots, slots.size());
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(slots, 0);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(slots, slots.size());
+    }
+
+    size_t size() const
+    {
+        return count;
+    }
+
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    /** @brief Make room for entryCount entries without rehashing*/
+    void reserve(const size_t entryCount)
+    {
+        size_t capacity = minCapacity;
+        while (!withinLoadFactor(entryCount, capacity))
+        {
+            capacity *= 2;
+        }
+        if (capacity > slots.size())
+        {
+            rehash(capacity);
+        }
+    }
+
+    void clear()
+    {
+        slots.clear();
+        count = 0;
+    }
+
+    iterator find(const Key& key)
+    {
+        if (slots.empty())
+        {
+            return end();
+        }
+        size_t slot = probe(key);
+        return slots[slot] ? iterator(slots, slot) : end();
+    }
+
+    const_iterator find(const Key& key) const
+    {
+        if (slots.empty())
+        {
+            return end();
+        }
+        size_t slot = probe(key);
+        return slots[slot] ? const_iterator(slots, slot) : end();
+    }
+
+    /** @brief Insert an entry constructed from args if the key is not
+     * present, like std::unordered_map::try_emplace
+     *
+     * @return Iterator to the entry with the key and true if inserted
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(const Key& key, Args&&... args)
+    {
+        if (!withinLoadFactor(count + 1, slots.size()))
+        {
+            rehash(slots.empty() ? minCapacity : slots.size() * 2);
+        }
+
+        size_t slot = probe(key);
+        if (slots[slot])
+        {
+            return {iterator(slots, slot), false};
+        }
+        slots[slot].emplace(std::piecewise_construct,
+                            std::forward_as_tuple(key),
+                            std::forward_as_tuple(std::forward<Args>(args)...));
+        ++count;
+        return {iterator(slots, slot), true};
+    }
+
+    Value& operator[](const Key& key)
+    {
+        return emplace(key).first->second;
+    }
+
+  private:
+    static constexpr size_t minCapacity = 8;
+
+    /** @brief Keep at most 3/4 of the slots used so that probe sequences stay
+     * short
+     */
+    static bool withinLoadFactor(const size_t entryCount,
+                                 const size_t capacity)
+    {
+        return entryCount * 4 <= capacity * 3;
+    }
+
+    /** @brief Find the slot holding the key or the empty slot where it should
+     * be inserted. There is always an empty slot due to the load factor.
+     */
+    size_t probe(const Key& key) const
+    {
+        size_t mask = slots.size() - 1;
+        size_t slot = Hash{}(key) & mask;
+        while (slots[slot] && !(slots[slot]->first == key))
+        {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    void rehash(const size_t capacity)
+    {
+        std::vector<std::optional<value_type>> oldSlots(capacity);
+        oldSlots.swap(slots);
+        for (std::optional<value_type>& entry : oldSlots)
+        {
+            if (entry)
+            {
+                slots[probe(entry->first)] = std::move(entry);
+            }
+        }
+    }
+
+    std::vector<std::optional<value_type>> slots;
+    size_t count = 0;
+};
+
+} // namespace pldm
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "fru_table.hpp"
 #include "pldm.hpp"
 
 #include <phosphor-logging/log.hpp>
@@ -29,31 +30,25 @@ namespace fru
 {
 
 using FRUMetadata = std::map<std::string, uint32_t>;
-using FRUVariantType = std::variant<uint8_t, uint32_t, std::string>;
-using FRUProperties = std::map<std::string, FRUVariantType>;
 
 static constexpr uint16_t timeout = 100;
 static constexpr size_t retryCount = 3;
-constexpr uint8_t timeStamp104Size = 13;
 
-static inline const std::map<uint8_t, const char*> fruEncodingType{
-    {PLDM_FRU_ENCODING_UNSPECIFIED, "Unspecified"},
-    {PLDM_FRU_ENCODING_ASCII, "ASCII"},
-    {PLDM_FRU_ENCODING_UTF8, "UTF8"},
-    {PLDM_FRU_ENCODING_UTF16, "UTF16"},
-    {PLDM_FRU_ENCODING_UTF16LE, "UTF16LE"},
-    {PLDM_FRU_ENCODING_UTF16BE, "UTF16BE"}};
-
-static inline const std::map<uint8_t, const char*> fruRecordTypes{
-    {PLDM_FRU_RECORD_TYPE_GENERAL, "General"},
-    {PLDM_FRU_RECORD_TYPE_OEM, "OEM"}};
-
-/** @brief return properties of the Fru
+/** @brief return properties of the Fru, decoded from the primary FRU record
+ * set
  *
  * @return FRUProperties on success and nullopt on failure
  */
 std::optional<FRUProperties> getProperties(const pldm_tid_t tid);
 
+/** @brief return a property of the Fru, decoded from the primary FRU record
+ * set
+ *
+ * @return Property value on success and nullopt on failure
+ */
+std::optional<FRUVariantType> getProperty(const pldm_tid_t tid,
+                                          const std::string& name);
+
 class GetPLDMFRU
 {
   public:
@@ -89,14 +84,27 @@ class GetPLDMFRU
      * @return PLDM_SUCCESS on success and corresponding error completion code
      * on failure
      */
-    int getFRURecordTableCmd(FRUProperties& fruProperties);
+    int getFRURecordTableCmd();
+
+    /** @brief Restore the FRU Record Table from cache if the metadata length
+     * and checksum match the cached table
+     *
+     * @return true on cache hit
+     */
+    bool loadCachedFRURecordTable();
+
+    /** @brief Persist the FRU Record Table of the terminus keyed by its UUID*/
+    void cacheFRURecordTable(const std::vector<uint8_t>& fruTable);
 
     /** @brief verify Integrity checksum on the FRU Table Data with metadata
      * checksum value
      *
+     * @param checksum[in] - CRC-32 of the FRU Table Data received, including
+     * the padding
+     *
      * @return true on success and false on checksum match failure
      */
-    bool verifyCRC(std::vector<uint8_t>& fruTable);
+    bool verifyCRC(const uint32_t checksum);
 
     boost::asio::yield_context yield;
     pldm_tid_t tid;
@@ -121,201 +129,17 @@ class SetPLDMFRU
                         const uint32_t dataTransferHandle, const size_t offset,
                         const size_t length,
                         const std::vector<uint8_t>& setFruData);
+
+    /** @brief Transfer the FRU table in chunks growing from the baseline
+     * size up to the largest length accepted by the terminus. One request
+     * buffer is reused for all the chunks and a chunk failing in transport
+     * is resent unchanged from the last acknowledged transfer handle instead
+     * of restarting the table. Only a chunk rejected for its length is
+     * retried smaller.
+     */
     int sendFruData(boost::asio::yield_context yield,
                     const std::vector<uint8_t>& setFruData);
 };
 
-class PLDMFRUTable
-{
-  public:
-    PLDMFRUTable() = delete;
-    PLDMFRUTable(const std::vector<uint8_t> tableVal, const pldm_tid_t tidVal);
-    ~PLDMFRUTable();
-
-    std::optional<FRUProperties> parseTable();
-
-  private:
-    using FRUFieldParser =
-        std::function<std::string(const uint8_t* value, uint8_t length)>;
-
-    using FieldType = uint8_t;
-    using RecordType = uint8_t;
-    using FieldName = std::string;
-    using FRUFieldTypes =
-        std::map<FieldType, std::pair<FieldName, FRUFieldParser>>;
-
-    bool isTableEnd(const uint8_t* pTable);
-
-    std::string typeToString(std::map<uint8_t, const char*> typeMap,
-                             uint8_t type)
-    {
-        auto typeString = std::to_string(type);
-        auto typeFound = typeMap.find(type);
-        if (typeFound != typeMap.end())
-        {
-            return typeString + "(" + typeFound->second + ")";
-        }
-        return typeString;
-    }
-
-    static std::string fruFieldParserString(const uint8_t* value,
-                                            uint8_t length)
-    {
-        assert(value != NULL);
-        if (length < 1)
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "Invalid FRU field length");
-            return std::string("");
-        }
-        std::string strVal(reinterpret_cast<const char*>(value), length);
-        // non printable characters cause sdbusplus exceptions, so better to
-        // handle it by replacing with space
-        std::replace_if(
-            strVal.begin(), strVal.end(),
-            [](const char& c) { return !isprint(c); }, ' ');
-        return strVal;
-    }
-
-    static std::string
-        convertTStamp104ToCIMFormat(const timestamp104_t& fruStamp)
-    {
-        std::stringstream timeStampStr;
-
-        enum CIMTimeStampVarLength
-        {
-            width2 = 2,
-            width3 = 3,
-            width4 = 4,
-            width6 = 6,
-        };
-
-        if (!((fruStamp.year >= 1980 && fruStamp.year <= 9999) &&
-              (fruStamp.month >= 1 && fruStamp.month <= 12) &&
-              (fruStamp.day >= 1 && fruStamp.day <= 31) &&
-              (fruStamp.hour < 24) && (fruStamp.minute < 60) &&
-              (fruStamp.second < 60) &&
-              ((fruStamp.microsecond >= 0) &&
-               (fruStamp.microsecond <= 999999)) &&
-              (fruStamp.utc_offset >= -999 && fruStamp.utc_offset <= 999)))
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "TimeStamp is not valid");
-            return timeStampStr.str();
-        }
-        // handle CIM conversions and UTC offset
-        timeStampStr << std::setfill('0') << std::setw(width4) << fruStamp.year
-                     << std::setfill('0') << std::setw(width2)
-                     << static_cast<int>(fruStamp.month) << std::setfill('0')
-                     << std::setw(width2) << static_cast<int>(fruStamp.day)
-                     << std::setfill('0') << std::setw(width2)
-                     << static_cast<int>(fruStamp.hour) << std::setfill('0')
-                     << std::setw(width2) << static_cast<int>(fruStamp.minute)
-                     << std::setfill('0') << std::setw(width2)
-                     << static_cast<int>(fruStamp.second) << "."
-                     << std::setfill('0') << std::setw(width6)
-                     << fruStamp.microsecond;
-        if (fruStamp.utc_offset >= 0)
-        {
-            timeStampStr << "+";
-        }
-        else
-        {
-            timeStampStr << "-";
-        }
-        timeStampStr << std::setfill('0') << std::setw(width3)
-                     << std::to_string(fruStamp.utc_offset);
-
-        return timeStampStr.str();
-    }
-
-    static std::string fruFieldParserTimestamp(const uint8_t* value,
-                                               uint8_t length)
-    {
-        assert(value != NULL);
-        timestamp104_t fruStamp;
-
-        if (length != timeStamp104Size)
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "Invalid time stamp length");
-            return std::string("");
-        }
-
-        try
-        {
-            std::copy_n(value, timeStamp104Size,
-                        reinterpret_cast<uint8_t*>(&fruStamp));
-        }
-        catch (std::exception& e)
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                ("Exception Received FRU timestamp parsing error" +
-                 std::string(e.what()))
-                    .c_str());
-            return std::string("");
-        }
-        catch (...)
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "Exception Occured FRU timestamp parsing error");
-            return std::string("");
-        }
-
-        return (convertTStamp104ToCIMFormat(fruStamp));
-    }
-
-    static std::string fruFieldParserU32(const uint8_t* value, uint8_t length)
-    {
-        assert(value != NULL);
-        if (length == 4)
-        {
-            uint32_t v;
-            std::memcpy(&v, value, length);
-            return std::to_string(le32toh(*reinterpret_cast<uint32_t*>(v)));
-        }
-        else
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "Vendor IANA should be of length 4");
-            return std::string("");
-        }
-    }
-
-    static inline const FRUFieldTypes fruGeneralFieldTypes = {
-        {PLDM_FRU_FIELD_TYPE_CHASSIS, {"ChassisType", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_MODEL, {"Model", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_PN, {"PN", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_SN, {"SN", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_MANUFAC, {"Manufacturer", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_MANUFAC_DATE,
-         {"ManufacturerDate", fruFieldParserTimestamp}},
-        {PLDM_FRU_FIELD_TYPE_VENDOR, {"Vendor", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_NAME, {"Name", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_SKU, {"SKU", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_VERSION, {"Version", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_ASSET_TAG, {"AssetTag", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_DESC, {"Description", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_EC_LVL, {"ECLevel", fruFieldParserString}},
-        {PLDM_FRU_FIELD_TYPE_IANA, {"IANA", fruFieldParserU32}},
-    };
-
-    static inline const FRUFieldTypes fruOEMFieldTypes = {
-        {1, {"Vendor IANA", fruFieldParserU32}},
-
-    };
-
-    static inline const std::map<RecordType, FRUFieldTypes> fruFieldTypes{
-        {PLDM_FRU_RECORD_TYPE_GENERAL, fruGeneralFieldTypes},
-        {PLDM_FRU_RECORD_TYPE_OEM, fruOEMFieldTypes}};
-
-    bool parseFRUField(uint8_t recordType, uint8_t type, uint8_t length,
-                       const uint8_t* value);
-
-    const std::vector<uint8_t> table;
-    pldm_tid_t tid;
-    FRUProperties fruProperties;
-};
-
 } // namespace fru
 } // namespace pldm
@@ -0,0 +1,59 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "fru.hpp"
+
+#include <array>
+#include <optional>
+#include <vector>
+
+namespace pldm
+{
+namespace fru
+{
+
+using UUID = std::array<uint8_t, 16>;
+
+/** @brief Load the cached FRU Record Table of a terminus
+ *
+ * Cache is valid only if it was stored for the same table length and
+ * checksum reported by GetFRURecordTableMetadata, and the CRC-32 of the
+ * cached table matches the checksum.
+ *
+ * @param uuid[in] - UUID of the terminus
+ * @param tableLength[in] - FRUTableLength from metadata
+ * @param checksum[in] - Checksum from metadata
+ *
+ * @return Cached table on cache hit, std::nullopt otherwise
+ */
+std::optional<std::vector<uint8_t>>
+    loadFRUTableCache(const UUID& uuid, const uint32_t tableLength,
+                      const uint32_t checksum);
+
+/** @brief Persist the FRU Record Table of a terminus
+ *
+ * @param uuid[in] - UUID of the terminus
+ * @param tableLength[in] - FRUTableLength from metadata
+ * @param checksum[in] - Checksum from metadata
+ * @param table[in] - Table as received, padded for CRC-32
+ */
+void storeFRUTableCache(const UUID& uuid, const uint32_t tableLength,
+                        const uint32_t checksum,
+                        const std::vector<uint8_t>& table);
+
+} // namespace fru
+} // namespace pldm
@@ -54,7 +54,13 @@ class IpmiFru
     std::shared_ptr<sdbusplus::asio::dbus_interface> fruIface;
     std::map<pldm_tid_t, FRUProperties> ipmiFRUProperties;
 
-    /** @brief returns the FRUData in IPMI format
+    /** @brief FRUData in IPMI format, built from ipmiFRUProperties on the
+     * first GetRawFru. Dropped whenever ipmiFRUProperties of the TID changes.
+     */
+    std::map<pldm_tid_t, std::vector<uint8_t>> ipmiFRURawData;
+
+    /** @brief returns the FRUData in IPMI format. Encoded once per TID and
+     * served from ipmiFRURawData afterwards.
      *
      * @return FRURecord in IPMI format on success; empty table otherwise
      * on failure
@@ -0,0 +1,148 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "pldm.hpp"
+
+#include <map>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "fru.h"
+#include "pldm_types.h"
+
+namespace pldm
+{
+namespace fru
+{
+
+using FRUVariantType = std::variant<uint8_t, uint32_t, std::string>;
+using FRUProperties = std::map<std::string, FRUVariantType>;
+using FRURecordSetID = uint16_t;
+
+constexpr uint8_t timeStamp104Size = 13;
+
+/** @brief Typed view of a FRU field value. Refers to the FRU Record Table
+ * and is valid as long as the table is.
+ */
+class FRUFieldView
+{
+  public:
+    FRUFieldView(const uint8_t* fieldValue, const uint8_t fieldLength) :
+        value(fieldValue), length(fieldLength)
+    {
+    }
+
+    /** @brief Value as string. Non printable characters are replaced with
+     * space as they cause sdbusplus exceptions.
+     */
+    std::optional<std::string> toString() const;
+
+    /** @brief Value as little endian 32 bit integer, e.g. IANA*/
+    std::optional<uint32_t> toU32() const;
+
+    /** @brief Value as timestamp104*/
+    std::optional<timestamp104_t> toTimestamp104() const;
+
+    /** @brief Value as timestamp104 in CIM format,
+     * yyyymmddhhmmss.mmmmmmsutc
+     */
+    std::optional<std::string> toCIMTimestamp() const;
+
+  private:
+    const uint8_t* value;
+    uint8_t length;
+};
+
+/** @brief Location of a FRU field in the FRU Record Table*/
+struct FRUFieldIndex
+{
+    uint32_t offset;
+    uint8_t type;
+    uint8_t length;
+};
+
+/** @brief FRU record in the FRU Record Table. Its fields are fieldCount
+ * entries of the field index starting at firstField.
+ */
+struct FRURecordIndex
+{
+    FRURecordSetID recordSetID;
+    uint8_t recordType;
+    uint8_t encodingType;
+    uint32_t firstField;
+    uint32_t fieldCount;
+};
+
+/** @brief FRU Record Table of a terminus
+ *
+ * The table is indexed once, recording where the records and fields are.
+ * Field values are decoded only when they are looked up.
+ */
+class PLDMFRUTable
+{
+  public:
+    PLDMFRUTable() = delete;
+    PLDMFRUTable(std::vector<uint8_t> tableVal, const pldm_tid_t tidVal);
+
+    /** @brief Index the records and fields of the table in a single pass
+     *
+     * @return false if the table is malformed
+     */
+    bool indexTable();
+
+    /** @brief FRU Record Table as received, including the padding*/
+    const std::vector<uint8_t>& getTable() const
+    {
+        return table;
+    }
+
+    /** @brief Record sets having General FRU records, in table order*/
+    std::vector<FRURecordSetID> getRecordSetIDs() const;
+
+    /** @brief Record set of the first General FRU record. It describes the
+     * terminus itself.
+     */
+    std::optional<FRURecordSetID> getPrimaryRecordSetID() const;
+
+    /** @brief Find a field of the FRU records of a record set*/
+    std::optional<FRUFieldView> findField(
+        const FRURecordSetID recordSetID, const uint8_t fieldType,
+        const uint8_t recordType = PLDM_FRU_RECORD_TYPE_GENERAL) const;
+
+    /** @brief Decode a FRU field by property name, e.g. "SN". OEM record
+     * fields are looked up by their name, e.g. "Vendor IANA".
+     */
+    std::optional<FRUVariantType>
+        getProperty(const FRURecordSetID recordSetID,
+                    const std::string& name) const;
+
+    /** @brief Decode the General FRU fields of a record set. OEM records
+     * are left out as their field names are not valid property names.
+     */
+    FRUProperties getProperties(const FRURecordSetID recordSetID) const;
+
+  private:
+    std::vector<uint8_t> table;
+    pldm_tid_t tid;
+    std::vector<FRURecordIndex> records;
+    std::vector<FRUFieldIndex> fields;
+};
+
+} // namespace fru
+} // namespace pldm
@@ -31,14 +31,9 @@ namespace fruUtils
 std::optional<VariantType> getFruProperty(const pldm_tid_t tid,
                                           std::string propertyName)
 {
-    if (auto prop = pldm::fru::getProperties(tid))
+    if (auto prop = pldm::fru::getProperty(tid, propertyName))
     {
-        pldm::fru::FRUProperties properties = *prop;
-        auto itr = properties.find(propertyName);
-        if (itr != properties.end())
-        {
-            return itr->second;
-        }
+        return prop;
     }
 
     phosphor::logging::log<phosphor::logging::level::INFO>(
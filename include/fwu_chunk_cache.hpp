@@ -0,0 +1,106 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "pldm_fwu_image.hpp"
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace pldm
+{
+namespace fwu
+{
+
+/** @brief Window of component data read from the package*/
+struct FWUChunkData
+{
+    /** @brief Offset of the window within the component*/
+    uint32_t offset;
+    std::vector<uint8_t> data;
+};
+
+using FWUChunk = std::shared_ptr<const FWUChunkData>;
+
+/** @brief Location of a component in the package*/
+struct FWUComponentRange
+{
+    uint16_t index;
+    uint32_t location;
+    uint32_t size;
+};
+
+/** @brief Component data cache shared by the update sessions of a package
+ *
+ * Component data is read from the package one window at a time. A window is
+ * kept as long as a session refers to it, and the most recently read windows
+ * are kept in addition. Thus sessions updating identical devices read the
+ * package once between them.
+ */
+class FWUChunkCache
+{
+  public:
+    FWUChunkCache() = delete;
+    FWUChunkCache(const PLDMImg& img, const uint32_t windowSizeVal,
+                  const size_t maxRecentWindowsVal);
+
+    /** @brief Get component data
+     *
+     * @param component[in] - Component to read from
+     * @param offset[in] - Offset of the data within the component
+     * @param length[in] - Bytes to read. Must lie within the component.
+     * @param window[out] - Window holding the data. Keeps the returned data
+     * valid.
+     * @param scratch[out] - Data spanning more than a window is copied here
+     *
+     * @return Pointer to the data. nullptr if the package cannot be read.
+     */
+    const uint8_t* getData(const FWUComponentRange& component,
+                           const uint32_t offset, const uint32_t length,
+                           FWUChunk& window, std::vector<uint8_t>& scratch);
+
+    uint64_t getHits() const
+    {
+        return hits;
+    }
+
+    uint64_t getMisses() const
+    {
+        return misses;
+    }
+
+  private:
+    /** @brief Get the window starting at windowOffset, reading it from the
+     * package if it is not cached
+     */
+    FWUChunk getWindow(const FWUComponentRange& component,
+                       const uint32_t windowOffset);
+
+    const PLDMImg& pldmImg;
+    uint32_t windowSize;
+    size_t maxRecentWindows;
+    /** @brief Windows keyed by component index and window offset*/
+    std::map<std::pair<uint16_t, uint32_t>, std::weak_ptr<const FWUChunkData>>
+        windows;
+    std::deque<FWUChunk> recentWindows;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+};
+
+} // namespace fwu
+} // namespace pldm
@@ -38,6 +38,22 @@ class FWInventoryInfo
      */
     void addInventoryInfoToDBus();
 
+    /** @brief Re-run GetFirmwareParameters after an update and set the
+     * version properties that changed on the D-Bus objects of the terminus.
+     * Descriptors are not queried again.
+     *
+     * @param inventoryPathVal[in] - Software inventory object of the terminus
+     * @param interfaces[in] - Interfaces added for the terminus at discovery
+     * @param fdProperties[in,out] - Properties of the terminus, updated with
+     * the firmware parameters read
+     * @return false if the firmware parameters could not be read
+     */
+    bool refreshFirmwareParameters(
+        boost::asio::yield_context yield, const std::string& inventoryPathVal,
+        std::vector<std::unique_ptr<sdbusplus::asio::dbus_interface>>&
+            interfaces,
+        FDProperties& fdProperties);
+
     std::vector<std::unique_ptr<sdbusplus::asio::dbus_interface>>&
         getInterfaces()
     {
@@ -112,6 +128,17 @@ class FWInventoryInfo
      */
     std::string getInventoryName();
 
+    /** @brief Set a property of one of the interfaces if its value changed
+     *
+     * @return true if the property is set
+     */
+    template <typename T>
+    static bool updateChangedProperty(
+        std::vector<std::unique_ptr<sdbusplus::asio::dbus_interface>>&
+            interfaces,
+        const std::string& objPath, const std::string& interfaceName,
+        const std::string& propertyName, const T& oldValue, const T& newValue);
+
     pldm_tid_t tid;
     std::shared_ptr<sdbusplus::asio::object_server> objServer;
     // map that holds the component properties of a terminus
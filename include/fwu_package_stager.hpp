@@ -0,0 +1,90 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <boost/asio/posix/stream_descriptor.hpp>
+#include <boost/asio/spawn.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pldm
+{
+namespace fwu
+{
+
+/** @brief Stages a firmware update package received as a stream
+ *
+ * The stream, e.g. a pipe from the update service, is copied chunk by chunk
+ * into a staging file. The package header is checked as soon as it has
+ * arrived, so a stream that is not a valid package is dropped before its
+ * components are spooled. Memory in use is the header and one chunk, whatever
+ * the package size.
+ */
+class FWUPackageStager
+{
+  public:
+    FWUPackageStager() = delete;
+    FWUPackageStager(const FWUPackageStager&) = delete;
+    FWUPackageStager& operator=(const FWUPackageStager&) = delete;
+    /** @brief Take over a stream
+     *
+     * @param fd[in] - Stream to read the package from, closed by the stager
+     * @param stagingFilePathVal[in] - File to stage the package in
+     * @param maxPackageSizeVal[in] - Largest package accepted
+     */
+    FWUPackageStager(const int fd, const std::string& stagingFilePathVal,
+                     const uintmax_t maxPackageSizeVal);
+    ~FWUPackageStager();
+
+    /** @brief Copy the stream into the staging file till it ends
+     *
+     * @return true if a package with a valid header is staged. The staging
+     * file is removed otherwise.
+     */
+    bool stage(boost::asio::yield_context yield);
+
+  private:
+    /** @brief Read the next chunk of the stream
+     *
+     * @return Bytes read, 0 at the end of the stream, -1 on error
+     */
+    ssize_t readChunk(boost::asio::yield_context yield);
+
+    /** @brief Check the package header once enough of it has arrived
+     *
+     * @return false if the stream is not a valid package
+     */
+    bool checkHeader(const uint8_t* data, const size_t size);
+
+    bool writeChunk(const uint8_t* data, const size_t size);
+
+    boost::asio::posix::stream_descriptor stream;
+    /** @brief Stream that cannot be polled, e.g. a regular file*/
+    int sourceFd = -1;
+    int stagingFd = -1;
+    std::string stagingFilePath;
+    uintmax_t maxPackageSize;
+    uintmax_t stagedBytes = 0;
+    std::vector<uint8_t> chunk;
+    /** @brief Package header collected till it can be checked*/
+    std::vector<uint8_t> header;
+    uint16_t headerLen = 0;
+    bool headerChecked = false;
+};
+
+} // namespace fwu
+} // namespace pldm
@@ -0,0 +1,104 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "fwu_chunk_cache.hpp"
+
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <map>
+#include <vector>
+
+namespace pldm
+{
+namespace fwu
+{
+
+/** @brief Component digests of a package, index to CRC-32*/
+using FWUComponentDigests = std::map<uint16_t, uint32_t>;
+
+/** @brief Checks the component images of a package in the background
+ *
+ * Streams each component once, computing its CRC-32 and comparing it with
+ * the expected digest when one is given. Runs while the update sessions go
+ * through RequestUpdate and PassComponentTable, so a corrupt package is
+ * caught before any component is transferred.
+ */
+class FWUPackageValidator
+{
+  public:
+    enum class Status
+    {
+        pending,
+        passed,
+        failed
+    };
+
+    FWUPackageValidator() = delete;
+    FWUPackageValidator(const FWUPackageValidator&) = delete;
+    FWUPackageValidator& operator=(const FWUPackageValidator&) = delete;
+    FWUPackageValidator(const PLDMImg& img,
+                        std::vector<FWUComponentRange> componentsVal,
+                        FWUComponentDigests expectedDigestsVal);
+
+    /** @brief Start validating. The validator must be kept till wait()
+     * returns.
+     */
+    void start();
+
+    /** @brief Wait till the package is validated
+     *
+     * @return true if all the components passed
+     */
+    bool wait(const boost::asio::yield_context yield);
+
+    Status getStatus() const
+    {
+        return status;
+    }
+
+    /** @brief Digests computed so far*/
+    const FWUComponentDigests& getDigests() const
+    {
+        return digests;
+    }
+
+  private:
+    /** @brief Validate the components one after another
+     *
+     * @return true if all the components passed
+     */
+    bool validateComponents(const boost::asio::yield_context yield);
+
+    /** @brief Compute the digest of a component
+     *
+     * @return false if the component cannot be read or does not match its
+     * expected digest
+     */
+    bool validateComponent(const boost::asio::yield_context yield,
+                           const FWUComponentRange& component);
+
+    const PLDMImg& pldmImg;
+    std::vector<FWUComponentRange> components;
+    FWUComponentDigests expectedDigests;
+    FWUComponentDigests digests;
+    Status status = Status::pending;
+    /** @brief Cancelled when validation ends to wake the waiters*/
+    boost::asio::steady_timer doneTimer;
+};
+
+} // namespace fwu
+} // namespace pldm
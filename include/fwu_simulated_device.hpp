@@ -0,0 +1,151 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "fwu_utils.hpp"
+
+#include "firmware_update.h"
+
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <set>
+#include <utility>
+
+namespace pldm
+{
+namespace fwu
+{
+
+/** @brief Behaviour of the simulated firmware devices*/
+struct FWUSimulationConfig
+{
+    /** @brief Time the device takes to answer a request or to send one*/
+    std::chrono::milliseconds latency{0};
+    /** @brief Every Nth message to or from the device is lost, 0 for none*/
+    uint32_t errorInterval = 0;
+};
+
+/** @brief Firmware device simulated in process
+ *
+ * Answers the UA commands and downloads each component it is offered with
+ * RequestFirmwareData, followed by TransferComplete, VerifyComplete and
+ * ApplyComplete, the way a device would. Messages are delayed and dropped as
+ * configured. Used for dry runs of the update flow.
+ */
+class FWUSimulatedDevice :
+    public SimulatedTerminus,
+    public std::enable_shared_from_this<FWUSimulatedDevice>
+{
+  public:
+    /** @brief Component classification and identifier*/
+    using ComponentKey = std::pair<uint16_t, uint16_t>;
+
+    FWUSimulatedDevice() = delete;
+    FWUSimulatedDevice(const FWUSimulatedDevice&) = delete;
+    FWUSimulatedDevice& operator=(const FWUSimulatedDevice&) = delete;
+    /** @brief Create a device
+     *
+     * @param tidVal[in] - TID the device is reached at
+     * @param descriptorsVal[in] - Descriptors the device identifies by
+     * @param componentsVal[in] - Components the device accepts
+     * @param configVal[in] - Latency and message loss of the device
+     */
+    FWUSimulatedDevice(const pldm_tid_t tidVal, DescriptorsMap descriptorsVal,
+                       std::set<ComponentKey> componentsVal,
+                       const FWUSimulationConfig& configVal);
+
+    bool handleRequest(boost::asio::yield_context yield,
+                       const uint16_t timeout,
+                       const std::vector<uint8_t>& pldmReq,
+                       std::vector<uint8_t>& pldmResp) override;
+
+    void handleMessage(const uint8_t msgTag, const bool tagOwner,
+                       const std::vector<uint8_t>& payload) override;
+
+    /** @brief Stop the device, downloads in progress are dropped*/
+    void stop();
+
+    /** @brief Firmware update properties, for matching the package*/
+    FDProperties getProperties() const;
+
+    /** @brief Component bytes received so far*/
+    uint64_t getReceivedBytes() const
+    {
+        return receivedBytes;
+    }
+
+    /** @brief true once ActivateFirmware is received*/
+    bool isActivated() const
+    {
+        return activated;
+    }
+
+  private:
+    void setState(const uint8_t nextState);
+
+    /** @brief Count a message, true if it is to be lost*/
+    bool isLost();
+
+    /** @brief true while the download started as generation runs*/
+    bool isCurrent(const uint64_t generation) const;
+
+    void handleUpdateCommand(const uint8_t command, const uint8_t* payload,
+                             const size_t payloadLen,
+                             std::vector<uint8_t>& pldmResp);
+
+    /** @brief Transfer, verify and apply the component being updated*/
+    void runComponentUpdate(boost::asio::yield_context yield,
+                            const uint64_t generation);
+
+    /** @brief Send a request to the UA and wait for its response
+     *
+     * The request is sent again when the response does not arrive in time.
+     *
+     * @param nextState[in] - State the device enters with the response
+     * @return false if there is no response or the download is stopped
+     */
+    bool sendRequest(boost::asio::yield_context yield,
+                     const uint64_t generation, std::vector<uint8_t>& pldmReq,
+                     std::vector<uint8_t>& pldmResp,
+                     const std::optional<uint8_t> nextState = std::nullopt);
+
+    pldm_tid_t tid;
+    DescriptorsMap descriptors;
+    std::set<ComponentKey> components;
+    FWUSimulationConfig config;
+    uint8_t state = FD_IDLE;
+    uint8_t previousState = FD_IDLE;
+    uint32_t transferSize = 0;
+    uint32_t componentSize = 0;
+    /** @brief Bumped when a download is started or dropped*/
+    uint64_t downloadGeneration = 0;
+    uint64_t messageCount = 0;
+    uint64_t receivedBytes = 0;
+    uint8_t instanceId = 0;
+    bool activated = false;
+    bool stopped = false;
+    /** @brief Response to the request in flight, empty till it arrives*/
+    std::vector<uint8_t> pendingResp;
+    uint8_t pendingInstanceId = 0;
+    std::optional<uint8_t> pendingState;
+    bool responsePending = false;
+    boost::asio::steady_timer responseTimer;
+};
+
+} // namespace fwu
+} // namespace pldm
@@ -0,0 +1,128 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "pldm.hpp"
+
+#include <array>
+#include <chrono>
+#include <optional>
+
+namespace pldm
+{
+namespace fwu
+{
+
+/** @brief Phase of a firmware update session*/
+enum class FWUPhase : uint8_t
+{
+    idle,
+    requestUpdate,
+    passComponentTable,
+    download,
+    verify,
+    apply,
+    activate,
+    complete,
+    failed,
+    count
+};
+
+/** @brief Measured progress of a firmware update session
+ *
+ * Tracks the time spent in each phase, the component bytes acknowledged by the
+ * FD and the RequestFirmwareData pattern of the FD. Exposed on D-Bus at
+ * /xyz/openbmc_project/pldm/fwu/<TID> with the interface
+ * xyz.openbmc_project.PLDM.FWU.UpdateStatistics. Counters are published at
+ * most once a second, phase changes immediately.
+ */
+class FWUTelemetry
+{
+  public:
+    FWUTelemetry() = delete;
+    FWUTelemetry(const FWUTelemetry&) = delete;
+    FWUTelemetry& operator=(const FWUTelemetry&) = delete;
+    explicit FWUTelemetry(const pldm_tid_t tidVal);
+    ~FWUTelemetry();
+
+    /** @brief Set the bytes of the components to be transferred*/
+    void setTotalBytes(const uint64_t bytes);
+
+    /** @brief Close the current phase and start the next one*/
+    void startPhase(const FWUPhase phase);
+
+    /** @brief Start transfer of a component*/
+    void startComponent();
+
+    /** @brief Record a RequestFirmwareData served to the FD. Requests below
+     * the highest offset already served are counted as retries.
+     */
+    void recordFirmwareData(const uint32_t offset, const uint32_t length,
+                            const uint32_t componentSize);
+
+    /** @brief Record a RequestFirmwareData not arriving in time*/
+    void recordTimeout();
+
+    /** @brief Measured transfer rate of the session. std::nullopt till
+     * enough data is transferred to tell.
+     */
+    std::optional<double> getBytesPerSecond() const;
+
+    /** @brief Bytes left to transfer*/
+    uint64_t getRemainingBytes() const;
+
+    /** @brief Transfer rate measured by the last session of a terminus
+     *
+     * @param tid[in] - TID of the FD
+     *
+     * @return Bytes per second. std::nullopt if not measured.
+     */
+    static std::optional<double> getObservedThroughput(const pldm_tid_t tid);
+
+    /** @brief Drop the transfer rate measured for a terminus, e.g. once a
+     * simulated FD is gone and its TID may be given to a real one
+     */
+    static void forgetObservedThroughput(const pldm_tid_t tid);
+
+  private:
+    /** @brief Time spent in download including the ongoing one*/
+    std::chrono::steady_clock::duration getDownloadTime() const;
+
+    /** @brief Update the D-Bus properties
+     *
+     * @param force[in] - Publish even if published less than a second ago
+     */
+    void publish(const bool force);
+
+    pldm_tid_t tid;
+    FWUPhase phase = FWUPhase::idle;
+    std::chrono::steady_clock::time_point phaseStart;
+    std::array<std::chrono::steady_clock::duration,
+               static_cast<size_t>(FWUPhase::count)>
+        phaseDurations{};
+    uint64_t totalBytes = 0;
+    uint64_t transferredBytes = 0;
+    /** @brief Highest offset served in the current component*/
+    uint32_t componentHighWater = 0;
+    uint64_t requestCount = 0;
+    uint64_t retryCount = 0;
+    uint64_t timeoutCount = 0;
+    std::chrono::steady_clock::time_point lastPublished;
+    std::unique_ptr<sdbusplus::asio::dbus_interface> statsInterface;
+};
+
+} // namespace fwu
+} // namespace pldm
@@ -17,6 +17,7 @@
 
 #include "pldm.hpp"
 
+#include <bitset>
 #include <vector>
 
 #include "utils.h"
@@ -32,12 +33,15 @@ using FWUVariantType =
                  bitfield32_t, std::string, std::vector<uint8_t>>;
 using FWUProperties = std::map<std::string, FWUVariantType>;
 
-using DevIDRecordsMap =
-    std::map<uint8_t, std::pair<FWUProperties, DescriptorsMap>>;
 using CompPropertiesMap = std::map<uint16_t, FWUProperties>;
 using FDProperties =
     std::tuple<FWUProperties, DescriptorsMap, CompPropertiesMap>;
 
+// Components a package can hold, bounded to keep the bitmaps fixed size
+constexpr size_t maxPkgComponents = 256;
+/** @brief Bitmap of the components applicable to a firmware device*/
+using ApplicableComponents = std::bitset<maxPkgComponents>;
+
 enum class DescriptorIdentifierType : uint16_t
 {
     pciVendorID = 0,
@@ -57,6 +57,8 @@ struct NumericSensor
         nullptr;
     std::shared_ptr<sdbusplus::asio::dbus_interface> operationalInterface =
         nullptr;
+    std::shared_ptr<sdbusplus::asio::dbus_interface> timestampInterface =
+        nullptr;
     double value = std::numeric_limits<double>::quiet_NaN();
     double rawValue = std::numeric_limits<double>::quiet_NaN();
 
@@ -71,6 +73,9 @@ struct NumericSensor
     size_t errCount = 0;
     SensorUnit unit;
 
+    /** @brief Time of the last successful sensor read*/
+    std::chrono::steady_clock::time_point lastUpdated{};
+
     /** @brief Update the sensor functionality*/
     void markFunctional(bool isFunctional);
 
@@ -45,8 +45,13 @@ class NumericSensorHandler
     /** @brief Init NumericSensorHandler*/
     bool sensorHandlerInit(boost::asio::yield_context yield);
 
-    /** @brief Read sensor value and update interfaces*/
-    bool populateSensorValue(boost::asio::yield_context yield);
+    /** @brief Read sensor value and update interfaces
+     *
+     * @param priority[in] - Priority of the read on a rate limited bus
+     */
+    bool populateSensorValue(
+        boost::asio::yield_context yield,
+        const MessagePriority priority = MessagePriority::normal);
 
     /**@brief Check sensor is disabled or not*/
     bool isSensorDisabled()
@@ -57,6 +62,15 @@ class NumericSensorHandler
     /** @brief Check if sensor error threshold crossed*/
     bool sensorErrorCheck();
 
+    /** @brief Clear read failures so that the sensor is polled again*/
+    void resetErrorCount();
+
+    /** @brief Time of the last successful sensor read*/
+    std::chrono::steady_clock::time_point getLastUpdated() const;
+
+    /** @brief Last published sensor value*/
+    double getValue() const;
+
   private:
     /** @brief  Enable sensor*/
     bool setNumericSensorEnable(boost::asio::yield_context yield);
@@ -69,7 +83,8 @@ class NumericSensorHandler
     bool initSensor();
 
     /** @brief fetch the sensor value*/
-    bool getSensorReading(boost::asio::yield_context yield);
+    bool getSensorReading(boost::asio::yield_context yield,
+                          const MessagePriority priority);
 
     /** @brief Decode sensor value and D-Bus interfaces*/
     bool handleSensorReading(uint8_t sensorOperationalState,
@@ -0,0 +1,95 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "pldm.hpp"
+
+#include <boost/asio/spawn.hpp>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "pdr.h"
+
+namespace pldm
+{
+namespace platform
+{
+
+/** @brief Format of the PDR export
+ *
+ * binary - Container loadable back with loadPDRExport. A header holding the
+ * magic "PDRX", version, TID and record count followed by the records, each
+ * prefixed with its length. Multibyte fields are little endian.
+ * json - Common header and identifying fields of the records decoded, along
+ * with the raw record as hex string.
+ */
+enum class PDRExportFormat
+{
+    binary,
+    json
+};
+
+/** @brief Convert the format name used on D-Bus to PDRExportFormat*/
+std::optional<PDRExportFormat> toPDRExportFormat(const std::string& format);
+
+/** @brief Stream the PDRs in repo to a file descriptor
+ *
+ * Records are serialized and written in bounded chunks and the coroutine
+ * yields after every chunk, thus large repos do not stall the io_context.
+ * Regular files can not be polled, chunks to those are written from a
+ * worker thread.
+ *
+ * @param yield[in] - Context object that represents the currently executing
+ * coroutine
+ * @param tid[in] - TID of the terminus owning the repo
+ * @param repo[in] - PDR repo. Kept alive till the export completes.
+ * @param fd[in] - Destination. Ownership is taken and the fd is closed on
+ * return.
+ * @param format[in] - Export format
+ *
+ * @return true on success
+ */
+bool exportPDRs(boost::asio::yield_context yield, const pldm_tid_t tid,
+                const std::shared_ptr<pldm_pdr>& repo, const int fd,
+                const PDRExportFormat format);
+
+/** @brief Load the records of a binary PDR export, e.g. to use it as a PDR
+ * cache or as simulator input
+ *
+ * @param fileName[in] - Binary PDR export
+ *
+ * @return Records mapped by record handle. std::nullopt if the export is
+ * invalid.
+ */
+std::optional<std::unordered_map<uint32_t, std::vector<uint8_t>>>
+    loadPDRExport(const std::string& fileName);
+
+/** @brief Check that loaded export records match the PDR repo
+ *
+ * @param repo[in] - PDR repo
+ * @param records[in] - Records returned by loadPDRExport
+ *
+ * @return true if the repo holds the same records, byte for byte
+ */
+bool matchesPDRRepo(
+    const std::shared_ptr<pldm_pdr>& repo,
+    const std::unordered_map<uint32_t, std::vector<uint8_t>>& records);
+
+} // namespace platform
+} // namespace pldm
@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include "entity_association_tree.hpp"
+#include "pdr_export.hpp"
 #include "pldm.hpp"
 
 #include <boost/asio.hpp>
@@ -26,49 +28,23 @@ namespace pldm
 namespace platform
 {
 
-using ContainerID = uint16_t;
 using RecordHandle = uint32_t;
 using DataTransferHandle = uint32_t;
-using PDRDestroyer = std::function<void(pldm_pdr*)>;
-using PDRRepo = std::unique_ptr<pldm_pdr, PDRDestroyer>;
-using EntityAssociationPath = std::vector<pldm_entity>;
+// Shared so that an ongoing PDR export keeps the repo alive
+using PDRRepo = std::shared_ptr<pldm_pdr>;
 using SensorID = uint16_t;
 using EffecterID = uint16_t;
 using FRURecordSetIdentifier = uint16_t;
 
-struct EntityComparator
+/** @brief Non-owning view of a PDR stored in the BMC PDR repo*/
+struct PDRView
 {
-    bool operator()(const pldm_entity& lhsEntity,
-                    const pldm_entity& rhsEntity) const
-    {
-        return std::tie(lhsEntity.entity_type, lhsEntity.entity_instance_num,
-                        lhsEntity.entity_container_id) ==
-               std::tie(rhsEntity.entity_type, rhsEntity.entity_instance_num,
-                        rhsEntity.entity_container_id);
-    }
+    const uint8_t* data;
+    size_t size;
 };
 
-struct EntityHash
-{
-    std::size_t operator()(const pldm_entity& key) const
-    {
-        std::hash<uint16_t> hash_function;
-        std::size_t returnValue = hash_function(key.entity_type) +
-                                  hash_function(key.entity_instance_num) +
-                                  hash_function(key.entity_container_id);
-
-        return returnValue;
-    }
-};
-
-struct EntityNode
-{
-    using NodePtr = std::shared_ptr<EntityNode>;
-    using ContainedEntities = std::vector<NodePtr>;
-
-    pldm_entity containerEntity;
-    ContainedEntities containedEntities;
-};
+/** @brief PDRs of each type in repo order*/
+using PDRTypeIndex = std::unordered_map<uint8_t, std::vector<PDRView>>;
 
 struct PossibleStates
 {
@@ -103,7 +79,7 @@ class PDRManager
     bool pdrManagerInit(boost::asio::yield_context yield);
 
     /** @brief Get Sensors list*/
-    const std::unordered_map<SensorID, std::string>& getSensors()
+    const FlatMap<SensorID, std::string>& getSensors()
     {
         return _sensorAuxNames;
     };
@@ -117,7 +93,7 @@ class PDRManager
         getStateSensorPDR(const SensorID& sensorID);
 
     /** @brief Get Effecter list*/
-    std::unordered_map<EffecterID, std::string> getEffecters()
+    const FlatMap<EffecterID, std::string>& getEffecters()
     {
         return _effecterAuxNames;
     };
@@ -154,26 +130,21 @@ class PDRManager
     bool constructPDRRepo(boost::asio::yield_context yield);
 
     /** @brief Parse the Auxiliary Names PDR */
-    void parseEntityAuxNamesPDR(std::vector<uint8_t>& pdrData);
+    void parseEntityAuxNamesPDR(const PDRView& pdr);
 
     /**@brief Create Entity Association Tree from PDRs*/
     void createEntityAssociationTree(
-        std::vector<EntityNode::NodePtr>& entityAssociations);
+        std::vector<EntityAssociation>& entityAssociations);
 
     /**@brief Parse Entity Association PDRs*/
-    void parseEntityAssociationPDR(std::vector<uint8_t>& pdrData);
-
-    /** @brief Get all entity association paths from entity association tree
-     * through recursion*/
-    void getEntityAssociationPaths(EntityNode::NodePtr& node,
-                                   EntityAssociationPath path);
+    void parseEntityAssociationPDR(const PDRView& pdr);
 
     /** @brief Populate all the PLDM entities on D-Bus to represent system
      * hierarchy*/
     void populateSystemHierarchy();
 
     /** @brief Extract device auxiliary name from Entity Association PDR*/
-    void extractDeviceAuxName(EntityNode::NodePtr& rootNode);
+    void extractDeviceAuxName();
 
 #ifdef EXPOSE_CHASSIS
     /** @brief Create inventory interface representing the device on D-Bus*/
@@ -181,10 +152,10 @@ class PDRManager
 #endif
 
     /** @brief Parse Sensor Auxiliary Names PDR */
-    void parseSensorAuxNamesPDR(std::vector<uint8_t>& pdrData);
+    void parseSensorAuxNamesPDR(const PDRView& pdr);
 
     /** @brief Parse Effecter Auxiliary Names PDR */
-    void parseEffecterAuxNamesPDR(std::vector<uint8_t>& pdrData);
+    void parseEffecterAuxNamesPDR(const PDRView& pdr);
 
     /** @brief get Entity D-Bus Object path */
     std::optional<DBusObjectPath>
@@ -199,10 +170,10 @@ class PDRManager
                                                       const bool8_t auxNamePDR);
 
     /** @brief Parse Numeric Sensor PDR */
-    void parseNumericSensorPDR(std::vector<uint8_t>& pdrData);
+    void parseNumericSensorPDR(const PDRView& pdr);
 
     /** @brief Parse State Sensor PDR */
-    void parseStateSensorPDR(std::vector<uint8_t>& pdrData);
+    void parseStateSensorPDR(const PDRView& pdr);
 
     /** @brief get Effecter Auxiliary name*/
     std::optional<std::string>
@@ -215,17 +186,22 @@ class PDRManager
                               const bool8_t auxNamePDR);
 
     /** @brief Parse Numeric Effecter PDR */
-    void parseNumericEffecterPDR(std::vector<uint8_t>& pdrData);
+    void parseNumericEffecterPDR(const PDRView& pdr);
 
     /** @brief Parse State Effecter PDR */
-    void parseStateEffecterPDR(std::vector<uint8_t>& pdrData);
+    void parseStateEffecterPDR(const PDRView& pdr);
 
     /** @brief Parse FRU Record Set PDR */
-    void parseFRURecordSetPDR(std::vector<uint8_t>& pdrData);
+    void parseFRURecordSetPDR(const PDRView& pdr);
+
+    /** @brief Index the PDRs in the repo by type in a single pass*/
+    PDRTypeIndex indexPDRs();
 
-    /**@brief General parser to each PDR type*/
-    template <pldm_pdr_types pdrType>
-    void parsePDR();
+    /** @brief Dispatch a PDR to the parser of its type*/
+    void parsePDR(const uint8_t pdrType, const PDRView& pdr);
+
+    /** @brief Parse all the PDRs of a type*/
+    void parsePDRs(const PDRTypeIndex& pdrIndex, const pldm_pdr_types pdrType);
 
     /** @brief Create sensor name with sensor ID*/
     std::string createSensorName(const SensorID sensorID);
@@ -236,6 +212,9 @@ class PDRManager
     /** @brief Initialize interface to dump PDR repo*/
     void initializePDRDumpIntf();
 
+    /** @brief Stream the PDR repo to fd in the background*/
+    void spawnPDRExport(const int fd, const PDRExportFormat format);
+
     /** @brief PDR Repository Info of this terminus*/
     pldm_pdr_repository_info pdrRepoInfo;
 
@@ -243,21 +222,15 @@ class PDRManager
     PDRRepo _pdrRepo;
 
     /** @brief Holds Entity Auxiliary Names*/
-    std::unordered_map<pldm_entity, std::string, EntityHash, EntityComparator>
-        _entityAuxNames;
+    EntityMap<std::string> _entityAuxNames;
 
     /** @brief Container ID of the parent entity represented by TID*/
     ContainerID _containerID;
 
     /** @brief Entity Association tree representing system hierarchy*/
-    EntityNode::NodePtr _entityAssociationTree;
-
-    /** @brief Temporary storage for Entity Association paths*/
-    std::vector<EntityAssociationPath> _entityObjectPaths;
+    EntityAssociationTree _entityAssociationTree;
 
-    std::unordered_map<pldm_entity, std::pair<DBusInterfacePtr, DBusObjectPath>,
-                       EntityHash, EntityComparator>
-        _systemHierarchyIntf;
+    EntityMap<std::pair<DBusInterfacePtr, DBusObjectPath>> _systemHierarchyIntf;
 
     /** @brief Holds Device Auxiliary Name*/
     std::string _deviceAuxName;
@@ -265,26 +238,26 @@ class PDRManager
     /** @brief Holds Sensor Auxiliary Names.
      * Note:- SensorID is considered as unique within a terminus
      */
-    std::unordered_map<SensorID, std::string> _sensorAuxNames;
+    FlatMap<SensorID, std::string> _sensorAuxNames;
 
     /** @brief Holds Effecter Auxiliary Names.
      * Note:- EffecterID is considered as unique within a terminus
      */
-    std::unordered_map<EffecterID, std::string> _effecterAuxNames;
+    FlatMap<EffecterID, std::string> _effecterAuxNames;
 
     /** @brief Holds Numeric Sensor PDR */
-    std::map<SensorID, std::shared_ptr<pldm_numeric_sensor_value_pdr>>
+    FlatMap<SensorID, std::shared_ptr<pldm_numeric_sensor_value_pdr>>
         _numericSensorPDR;
 
     /** @brief Holds Numeric Sensor D-Bus interfaces and Object paths */
-    std::map<SensorID, std::pair<DBusInterfacePtr, DBusObjectPath>> _sensorIntf;
+    FlatMap<SensorID, std::pair<DBusInterfacePtr, DBusObjectPath>> _sensorIntf;
 
     /** @brief Holds Effecter D-Bus interfaces and Object paths */
-    std::map<EffecterID, std::pair<DBusInterfacePtr, DBusObjectPath>>
+    FlatMap<EffecterID, std::pair<DBusInterfacePtr, DBusObjectPath>>
         _effecterIntf;
 
     /** @brief Holds Numeric Effecter PDR */
-    std::map<EffecterID, std::shared_ptr<pldm_numeric_effecter_value_pdr>>
+    FlatMap<EffecterID, std::shared_ptr<pldm_numeric_effecter_value_pdr>>
         _numericEffecterPDR;
 
     /** @brief Holds FRU Record Set D-Bus interfaces and Object paths */
@@ -293,8 +266,7 @@ class PDRManager
         _fruRecordSetIntf;
 
     /** @brief Holds State Sensor PDR */
-    std::unordered_map<SensorID, std::shared_ptr<StateSensorPDR>>
-        _stateSensorPDR;
+    FlatMap<SensorID, std::shared_ptr<StateSensorPDR>> _stateSensorPDR;
 
 #ifdef EXPOSE_CHASSIS
     /** @brief D-Bus interfaces to inventory */
@@ -305,16 +277,15 @@ class PDRManager
     DBusInterfacePtr pdrDumpInterface;
 
     /** @brief Holds State Effecter PDR */
-    std::unordered_map<EffecterID, std::shared_ptr<StateEffecterPDR>>
-        _stateEffecterPDR;
+    FlatMap<EffecterID, std::shared_ptr<StateEffecterPDR>> _stateEffecterPDR;
 
     /** @brief Terminus ID*/
     pldm_tid_t _tid;
 
-    /** @brief Temporarily holds entity association nodes, used to create entity
+    /** @brief Temporarily holds entity associations, used to create entity
      * association tree
      */
-    std::vector<EntityNode::NodePtr> entityAssociationNodes;
+    std::vector<EntityAssociation> entityAssociations;
 };
 
 } // namespace platform
@@ -17,8 +17,11 @@
 
 #include "platform_terminus.hpp"
 #include "pldm.hpp"
+#include "poll_profiler.hpp"
 
 #include <boost/asio/steady_timer.hpp>
+#include <chrono>
+#include <variant>
 
 #include "platform.h"
 
@@ -30,8 +33,18 @@ namespace platform
 constexpr uint16_t commandTimeout = 100;
 constexpr size_t commandRetryCount = 3;
 
+// Sensor reads are paced by the transport rate limiter. Minimum poll cycle
+// avoids back to back sweeps of termini with only a few sensors.
+constexpr std::chrono::milliseconds minPollCycle{500};
+
 using UUID = std::array<uint8_t, 16>;
 
+/** @brief Numeric sensor value or states of a state sensor*/
+using SensorReading = std::variant<double, std::vector<uint8_t>>;
+
+/** @brief Sensor reading and its timestamp in microseconds since epoch*/
+using TimestampedReading = std::tuple<SensorReading, uint64_t>;
+
 std::optional<UUID>
     getTerminusUID(boost::asio::yield_context yield, const pldm_tid_t tid,
                    std::optional<mctpw_eid_t> eid = std::nullopt);
@@ -44,8 +57,30 @@ class Platform
     bool initTerminus(boost::asio::yield_context yield, const pldm_tid_t tid,
                       const pldm::base::CommandSupportTable& commandTable);
     bool deleteTerminus(const pldm_tid_t tid);
+    void resumeTerminus(const pldm_tid_t tid);
+    std::optional<TimestampedReading>
+        refreshSensor(boost::asio::yield_context yield, const pldm_tid_t tid,
+                      const SensorID sensorID,
+                      const std::chrono::milliseconds maxAge);
 
   private:
+    /** @brief Read a sensor unless a read of it is in flight, in which case
+     * wait for that read
+     *
+     * @return Result of the read. std::nullopt if the read in flight is
+     * waited for instead.
+     */
+    template <typename SensorHandler>
+    std::optional<bool> readSensor(boost::asio::yield_context yield,
+                                   const pldm_tid_t tid,
+                                   const SensorID sensorID,
+                                   SensorHandler& sensorHandler,
+                                   const MessagePriority priority);
+    template <typename SensorHandler>
+    void refreshSensorReading(boost::asio::yield_context yield,
+                              const pldm_tid_t tid, const SensorID sensorID,
+                              SensorHandler& sensorHandler,
+                              const std::chrono::milliseconds maxAge);
     bool induceAsyncDelay(boost::asio::yield_context yield, int delay);
     void doPoll(boost::asio::yield_context yield);
     void pollAllSensors();
@@ -60,6 +95,13 @@ class Platform
     bool startSensorPoll = false;
     bool stopSensorPoll = false;
     std::set<pldm_tid_t> tidsUnderInitialization{};
+    PollProfiler pollProfiler{minPollCycle};
+    // Sensor reads in flight, by the poller or by Refresh. Timer is cancelled
+    // once the read completes to wake up the callers waiting for the same
+    // sensor.
+    std::map<std::pair<pldm_tid_t, SensorID>,
+             std::shared_ptr<boost::asio::steady_timer>>
+        readsInFlight{};
 };
 
 /** @brief Pause sensor polling
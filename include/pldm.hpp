@@ -17,6 +17,7 @@
 
 #include "base.hpp"
 #include "mctp_wrapper.hpp"
+#include "rate_limiter.hpp"
 
 #include <boost/asio.hpp>
 #include <boost/asio/error.hpp>
@@ -136,6 +137,24 @@ bool reserveBandwidth(const boost::asio::yield_context yield,
  */
 bool releaseBandwidth(const boost::asio::yield_context yield,
                       const pldm_tid_t tid, const uint8_t pldmType);
+
+/** @brief Check whether the bandwidth is reserved for other traffic
+ *
+ * @param tid - TID of the PLDM device
+ * @param pldmType - pldm type.
+ *
+ * @return true if messages of pldmType to tid are blocked by a reservation
+ */
+bool isBandwidthReserved(const pldm_tid_t tid, const uint8_t pldmType);
+
+/** @brief Get the contention domain a terminus is reached through. Bandwidth
+ * is reserved per contention domain.
+ *
+ * @param tid - TID of the PLDM device
+ *
+ * @return Contention domain. std::nullopt if TID is not mapped.
+ */
+std::optional<ContentionDomain> getContentionDomain(const pldm_tid_t tid);
 // TODO: Add an API to free the Instance ID after usage.
 
 /** @brief Get device location string for tid
@@ -173,14 +192,16 @@ std::optional<uint8_t> getInstanceId(std::vector<uint8_t>& message);
  * @param pldmResp - PLDM response message(Pass empty vector to capture
  * response)
  * @param eid - EID of the MCTP device
+ * @param priority - Priority of the request on a rate limited bus
  *
  * @return Status of the operation
  */
-bool sendReceivePldmMessage(boost::asio::yield_context yield,
-                            const pldm_tid_t tid, const uint16_t timeout,
-                            size_t retryCount, std::vector<uint8_t> pldmReq,
-                            std::vector<uint8_t>& pldmResp,
-                            std::optional<mctpw_eid_t> eid = std::nullopt);
+bool sendReceivePldmMessage(
+    boost::asio::yield_context yield, const pldm_tid_t tid,
+    const uint16_t timeout, size_t retryCount, std::vector<uint8_t> pldmReq,
+    std::vector<uint8_t>& pldmResp,
+    std::optional<mctpw_eid_t> eid = std::nullopt,
+    const MessagePriority priority = MessagePriority::normal);
 
 /** @brief Validate PLDM message encode
  *
@@ -229,6 +250,57 @@ bool sendPldmMessage(boost::asio::yield_context yield, const pldm_tid_t tid,
                      uint8_t retryCount, const uint8_t msgTag,
                      const bool tagOwner, std::vector<uint8_t> payload);
 
+/** @brief PLDM terminus simulated within pldmd
+ *
+ * Messages to the TID of a simulated terminus are handed to it instead of
+ * being sent over MCTP. Used to run flows such as firmware update without the
+ * device.
+ */
+class SimulatedTerminus
+{
+  public:
+    virtual ~SimulatedTerminus() = default;
+
+    /** @brief Handle a request sent to the terminus
+     *
+     * @param yield - Context object that represents the currently executing
+     * coroutine
+     * @param timeout - Maximum time period within the response is expected
+     * @param pldmReq - PLDM request message
+     * @param pldmResp - PLDM response message
+     *
+     * @return false if there is no response within timeout
+     */
+    virtual bool handleRequest(boost::asio::yield_context yield,
+                               const uint16_t timeout,
+                               const std::vector<uint8_t>& pldmReq,
+                               std::vector<uint8_t>& pldmResp) = 0;
+
+    /** @brief Handle a message sent without waiting for a response, e.g. the
+     * response to a request of the terminus
+     *
+     * @param msgTag - MCTP message tag
+     * @param tagOwner - MCTP tag owner bit
+     * @param payload - PLDM message payload
+     */
+    virtual void handleMessage(const uint8_t msgTag, const bool tagOwner,
+                               const std::vector<uint8_t>& payload) = 0;
+};
+
+/** @brief Route the messages to a TID to a simulated terminus
+ *
+ * @param tid - TID of the simulated terminus, not mapped to an EID
+ * @param terminus - Simulated terminus
+ */
+void addSimulatedTerminus(const pldm_tid_t tid,
+                          std::shared_ptr<SimulatedTerminus> terminus);
+
+/** @brief Stop routing the messages to a TID to its simulated terminus
+ *
+ * @param tid - TID of the simulated terminus
+ */
+void removeSimulatedTerminus(const pldm_tid_t tid);
+
 namespace platform
 {
 
@@ -258,6 +330,14 @@ bool platformInit(boost::asio::yield_context yield, const pldm_tid_t tid,
 
 bool deleteMnCTerminus(const pldm_tid_t tid);
 
+/** @brief Resume monitoring of a recovered terminus
+ *
+ * Sensors which stopped polling due to read failures are polled again.
+ *
+ * @param tid - TID of the PLDM terminus
+ */
+void resumeTerminusMonitoring(const pldm_tid_t tid);
+
 } // namespace platform
 
 namespace fru
@@ -17,7 +17,7 @@
 
 #include "firmware_update.hpp"
 
-#include <fstream>
+#include <string_view>
 
 namespace pldm
 {
@@ -62,98 +62,147 @@ struct CompImgInfo
     uint8_t compVerStrLen;
 } __attribute__((packed));
 
+/** @brief Package header information*/
+struct PkgHeader
+{
+    uint8_t formatRevision;
+    uint16_t compBitmapBitLength;
+    uint8_t versionStringType;
+    std::string_view versionString;
+};
+
+/** @brief Firmware device ID record of the package*/
+struct PkgDeviceIDRecord
+{
+    uint32_t deviceUpdateOptionFlags;
+    uint8_t compImgSetVerStrType;
+    std::string_view compImgSetVerStr;
+    ApplicableComponents applicableComponents;
+    DescriptorsMap descriptors;
+    /** @brief FirmwareDevicePackageData, length 0 if there is none*/
+    variable_field fwDevPkgData;
+};
+
+/** @brief Component image information of the package*/
+struct PkgComponent
+{
+    uint16_t classification;
+    uint16_t identifier;
+    uint32_t comparisonStamp;
+    uint16_t options;
+    uint16_t requestedActivationMethod;
+    uint32_t locationOffset;
+    uint32_t size;
+    uint8_t versionStringType;
+    std::string_view versionString;
+};
+
+struct PkgHdrCursor;
+
+/** @brief PLDM firmware update package
+ *
+ * The package header is parsed once into typed records. Strings and package
+ * data of the records point into a copy of the header, thus are valid as long
+ * as this object is.
+ */
 class PLDMImg
 {
   public:
     PLDMImg() = delete;
+    PLDMImg(const PLDMImg&) = delete;
+    PLDMImg& operator=(const PLDMImg&) = delete;
+    /** @brief Map the package read-only. Throws std::system_error if the
+     * package cannot be opened or mapped.
+     *
+     * Pages of the mapping past the end of the file fault with SIGBUS, thus
+     * the package must be a copy staged by the daemon that nothing else
+     * truncates. Its size is read once here.
+     */
     explicit PLDMImg(const std::string& pldmImgPath);
-    /** @brief API that process PLDM firmware update package header
+    ~PLDMImg();
+    /** @brief API that process PLDM firmware update package header and matches
+     * its device ID records with the discovered termini
      */
     bool processPkgHdr();
+
+    /** @brief API that parses PLDM firmware update package header without
+     * matching the termini
+     */
+    bool parsePkgHdr();
+
+    /** @brief API that matches the device ID records with the termini given
+     *
+     * @param termini[in] - Termini and their firmware update properties
+     * @return false if no terminus matched
+     */
+    bool matchTermini(const std::map<pldm_tid_t, FDProperties>& termini);
     constexpr uint16_t getHeaderLen() const
     {
         return pkgHdrLen;
     }
-    constexpr uint16_t getDevIDRecordCount() const
+    uint8_t getDevIDRecordCount() const
     {
-        return deviceIDRecordCount;
+        return static_cast<uint8_t>(devIDRecords.size());
     }
-    constexpr uint16_t getTotalCompCount() const
+    uint16_t getTotalCompCount() const
     {
-        return totalCompCount;
+        return static_cast<uint16_t>(components.size());
     }
 
-    /** @brief API that gets PLDM firmware update package header property
-     */
-    template <typename T>
-    bool getPkgProperty(T& value, const std::string& name)
+    constexpr const PkgHeader& getPkgHeader() const
     {
-        auto it = pkgFWUProperties.find(name);
-        if (it != pkgFWUProperties.end())
-        {
-            if (auto itr = std::get_if<T>(&it->second))
-            {
-                value = *itr;
-                return true;
-            }
-        }
-        return false;
+        return pkgHeader;
     }
 
-    /** @brief API that gets PLDM firmware update component property
+    /** @brief API that gets a firmware device ID record of the package
+     *
+     * @return nullptr if there is no such record
      */
-    template <typename T>
-    bool getCompProperty(T& value, const std::string& name, uint16_t compCount)
+    const PkgDeviceIDRecord* getDeviceIDRecord(const uint8_t index) const
     {
-        auto itr = pkgCompProperties.find(compCount);
-        if (itr == pkgCompProperties.end())
-        {
-            return false;
-        }
-        auto& compProps = itr->second;
-        auto it = compProps.find(name);
-        if (compProps.end() != it)
-        {
-            if (auto itr2 = std::get_if<T>(&it->second))
-            {
-                value = *itr2;
-                return true;
-            }
-        }
-        return false;
+        return index < devIDRecords.size() ? &devIDRecords[index] : nullptr;
     }
 
-    /** @brief API that gets PLDM firmware update device record property
+    /** @brief API that gets a component of the package
+     *
+     * @return nullptr if there is no such component
      */
-    template <typename T>
-    bool getDevIdRcrdProperty(T& value, const std::string& name,
-                              uint8_t recordCount)
+    const PkgComponent* getComponent(const uint16_t index) const
     {
-        auto itr = pkgDevIDRecords.find(recordCount);
-        if (itr == pkgDevIDRecords.end())
-        {
-            return false;
-        }
-        auto& devRcd = itr->second;
-        auto& dev = devRcd.first;
-        auto it = dev.find(name);
-        if (dev.end() != it)
-        {
-            if (auto itr2 = std::get_if<T>(&it->second))
-            {
-                value = *itr2;
-                return true;
-            }
-        }
-        return false;
+        return index < components.size() ? &components[index] : nullptr;
     }
 
+    /** @brief API that matches package header identifier
+     */
+    static bool matchPkgHdrIdentifier(const uint8_t* packageHeaderIdentifier);
+
+    /** @brief API that verifys package header checksum
+     *
+     * @param hdrData[in] - Package header, hdrLen bytes
+     * @param hdrLen[in] - PackageHeaderSize of the header
+     */
+    static bool verifyPkgHdrChecksum(const uint8_t* hdrData,
+                                     const uint16_t hdrLen);
+
     /** @brief API that is used to read raw bytes from pldm firmware update
      * image
      */
     bool readData(const size_t startAddr, std::vector<uint8_t>& data,
                   const size_t dataLen);
 
+    /** @brief API that gets raw bytes of the pldm firmware update image
+     * without copying. Valid as long as this object is.
+     *
+     * @return pointer into the mapped image, nullptr if the range is out of
+     * the image
+     */
+    const uint8_t* getData(const size_t startAddr, const size_t dataLen) const;
+
+    /** @brief API that hints the kernel to read ahead a range of the image,
+     * e.g. the component about to be transferred
+     */
+    void prefetchData(const size_t startAddr, const size_t dataLen) const;
+
     std::uintmax_t getImagesize()
     {
         return pldmImgSize;
@@ -162,7 +211,7 @@ class PLDMImg
     {
         return static_cast<size_t>(pldmImgSize - pkgHdrLen);
     };
-    std::vector<std::pair<uint8_t, pldm_tid_t>> getMatchedTermini()
+    const std::vector<std::pair<uint8_t, pldm_tid_t>>& getMatchedTermini() const
     {
         return matchedTermini;
     }
@@ -174,88 +223,31 @@ class PLDMImg
     }
 
   private:
-    /** @brief API that gets descriptor identifiers data length
-     */
-    size_t getDescriptorDataLen(const FWDevIdRecord& data,
-                                const size_t applicableComponentsLen);
-
     /** @brief API that gets pldm firmware update package header length
      */
     uint16_t getHdrLen();
 
-    /** @brief API that verifys package header checksum
-     */
-    bool verifyPkgHdrChecksum();
-
-    /** @brief API that validates package header data
-     */
-    bool validateHdrDataLen(const size_t bytesLeft, const size_t nextDataSize)
-    {
-        return !(bytesLeft < nextDataSize);
-    }
-
-    /** @brief API that matches package header identifier
-     */
-    bool matchPkgHdrIdentifier(const uint8_t* packageHeaderIdentifier);
-
-    /** @brief API that advance package header iterator
-     */
-    bool advanceHdrItr(const size_t dataSize, const size_t nextDataSize);
-
     /** @brief API that process a postion PLDM firmware update package header
      */
-    bool processPkgHdrInfo();
+    bool processPkgHdrInfo(PkgHdrCursor& cursor);
 
     /** @brief API that process device identification info in the pldm package
      * header
      */
-    bool processDevIdentificationInfo();
-
-    /** @brief API that finds the matched terminus
-     */
-    bool findMatchedTerminus(const uint8_t devIdRecord,
-                             const DescriptorsMap& pkgDescriptors);
+    bool processDevIdentificationInfo(PkgHdrCursor& cursor);
 
     /** @brief API that process component data from PLDM firmware update package
      * header
      */
-    bool processCompImgInfo();
-
-    /** @brief API that copies package header info to firmware update properties
-     * map.
-     */
-    void copyPkgHdrInfoToMap(const struct PLDMPkgHeaderInfo* headerInfo,
-                             const std::string& pkgVersionString);
-
-    /** @brief API that copies device identification info to firmware update
-     * properties map.
-     */
-    void copyDevIdentificationInfoToMap(
-        const uint8_t deviceIDRecord, const uint16_t initialDescriptorType,
-        const FWDevIdRecord* devIdentificationInfo,
-        const std::vector<uint8_t>& applicableComponents,
-        const std::string& compImgSetVerStr,
-        const std::vector<uint8_t>& fwDevPkgData,
-        DescriptorsMap& pkgDescriptorRecords);
-
-    /** @brief API that copies component data to firmware update properties map.
-     */
-    void copyCompImgInfoToMap(const uint16_t count, const CompImgInfo* compInfo,
-                              const std::string& compVerStr);
+    bool processCompImgInfo(PkgHdrCursor& cursor);
 
-    std::uintmax_t pldmImgSize;
-    std::ifstream pldmImg;
+    std::uintmax_t pldmImgSize = 0;
+    const uint8_t* pldmImg = nullptr;
     uint16_t pkgHdrLen = 0;
-    std::vector<uint8_t> hdrData;
-    std::vector<uint8_t>::iterator hdrItr;
-    uint8_t pkgVersionStringLen = 0;
-    uint16_t compBitmapBitLength = 0;
-    uint16_t fwDevPkgDataLen = 0;
-    uint8_t deviceIDRecordCount = 0;
-    uint16_t totalCompCount = 0;
-    FWUProperties pkgFWUProperties;
-    DevIDRecordsMap pkgDevIDRecords;
-    CompPropertiesMap pkgCompProperties;
+    std::vector<uint8_t> pkgHdrData;
+    PkgHeader pkgHeader = {};
+    std::vector<PkgDeviceIDRecord> devIDRecords;
+    std::vector<PkgComponent> components;
     std::vector<std::pair<uint8_t, pldm_tid_t>> matchedTermini;
     std::string imagePath;
 };
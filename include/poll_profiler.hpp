@@ -0,0 +1,159 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "pdr_manager.hpp"
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace pldm
+{
+namespace platform
+{
+
+/** @brief Reason for not reading a sensor in a poll cycle*/
+enum class SkipReason : uint8_t
+{
+    disabled,
+    errorThreshold,
+    paused,
+    reservation,
+    terminusUnavailable,
+    count
+};
+
+/** @brief Histogram of durations with power of two millisecond buckets
+ *
+ * Bucket 0 counts durations below 1ms and bucket N counts durations in
+ * [2^(N-1), 2^N) ms. The last bucket also holds everything above its range.
+ */
+class DurationHistogram
+{
+  public:
+    void record(const std::chrono::steady_clock::duration duration);
+
+    /** @brief Upper bound of the bucket holding the given percentile
+     *
+     * @param percentile[in] - Percentile in the range 1 to 100
+     *
+     * @return Duration in milliseconds. 0 if there are no samples
+     */
+    uint64_t percentile(const uint8_t percentile) const;
+
+    uint64_t getCount() const
+    {
+        return count;
+    }
+
+    uint64_t getMax() const
+    {
+        return maxMillisec;
+    }
+
+  private:
+    static constexpr size_t bucketCount = 20;
+    std::array<uint64_t, bucketCount> buckets{};
+    uint64_t count = 0;
+    uint64_t maxMillisec = 0;
+};
+
+/** @brief Poll statistics of a sensor*/
+struct SensorPollStats
+{
+    /** @brief Time between successful reads*/
+    DurationHistogram interval;
+    /** @brief Time taken by each read attempt*/
+    DurationHistogram latency;
+    /** @brief Time taken by each read requested on demand, e.g. by Refresh*/
+    DurationHistogram onDemandLatency;
+    /** @brief Interval the poll loop achieved in the last cycle reading the
+     * sensor, never below the minimum poll cycle
+     */
+    std::chrono::milliseconds achievedInterval{0};
+    uint64_t failures = 0;
+    uint64_t onDemandFailures = 0;
+    std::array<uint64_t, static_cast<size_t>(SkipReason::count)> skips{};
+    std::chrono::steady_clock::time_point lastSample{};
+};
+
+/** @brief Always-on profiler of the sensor poll loop
+ *
+ * Records the achieved sampling period, read latency and skip reasons of each
+ * sensor. Recording is a map lookup and a few counter updates, so it is cheap
+ * compared to a sensor read.
+ */
+class PollProfiler
+{
+  public:
+    using SensorKey = std::pair<pldm_tid_t, SensorID>;
+    using SensorProfile =
+        std::tuple<pldm_tid_t, SensorID, std::map<std::string, uint64_t>>;
+
+    PollProfiler(const std::chrono::milliseconds minInterval);
+
+    /** @brief Record a read attempt of a sensor by the poll loop*/
+    void recordRead(const SensorKey& key,
+                    const std::chrono::steady_clock::duration latency,
+                    const bool success);
+
+    /** @brief Record a read attempt of a sensor outside the poll loop
+     *
+     * On-demand reads are counted separately and do not affect the poll
+     * interval statistics.
+     */
+    void recordOnDemandRead(const SensorKey& key,
+                            const std::chrono::steady_clock::duration latency,
+                            const bool success);
+
+    /** @brief Record the duration of a completed poll cycle
+     *
+     * The effective interval of every sensor read in the cycle is the cycle
+     * duration, or the minimum poll cycle if the cycle completed earlier.
+     *
+     * @param polledSensors[in] - Sensors read in the cycle
+     * @param cycleDuration[in] - Time taken by the cycle before any delay
+     */
+    void recordCycle(const std::vector<SensorKey>& polledSensors,
+                     const std::chrono::steady_clock::duration cycleDuration);
+
+    /** @brief Record a sensor skipped in a poll cycle*/
+    void recordSkip(const SensorKey& key, const SkipReason reason);
+
+    /** @brief Log summary of the poll statistics if summary interval elapsed
+     */
+    void logSummary();
+
+    /** @brief Get poll statistics of all the sensors*/
+    std::vector<SensorProfile> getProfile() const;
+
+    /** @brief Clear all the statistics*/
+    void reset();
+
+    /** @brief Remove statistics of the sensors of a terminus*/
+    void removeTerminus(const pldm_tid_t tid);
+
+  private:
+    std::chrono::milliseconds _minInterval;
+    std::map<SensorKey, SensorPollStats> stats;
+    std::chrono::steady_clock::time_point lastSummary;
+};
+
+} // namespace platform
+} // namespace pldm
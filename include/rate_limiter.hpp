@@ -0,0 +1,172 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "mctp_wrapper.hpp"
+
+#include <boost/asio.hpp>
+#include <boost/asio/spawn.hpp>
+#include <array>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace pldm
+{
+
+/** @brief Contention domain of the PLDM transport. Each physical bus is
+ * served by its own MCTP binding service, the endpoints reached through the
+ * same service share the bus bandwidth. Named after the service.
+ */
+using ContentionDomain = std::string;
+
+/** @brief Priority of a PLDM message waiting for the rate limiter*/
+enum class MessagePriority : uint8_t
+{
+    normal,
+    /** @brief Served before the normal messages, e.g. reads a client waits
+     * for
+     */
+    high,
+    count
+};
+
+/** @brief Rate limit configuration of a contention domain*/
+struct RateLimit
+{
+    /** @brief Sustained PLDM message rate*/
+    double msgsPerSec;
+    /** @brief Number of PLDM messages which can be sent back to back*/
+    double burst;
+};
+
+/** @brief Get the default rate limit of a bus type
+ *
+ * @param bindingType[in] - MCTP binding type
+ *
+ * @return Rate limit configuration
+ */
+RateLimit getDefaultRateLimit(const mctpw::BindingType bindingType);
+
+/** @brief Token bucket limiting the PLDM message rate
+ *
+ * Tokens are refilled at msgsPerSec up to burst. A token is consumed per PLDM
+ * message. Callers arriving with an empty bucket are queued per priority and
+ * handed the tokens as they are refilled, high priority first and each
+ * priority in arrival order.
+ */
+class TokenBucket
+{
+  public:
+    TokenBucket() = delete;
+    TokenBucket(const TokenBucket&) = delete;
+    TokenBucket& operator=(const TokenBucket&) = delete;
+    explicit TokenBucket(const RateLimit& rateLimit);
+
+    /** @brief Wait till a token is available and consume it
+     *
+     * @param yield[in] - Context object that represents the currently
+     * executing coroutine
+     * @param priority[in] - Queue to wait in
+     *
+     * @return false if the wait is aborted, no token is consumed then
+     */
+    bool acquire(boost::asio::yield_context yield,
+                 const MessagePriority priority);
+
+    /** @brief Apply a new rate limit, the tokens left are kept up to burst*/
+    void setRateLimit(const RateLimit& rateLimit);
+
+  private:
+    struct Waiter
+    {
+        explicit Waiter(boost::asio::io_context& ioc) :
+            wakeUp(ioc, boost::asio::steady_timer::time_point::max())
+        {
+        }
+        /** @brief Cancelled to wake the waiter up*/
+        boost::asio::steady_timer wakeUp;
+        bool granted = false;
+    };
+
+    /** @brief Add the tokens accumulated since last refill*/
+    void refill();
+
+    /** @brief Hand the tokens available to the waiters, then wait for the
+     * next token if anyone is left waiting
+     */
+    void dispatch();
+
+    bool hasWaiters() const;
+
+    RateLimit _rateLimit;
+    double tokens;
+    std::chrono::steady_clock::time_point lastRefill;
+    std::array<std::deque<std::shared_ptr<Waiter>>,
+               static_cast<size_t>(MessagePriority::count)>
+        waiters;
+    boost::asio::steady_timer dispatchTimer;
+    bool dispatchScheduled = false;
+};
+
+/** @brief Token bucket rate limiter per contention domain*/
+class RateLimiter
+{
+  public:
+    /** @brief true if the rate limit can be applied*/
+    static bool isValid(const RateLimit& rateLimit);
+
+    /** @brief Set the rate limit of the domains not configured otherwise
+     *
+     * @return false if the rate limit is invalid
+     */
+    bool setDefaultLimit(const RateLimit& rateLimit);
+
+    /** @brief Replace the rate limits configured per contention domain. The
+     * domains left out fall back to the default limit.
+     *
+     * @return false if any of the rate limits is invalid, nothing is changed
+     * then
+     */
+    bool setDomainLimits(const std::map<ContentionDomain, RateLimit>& limits);
+
+    /** @brief Wait for the contention domain to allow one more PLDM message
+     *
+     * @param yield[in] - Context object that represents the currently
+     * executing coroutine
+     * @param domain[in] - Contention domain of the destination
+     * @param priority[in] - Priority of the message
+     *
+     * @return false if the wait is aborted
+     */
+    bool acquire(boost::asio::yield_context yield,
+                 const ContentionDomain& domain,
+                 const MessagePriority priority = MessagePriority::normal);
+
+  private:
+    RateLimit getLimit(const ContentionDomain& domain) const;
+
+    RateLimit defaultLimit{20, 5};
+    std::map<ContentionDomain, RateLimit> domainLimits;
+    /** @brief Buckets are created on first use and never removed, waiters
+     * hold references to them
+     */
+    std::map<ContentionDomain, TokenBucket> buckets;
+};
+
+} // namespace pldm
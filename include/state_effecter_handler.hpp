@@ -59,15 +59,17 @@ class StateEffecterHandler
     /** @brief Increment the error count in case of failure*/
     void incrementError();
 
-    /** @brief Update effecter state*/
-    void updateState(const uint8_t currentState, const uint8_t pendingState);
+    /** @brief Update states of all the composite effecter instances*/
+    void updateState(const std::vector<uint8_t>& currentStates,
+                     const std::vector<uint8_t>& pendingStates);
 
     /** @brief  Enable effecter*/
     bool enableStateEffecter(boost::asio::yield_context yield);
 
-    /** @brief Handle effecter reading*/
+    /** @brief Handle readings of all the composite effecter instances*/
     bool handleStateEffecterState(boost::asio::yield_context yield,
-                                  get_effecter_state_field& stateReading);
+                                  const get_effecter_state_field* stateReadings,
+                                  const uint8_t effecterCount);
 
     /** @brief fetch the effecter value*/
     bool getStateEffecterStates(boost::asio::yield_context yield);
@@ -75,15 +77,28 @@ class StateEffecterHandler
     /** @brief Read effecter value and update interfaces*/
     bool populateEffecterValue(boost::asio::yield_context yield);
 
-    /** @brief Validate the effecter value is supported*/
-    bool isEffecterStateSettable(const uint8_t state);
+    /** @brief Validate the effecter value is supported by the composite
+     * effecter instance*/
+    bool isEffecterStateSettable(const size_t effecterOffset,
+                                 const uint8_t state);
 
-    /** @brief Set effecter value*/
-    bool setEffecter(boost::asio::yield_context yield, const uint8_t value);
+    /** @brief Set states of the composite effecter instances in one
+     * transaction*/
+    bool setEffecter(boost::asio::yield_context yield,
+                     const std::vector<set_effecter_state_field>& stateFields);
+
+    /** @brief Read back the effecter states after transition interval*/
+    void refreshEffecterInterfaces();
 
     /** @brief Register D-Bus interfaces for SetEffecterValue*/
     void registerSetEffecter();
 
+    /** @brief Check if the effecter is a composite effecter*/
+    bool isCompositeEffecter() const
+    {
+        return compositeEffecterCount > 1;
+    }
+
     /** @brief Terminus ID*/
     pldm_tid_t _tid;
 
@@ -96,14 +111,17 @@ class StateEffecterHandler
     /** @brief Effecter PDR*/
     std::shared_ptr<StateEffecterPDR> _pdr;
 
+    /** @brief Number of effecter instances in the composite effecter*/
+    uint8_t compositeEffecterCount;
+
     /** @brief Error counter*/
     size_t errCount = 0;
 
     /** @brief Cache readings for later use*/
     bool isAvailableReading = false;
     bool isFuntionalReading = false;
-    uint8_t pendingStateReading = std::numeric_limits<uint8_t>::max();
-    uint8_t currentStateReading = std::numeric_limits<uint8_t>::max();
+    std::vector<uint8_t> pendingStateReadings;
+    std::vector<uint8_t> currentStateReadings;
 
     /** @brief Flags which indicate interfaces are ready*/
     bool effecterIntfReady = false;
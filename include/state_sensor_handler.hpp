@@ -18,6 +18,7 @@
 #include "pdr_manager.hpp"
 
 #include <boost/asio.hpp>
+#include <chrono>
 
 #include "platform.h"
 
@@ -43,8 +44,13 @@ class StateSensorHandler
     /** @brief Init StateSensorHandler*/
     bool sensorHandlerInit(boost::asio::yield_context yield);
 
-    /** @brief Read sensor value and update interfaces*/
-    bool populateSensorValue(boost::asio::yield_context yield);
+    /** @brief Read sensor value and update interfaces
+     *
+     * @param priority[in] - Priority of the read on a rate limited bus
+     */
+    bool populateSensorValue(
+        boost::asio::yield_context yield,
+        const MessagePriority priority = MessagePriority::normal);
 
     /**@brief Check sensor is disabled or not*/
     bool isSensorDisabled()
@@ -55,12 +61,28 @@ class StateSensorHandler
     /** @brief Check if sensor error threshold crossed*/
     bool sensorErrorCheck();
 
+    /** @brief Clear read failures so that the sensor is polled again*/
+    void resetErrorCount();
+
+    /** @brief Time of the last successful sensor read*/
+    std::chrono::steady_clock::time_point getLastUpdated() const
+    {
+        return lastUpdated;
+    }
+
+    /** @brief Last read states of all the composite sensor instances*/
+    const std::vector<uint8_t>& getCurrentStates() const
+    {
+        return currentStateReadings;
+    }
+
   private:
     /** @brief Enable/Disable sensor*/
     bool setStateSensorEnables(boost::asio::yield_context yield);
 
     /** @brief fetch the sensor value*/
-    bool getStateSensorReadings(boost::asio::yield_context yield);
+    bool getStateSensorReadings(boost::asio::yield_context yield,
+                                const MessagePriority priority);
 
     /** @brief Set initial D-Bus interfaces and properties*/
     void setInitialProperties();
@@ -77,16 +99,25 @@ class StateSensorHandler
     /** @brief Increment the error count in case of failure*/
     void incrementError();
 
-    /** @brief Update sensor state*/
-    void updateState(const uint8_t currentState, const uint8_t previousState);
+    /** @brief Update states of all the composite sensor instances*/
+    void updateState(const std::vector<uint8_t>& currentStates,
+                     const std::vector<uint8_t>& previousStates);
 
-    /** @brief Handle sensor reading*/
-    bool handleSensorReading(get_sensor_state_field& stateReading);
+    /** @brief Handle readings of all the composite sensor instances*/
+    bool handleSensorReading(const get_sensor_state_field* stateReadings,
+                             const uint8_t sensorCount);
 
     /** @brief Log redfish event for sensor state change*/
-    void logStateChangeEvent(const uint8_t currentState,
+    void logStateChangeEvent(const size_t sensorOffset,
+                             const uint8_t currentState,
                              const uint8_t previousState);
 
+    /** @brief Check if the sensor is a composite sensor*/
+    bool isCompositeSensor() const
+    {
+        return compositeSensorCount > 1;
+    }
+
     /** @brief Terminus ID*/
     pldm_tid_t _tid;
 
@@ -99,6 +130,9 @@ class StateSensorHandler
     /** @brief Sensor PDR*/
     std::shared_ptr<StateSensorPDR> _pdr;
 
+    /** @brief Number of sensor instances in the composite sensor*/
+    uint8_t compositeSensorCount;
+
     /** @brief Error counter*/
     size_t errCount = 0;
 
@@ -108,8 +142,11 @@ class StateSensorHandler
     /** @brief Cache readings for later use*/
     bool isAvailableReading = false;
     bool isFuntionalReading = false;
-    uint8_t previousStateReading = PLDM_INVALID_VALUE;
-    uint8_t currentStateReading = PLDM_INVALID_VALUE;
+    std::vector<uint8_t> previousStateReadings;
+    std::vector<uint8_t> currentStateReadings;
+
+    /** @brief Time of the last successful sensor read*/
+    std::chrono::steady_clock::time_point lastUpdated{};
 
     /** @brief Flags which indicate interfaces are ready*/
     bool sensorIntfReady = false;
@@ -123,6 +160,8 @@ class StateSensorHandler
         nullptr;
     std::unique_ptr<sdbusplus::asio::dbus_interface> operationalInterface =
         nullptr;
+    std::unique_ptr<sdbusplus::asio::dbus_interface> timestampInterface =
+        nullptr;
 };
 
 } // namespace platform
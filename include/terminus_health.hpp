@@ -0,0 +1,127 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "pldm.hpp"
+
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+#include <memory>
+
+namespace pldm
+{
+
+/** @brief Health of a terminus as seen by the transport*/
+enum class TerminusHealth
+{
+    /** @brief Last transaction succeeded*/
+    healthy,
+    /** @brief Recent transactions failed, traffic is still allowed*/
+    degraded,
+    /** @brief Terminus is not responding. Traffic is blocked and the terminus
+     * is probed periodically*/
+    open
+};
+
+/** @brief Circuit breaker of a terminus
+ *
+ * Consecutive transaction failures move the terminus from healthy to degraded
+ * and then to open. While open, only a GetTID probe is sent to the terminus on
+ * an exponential backoff schedule. A successful probe or any message received
+ * from the terminus closes the circuit. The backoff is reset only by regular
+ * traffic succeeding, thus a terminus which keeps failing right after recovery
+ * is probed less often.
+ */
+class CircuitBreaker : public std::enable_shared_from_this<CircuitBreaker>
+{
+  public:
+    CircuitBreaker() = delete;
+    CircuitBreaker(const CircuitBreaker&) = delete;
+    CircuitBreaker(CircuitBreaker&&) = delete;
+    CircuitBreaker& operator=(const CircuitBreaker&) = delete;
+    CircuitBreaker& operator=(CircuitBreaker&&) = delete;
+    ~CircuitBreaker();
+
+    CircuitBreaker(const pldm_tid_t tid);
+
+    /** @brief Current health of the terminus*/
+    TerminusHealth getHealth() const
+    {
+        return health;
+    }
+
+    /** @brief Record a completed transaction*/
+    void recordSuccess();
+
+    /** @brief Record a transaction which got no valid response*/
+    void recordFailure();
+
+  private:
+    /** @brief Block the traffic and start probing the terminus*/
+    void openCircuit();
+
+    /** @brief Schedule the next probe after probeInterval*/
+    void scheduleProbe();
+
+    /** @brief Handle the result of a probe*/
+    void onProbeComplete(const bool success);
+
+    /** @brief Terminus ID*/
+    pldm_tid_t _tid;
+
+    /** @brief Current health*/
+    TerminusHealth health = TerminusHealth::healthy;
+
+    /** @brief Number of failed transactions since the last success*/
+    size_t consecutiveFailures = 0;
+
+    /** @brief Delay before the next probe*/
+    std::chrono::milliseconds probeInterval;
+
+    /** @brief Timer to schedule the probes*/
+    boost::asio::steady_timer probeTimer;
+};
+
+/** @brief Check whether traffic to the terminus is allowed
+ *
+ * @param tid[in] - TID of the PLDM terminus
+ *
+ * @return false if the circuit of the terminus is open
+ */
+bool isTerminusAvailable(const pldm_tid_t tid);
+
+/** @brief Update terminus health with the outcome of a transaction
+ *
+ * @param tid[in] - TID of the PLDM terminus
+ * @param success[in] - true if a valid response is received
+ */
+void recordTransportOutcome(const pldm_tid_t tid, const bool success);
+
+/** @brief Get the health of a terminus
+ *
+ * @param tid[in] - TID of the PLDM terminus
+ *
+ * @return Terminus health. Termini without any traffic are healthy
+ */
+TerminusHealth getTerminusHealth(const pldm_tid_t tid);
+
+/** @brief Remove the health tracking of a terminus
+ *
+ * @param tid[in] - TID of the PLDM terminus
+ */
+void deleteTerminusHealth(const pldm_tid_t tid);
+
+} // namespace pldm
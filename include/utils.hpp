@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <sstream>
 #include <vector>
 
@@ -60,4 +61,33 @@ inline uint32_t to_uint32(uint64_t num)
     return static_cast<uint32_t>(num);
 }
 
+/** @brief Helper to convert a steady clock time point to wall clock time
+ *
+ * @param timePoint[in] - Steady clock time point
+ * @return - Microseconds since epoch. 0 if the time point is not set
+ *
+ */
+uint64_t toEpochMicroseconds(
+    const std::chrono::steady_clock::time_point& timePoint);
+
+/** @brief Incremental CRC-32, same as crc32() of libpldm
+ *
+ * Allows computing the CRC of data received in parts as the parts arrive.
+ */
+class Crc32
+{
+  public:
+    /** @brief Add bytes to the CRC*/
+    void update(const uint8_t* data, size_t size);
+
+    /** @brief CRC of all the bytes added so far*/
+    uint32_t value() const
+    {
+        return ~crc;
+    }
+
+  private:
+    uint32_t crc = ~0U;
+};
+
 } // namespace utils
@@ -907,6 +907,20 @@ bool deleteDeviceBaseInfo(const pldm_tid_t tid)
     return discoveryDataTable.erase(tid) == 1;
 }
 
+std::optional<std::array<uint8_t, 16>> getTerminusUUID(const pldm_tid_t tid)
+{
+    auto itr = std::find_if(uuidMapping.begin(), uuidMapping.end(),
+                            [&tid](const auto& uuidTID) {
+                                auto const& [uuid, mappedTID] = uuidTID;
+                                return mappedTID == tid;
+                            });
+    if (itr == uuidMapping.end())
+    {
+        return std::nullopt;
+    }
+    return itr->first;
+}
+
 bool isSupported(pldm_tid_t tid, const uint8_t type, const uint8_t cmd)
 {
     try
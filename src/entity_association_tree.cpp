@@ -0,0 +1,157 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "entity_association_tree.hpp"
+
+#include <phosphor-logging/log.hpp>
+
+namespace pldm
+{
+namespace platform
+{
+
+bool EntityAssociationTree::addNode(const pldm_entity& entity,
+                                    const EntityNodeIndex parent)
+{
+    auto nodeIdx = static_cast<EntityNodeIndex>(nodes.size());
+    if (!nodeIndex.emplace(entity, nodeIdx).second)
+    {
+        return false;
+    }
+    nodes.push_back({entity, parent, invalidEntityNode, 0});
+    return true;
+}
+
+bool EntityAssociationTree::build(std::vector<EntityAssociation>& associations,
+                                  const ContainerID rootContainerID)
+{
+    clear();
+
+    // Merge the associations having the same container entity. All the
+    // associations in the root container are merged to the first of them.
+    std::optional<size_t> rootAssociation;
+    EntityMap<size_t> containers;
+    containers.reserve(associations.size());
+    size_t nodeCount = 1;
+    for (size_t idx = 0; idx < associations.size(); ++idx)
+    {
+        EntityAssociation& association = associations[idx];
+        nodeCount += association.containedEntities.size();
+
+        size_t mergeTo;
+        if (association.containerEntity.entity_container_id == rootContainerID)
+        {
+            if (!rootAssociation)
+            {
+                rootAssociation = idx;
+                continue;
+            }
+            mergeTo = *rootAssociation;
+        }
+        else
+        {
+            auto [container, inserted] =
+                containers.emplace(association.containerEntity, idx);
+            if (inserted)
+            {
+                continue;
+            }
+            mergeTo = container->second;
+        }
+
+        std::vector<pldm_entity>& containedEntities =
+            associations[mergeTo].containedEntities;
+        containedEntities.insert(containedEntities.end(),
+                                 association.containedEntities.begin(),
+                                 association.containedEntities.end());
+        association.containedEntities.clear();
+    }
+
+    if (!rootAssociation)
+    {
+        return false;
+    }
+
+    // Node count is an upper bound, nodes are never reallocated
+    nodes.reserve(nodeCount);
+    nodeIndex.reserve(nodeCount);
+    addNode(associations[*rootAssociation].containerEntity, invalidEntityNode);
+
+    // Nodes appended in the loop are visited as well, thus the associations
+    // are attached breadth first starting from the root
+    size_t attachedCount = 0;
+    for (EntityNodeIndex nodeIdx = 0; nodeIdx < nodes.size(); ++nodeIdx)
+    {
+        const EntityAssociation* association = nullptr;
+        if (nodeIdx == 0)
+        {
+            association = &associations[*rootAssociation];
+        }
+        else
+        {
+            auto container = containers.find(nodes[nodeIdx].entity);
+            if (container == containers.end())
+            {
+                continue;
+            }
+            association = &associations[container->second];
+            ++attachedCount;
+        }
+
+        auto firstChild = static_cast<EntityNodeIndex>(nodes.size());
+        for (const pldm_entity& entity : association->containedEntities)
+        {
+            if (!addNode(entity, nodeIdx))
+            {
+                phosphor::logging::log<phosphor::logging::level::WARNING>(
+                    "Discarding cyclic entity association");
+            }
+        }
+        if (nodes.size() > firstChild)
+        {
+            nodes[nodeIdx].firstChild = firstChild;
+            nodes[nodeIdx].childCount =
+                static_cast<EntityNodeIndex>(nodes.size()) - firstChild;
+        }
+    }
+
+    // Safe check in case there is an invalid PDR
+    if (attachedCount < containers.size())
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "Invalid Entity Association PDRs found");
+    }
+    return true;
+}
+
+std::optional<EntityNodeIndex>
+    EntityAssociationTree::find(const pldm_entity& entity) const
+{
+    auto node = nodeIndex.find(entity);
+    if (node == nodeIndex.end())
+    {
+        return std::nullopt;
+    }
+    return node->second;
+}
+
+void EntityAssociationTree::clear()
+{
+    nodes.clear();
+    nodeIndex.clear();
+}
+
+} // namespace platform
+} // namespace pldm
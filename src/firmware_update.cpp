@@ -15,12 +15,24 @@
  */
 #include "firmware_update.hpp"
 
+#include "fwu_chunk_cache.hpp"
 #include "fwu_inventory.hpp"
+#include "fwu_package_stager.hpp"
+#include "fwu_package_validator.hpp"
+#include "fwu_simulated_device.hpp"
+#include "fwu_telemetry.hpp"
 #include "platform.hpp"
 #include "pldm.hpp"
 #include "pldm_fwu_image.hpp"
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <deque>
 #include <filesystem>
+#include <fstream>
+#include <limits>
 #include <phosphor-logging/log.hpp>
 #include <xyz/openbmc_project/PLDM/FWU/FWUBase/server.hpp>
 
@@ -40,6 +52,9 @@ constexpr uint16_t timeout = 100;
 // Timeout in milliseconds in between fwu command
 constexpr uint16_t fdCmdTimeout = 5000;
 
+// Requests from the FD held till the session gets to them
+constexpr size_t maxQueuedFDRequests = 32;
+
 // Maximum retry count
 constexpr size_t retryCount = 3;
 
@@ -53,22 +68,141 @@ constexpr uint16_t retryRequestForUpdateDelay = 5000;
 // data command
 const uint32_t requestFirmwareDataIdleTimeoutMs = 90000;
 
+// Bytes of the component read from the package at a time
+constexpr uint32_t fwDataWindowSize = 64 * 1024;
+
+// Largest MaximumTransferSize that can be offered to the FDs. The length an FD
+// requests sizes the response buffer of its session and the scratch buffer
+// parts spanning two windows are copied to, keep those to a package window.
+constexpr uint32_t maxTransferSizeLimit = fwDataWindowSize;
+
+// Number of recently read windows kept in addition to the ones in use
+constexpr size_t fwDataRecentWindows = 16;
+
+// Times a stalled component download is resumed before it is cancelled
+constexpr size_t maxDownloadResumes = 3;
+
 // Maximum GetDeviceMetaData response count
 constexpr size_t deviceMetaDataResponseCount = 100;
 
+// Default number of termini updated concurrently from a package
+constexpr uint8_t defaultMaxParallelUpdates = 4;
+
+// Directory packages are staged in before they are mapped, so that no other
+// process can truncate or rewrite a package while it is in use. Kept off tmpfs,
+// so a staged package does not take RAM beyond the page cache.
+constexpr const char* fwuStagingDir = "/var/lib/pldm/fwu-staging";
+
+// Free space left on the staging filesystem when a package is staged.
+// Packages larger than the free space less this margin are rejected.
+constexpr uintmax_t stagingFreeSpaceMargin = 64 * 1024 * 1024;
+
+// Transfer rate assumed till the rate of the FD is measured. From the test
+// results we observed that it took around 60 seconds for updating a pldm image
+// of size 160KB, based on this bytesPerSec is calculated.
+constexpr double defaultBytesPerSec = 2730;
+
+// Minimum bandwidth reservation in seconds, leaves room for renewing it
+constexpr uint32_t minReserveEidTimeOut = 10;
+
+// Highest TID handed to the simulated FDs of a dry run, counting down
+constexpr pldm_tid_t firstSimulatedTid = 0xFE;
+
 using FWUBase = sdbusplus::xyz::openbmc_project::PLDM::FWU::server::FWUBase;
 extern std::map<pldm_tid_t, FDProperties> terminusFwuProperties;
-std::shared_ptr<boost::asio::steady_timer> expectedCommandTimer = nullptr;
 std::unique_ptr<PLDMImg> pldmImg = nullptr;
-std::unique_ptr<FWUpdate> fwUpdate = nullptr;
+// Component data of pldmImg shared by the update sessions
+static std::unique_ptr<FWUChunkCache> chunkCache = nullptr;
+// Validates the components of pldmImg while the sessions start
+static std::unique_ptr<FWUPackageValidator> packageValidator = nullptr;
+// A package is being staged
+static bool packageStaging = false;
+// Update sessions of the package in progress
+static std::map<pldm_tid_t, std::unique_ptr<FWUpdate>> fwUpdateSessions;
+static uint8_t maxParallelUpdates = defaultMaxParallelUpdates;
+// MaximumTransferSize offered to the FDs, the dry run offers the same
+static uint32_t maxTransferSize = PLDM_FWU_BASELINE_TRANSFER_SIZE;
+// Statistics of the last update session of each FD
+static std::map<pldm_tid_t, std::shared_ptr<FWUTelemetry>> fwuTelemetry;
 std::unique_ptr<sdbusplus::asio::dbus_interface> associationsIntf = nullptr;
 std::map<uint8_t, std::string> inventoryPaths;
+// The package in progress is updated on simulated FDs
+static bool dryRun = false;
+static FWUSimulationConfig simulationConfig;
+// Simulated FDs of the dry run in progress and their properties
+static std::map<pldm_tid_t, std::shared_ptr<FWUSimulatedDevice>>
+    simulatedDevices;
+static std::map<pldm_tid_t, FDProperties> simulatedFwuProperties;
+static std::shared_ptr<sdbusplus::asio::dbus_interface> dryRunIface = nullptr;
+
+template <typename propertyType>
+static void updateFWUProperty(const boost::asio::yield_context yield,
+                              const std::string& interfaceName,
+                              const std::string& propertyName,
+                              const propertyType& propertyValue)
+{
+    // Dry runs have no software object of the updater behind them
+    if (dryRun)
+    {
+        return;
+    }
+    auto bus = getSdBus();
+    boost::system::error_code ec;
+    // pldm image filename from image path
+    std::string pldm_image =
+        std::filesystem::path(pldmImg->getImagePath()).parent_path().filename();
+    std::string objPath = "/xyz/openbmc_project/software/" + pldm_image;
+
+    bus->yield_method_call<>(
+        yield, ec, "xyz.openbmc_project.Software.BMC.Updater", objPath,
+        "org.freedesktop.DBus.Properties", "Set", interfaceName, propertyName,
+        std::variant<std::decay_t<decltype(propertyValue)>>(propertyValue));
+    if (ec)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            ("Firmware update property updation failed. PROPERTY: " +
+             propertyName)
+                .c_str());
+    }
+}
+
+/** @brief Publish the average progress of the update sessions as progress of
+ * the package
+ */
+static void updateActivationProgress(const boost::asio::yield_context yield)
+{
+    if (fwUpdateSessions.empty())
+    {
+        return;
+    }
+    size_t totalProgress = 0;
+    for (const auto& [tid, session] : fwUpdateSessions)
+    {
+        totalProgress += session->getUpdateProgress();
+    }
+    uint8_t progress =
+        static_cast<uint8_t>(totalProgress / fwUpdateSessions.size());
+    updateFWUProperty(yield, "xyz.openbmc_project.Software.ActivationProgress",
+                      "Progress", progress);
+}
 
 FWUpdate::FWUpdate(const pldm_tid_t _tid, const uint8_t _deviceIDRecord) :
+    currentTid(_tid),
+    expectedCommandTimer(
+        std::make_unique<boost::asio::steady_timer>(*getIoContext())),
     reserveBWTimer(
         std::make_unique<boost::asio::steady_timer>(*getIoContext())),
-    currentTid(_tid), currentDeviceIDRecord(_deviceIDRecord), state(FD_IDLE)
+    currentDeviceIDRecord(_deviceIDRecord), state(FD_IDLE)
+{
+    // Previous statistics of the FD go first as they own the D-Bus object
+    fwuTelemetry.erase(currentTid);
+    telemetry = std::make_shared<FWUTelemetry>(currentTid);
+    fwuTelemetry.emplace(currentTid, telemetry);
+}
+
+void FWUpdate::finishTelemetry(const bool updated)
 {
+    telemetry->startPhase(updated ? FWUPhase::complete : FWUPhase::failed);
 }
 
 void FWUpdate::validateReqForFWUpdCmd(const pldm_tid_t tid,
@@ -81,39 +215,165 @@ void FWUpdate::validateReqForFWUpdCmd(const pldm_tid_t tid,
             "Invalid FW request");
         return;
     }
-    const struct pldm_msg_hdr* msgHdr =
-        reinterpret_cast<const pldm_msg_hdr*>(req.data());
-
-    if (expectedCmd == PLDM_REQUEST_FIRMWARE_DATA &&
-        msgHdr->command == PLDM_TRANSFER_COMPLETE)
+    if (tid != currentTid)
     {
-        expectedCmd = PLDM_TRANSFER_COMPLETE;
-        fdTransferCompleted = true;
         phosphor::logging::log<phosphor::logging::level::INFO>(
-            ("TransferComplete received from TID: " +
+            ("Firmware update in progress for TID: " +
              std::to_string(currentTid))
                 .c_str());
+        return;
+    }
+    if (fdReqQueue.size() >= maxQueuedFDRequests)
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "Too many pending FD requests, dropping the request",
+            phosphor::logging::entry("TID=%d", tid));
+        return;
+    }
+    fdReqQueue.push_back({messageTag, req});
+    // The timer serves other delays as well, only a wait for a request may
+    // be cut short
+    if (fdReqWaiting)
+    {
+        expectedCommandTimer->cancel();
     }
+}
 
-    if (tid != currentTid || msgHdr->command != expectedCmd)
+bool FWUpdate::waitForFDRequest(const boost::asio::yield_context yield,
+                                const uint8_t command, const uint32_t interval)
+{
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(interval);
+    while (true)
     {
-        phosphor::logging::log<phosphor::logging::level::INFO>(
-            ("Firmware update in progress for TID: " +
-             std::to_string(currentTid))
-                .c_str());
+        // Requests received while the session was busy are in the queue
+        // already, check it before arming the timer
+        while (!fdReqQueue.empty())
+        {
+            FDRequest request = std::move(fdReqQueue.front());
+            fdReqQueue.pop_front();
+            const struct pldm_msg_hdr* msgHdr =
+                reinterpret_cast<const pldm_msg_hdr*>(request.data.data());
+            if (msgHdr->command == command ||
+                (command == PLDM_REQUEST_FIRMWARE_DATA &&
+                 msgHdr->command == PLDM_TRANSFER_COMPLETE))
+            {
+                if (msgHdr->command != command)
+                {
+                    fdTransferCompleted = true;
+                    phosphor::logging::log<phosphor::logging::level::INFO>(
+                        ("TransferComplete received from TID: " +
+                         std::to_string(currentTid))
+                            .c_str());
+                }
+                msgTag = request.msgTag;
+                fdReq = std::move(request.data);
+                return true;
+            }
+            dispatchFDRequest(yield, request);
+        }
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            return false;
+        }
+        boost::system::error_code ec;
+        expectedCommandTimer->expires_at(deadline);
+        fdReqWaiting = true;
+        expectedCommandTimer->async_wait(yield[ec]);
+        fdReqWaiting = false;
+    }
+}
+
+bool FWUpdate::isFDCommandValid(const uint8_t command) const
+{
+    // A completion is valid in the state following it as well, the FD sends
+    // it again if it did not get the response
+    switch (command)
+    {
+        case PLDM_GET_PACKAGE_DATA:
+            return fdState == FD_LEARN_COMPONENTS;
+        case PLDM_GET_META_DATA:
+            return fdState != FD_IDLE && fdState != FD_LEARN_COMPONENTS;
+        case PLDM_REQUEST_FIRMWARE_DATA:
+            return fdState == FD_DOWNLOAD;
+        case PLDM_TRANSFER_COMPLETE:
+            return fdState == FD_DOWNLOAD || fdState == FD_VERIFY;
+        case PLDM_VERIFY_COMPLETE:
+            return fdState == FD_VERIFY || fdState == FD_APPLY;
+        case PLDM_APPLY_COMPLETE:
+            return fdState == FD_APPLY || fdState == FD_READY_XFER;
+        default:
+            return false;
+    }
+}
+
+void FWUpdate::dispatchFDRequest(const boost::asio::yield_context yield,
+                                 const FDRequest& request)
+{
+    const struct pldm_msg_hdr* msgHdr =
+        reinterpret_cast<const pldm_msg_hdr*>(request.data.data());
+    uint8_t command = msgHdr->command;
+    msgTag = request.msgTag;
+    if (!updateMode || !isFDCommandValid(command))
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "FD command not expected",
+            phosphor::logging::entry("TID=%d", currentTid),
+            phosphor::logging::entry("COMMAND=0x%X", command),
+            phosphor::logging::entry("FD_STATE=%d", fdState));
+        sendErrorCompletionCode(yield, msgHdr->instance_id,
+                                COMMAND_NOT_EXPECTED, command);
         return;
     }
-    msgTag = messageTag;
-    fdReqMatched = true;
-    fdReq = req;
-    expectedCommandTimer->cancel();
-    return;
+
+    size_t offset = 0;
+    size_t length = PLDM_FWU_BASELINE_TRANSFER_SIZE;
+    std::set<uint32_t> recvdRequests;
+    switch (command)
+    {
+        case PLDM_GET_PACKAGE_DATA:
+            if (packageData.empty())
+            {
+                sendErrorCompletionCode(yield, msgHdr->instance_id,
+                                        COMMAND_NOT_EXPECTED, command);
+                return;
+            }
+            sendPackageData(yield, request.data, offset, length,
+                            recvdRequests);
+            return;
+        case PLDM_GET_META_DATA:
+            if (fwDeviceMetaData.empty())
+            {
+                sendErrorCompletionCode(yield, msgHdr->instance_id,
+                                        COMMAND_NOT_EXPECTED, command);
+                return;
+            }
+            sendMetaData(yield, request.data, offset, length,
+                         recvdRequests);
+            return;
+        case PLDM_REQUEST_FIRMWARE_DATA:
+            // Only reaches here when the download has been given up
+            sendErrorCompletionCode(yield, msgHdr->instance_id,
+                                    COMMAND_NOT_EXPECTED, command);
+            return;
+        default:
+            // Completion sent again, the FD lost the response
+            phosphor::logging::log<phosphor::logging::level::INFO>(
+                "Acknowledging repeated FD completion",
+                phosphor::logging::entry("TID=%d", currentTid),
+                phosphor::logging::entry("COMMAND=0x%X", command));
+            sendErrorCompletionCode(yield, msgHdr->instance_id, PLDM_SUCCESS,
+                                    command);
+            return;
+    }
 }
 
 bool FWUpdate::setMatchedFDDescriptors()
 {
-    auto itr = terminusFwuProperties.find(currentTid);
-    if (itr == terminusFwuProperties.end())
+    const std::map<pldm_tid_t, FDProperties>& fdProperties =
+        dryRun ? simulatedFwuProperties : terminusFwuProperties;
+    auto itr = fdProperties.find(currentTid);
+    if (itr == fdProperties.end())
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             ("setMatchedFDDescriptors: targetFDProperties not found for "
@@ -181,50 +441,26 @@ void FWUpdate::terminateFwUpdate(const boost::asio::yield_context yield)
     return;
 }
 
-uint16_t FWUpdate::getApplicableComponentsCount(uint64_t val) const
-{
-    uint16_t updatableComponents = 0;
-    while (val)
-    {
-        val &= (val - 1);
-        updatableComponents++;
-    }
-    return updatableComponents;
-}
-
 bool FWUpdate::prepareRequestUpdateCommand()
 {
-    uint16_t tempShort = 0;
-    updateProperties.max_transfer_size = PLDM_FWU_BASELINE_TRANSFER_SIZE;
-    applicableComponentsVal = getApplicableComponents();
-    updateProperties.no_of_comp =
-        getApplicableComponentsCount(applicableComponentsVal);
-    updateProperties.max_outstand_transfer_req = 1;
-    if (!pldmImg->getDevIdRcrdProperty<uint16_t>(tempShort, "FWDevPkgDataLen",
-                                                 currentDeviceIDRecord))
-    {
-        return false;
-    }
-    updateProperties.pkg_data_len = tempShort;
-    if (!pldmImg->getDevIdRcrdProperty<uint8_t>(
-            updateProperties.comp_image_set_ver_str_len, "ComImgSetVerStrLen",
-            currentDeviceIDRecord))
-    {
-        return false;
-    }
-    if (!pldmImg->getDevIdRcrdProperty<uint8_t>(
-            updateProperties.comp_image_set_ver_str_type, "ComImgSetVerStrType",
-            currentDeviceIDRecord))
-    {
-        return false;
-    }
-
-    if (!pldmImg->getDevIdRcrdProperty<std::string>(
-            componentImageSetVersionString, "CompImgSetVerStr",
-            currentDeviceIDRecord))
+    const PkgDeviceIDRecord* record =
+        pldmImg->getDeviceIDRecord(currentDeviceIDRecord);
+    if (!record)
     {
         return false;
     }
+    updateProperties.max_transfer_size = maxTransferSize;
+    applicableComponents = record->applicableComponents;
+    updateProperties.no_of_comp =
+        static_cast<uint16_t>(applicableComponents.count());
+    updateProperties.max_outstand_transfer_req = 1;
+    updateProperties.pkg_data_len =
+        static_cast<uint16_t>(record->fwDevPkgData.length);
+    updateProperties.comp_image_set_ver_str_len =
+        static_cast<uint8_t>(record->compImgSetVerStr.size());
+    updateProperties.comp_image_set_ver_str_type =
+        record->compImgSetVerStrType;
+    componentImageSetVersionString = std::string(record->compImgSetVerStr);
     return true;
 }
 
@@ -232,43 +468,19 @@ bool FWUpdate::preparePassComponentRequest(
     struct pass_component_table_req& componentTable,
     std::string& compVersionString, const uint16_t compCnt)
 {
-    uint16_t tempShort = 0;
-    uint32_t tempLong = 0;
-
-    if (!pldmImg->getCompProperty<uint16_t>(tempShort, "CompClassification",
-                                            compCnt))
+    const PkgComponent* component = pldmImg->getComponent(compCnt);
+    if (!component)
     {
         return false;
     }
-    componentTable.comp_classification = tempShort;
+    componentTable.comp_classification = component->classification;
     componentTable.comp_classification_index = 0;
-    if (!pldmImg->getCompProperty<uint32_t>(tempLong, "CompComparisonStamp",
-                                            compCnt))
-    {
-        return false;
-    }
-    componentTable.comp_comparison_stamp = tempLong;
-    if (!pldmImg->getCompProperty<uint16_t>(tempShort, "CompIdentifier",
-                                            compCnt))
-    {
-        return false;
-    }
-    componentTable.comp_identifier = tempShort;
-    if (!pldmImg->getCompProperty<uint8_t>(componentTable.comp_ver_str_len,
-                                           "CompVerStrLen", compCnt))
-    {
-        return false;
-    }
-    if (!pldmImg->getCompProperty<uint8_t>(componentTable.comp_ver_str_type,
-                                           "CmpVerStrType", compCnt))
-    {
-        return false;
-    }
-    if (!pldmImg->getCompProperty<std::string>(compVersionString, "CompVerStr",
-                                               compCnt))
-    {
-        return false;
-    }
+    componentTable.comp_comparison_stamp = component->comparisonStamp;
+    componentTable.comp_identifier = component->identifier;
+    componentTable.comp_ver_str_len =
+        static_cast<uint8_t>(component->versionString.size());
+    componentTable.comp_ver_str_type = component->versionStringType;
+    compVersionString = std::string(component->versionString);
     return initPassComponentTableTransferFlag(componentTable.transfer_flag);
 }
 
@@ -305,49 +517,21 @@ bool FWUpdate::initPassComponentTableTransferFlag(uint8_t& flag)
 bool FWUpdate::prepareUpdateComponentRequest(
     std::string& compVersionString, struct update_component_req& component)
 {
-    uint16_t tempShort = 0;
-    uint32_t tempLong = 0;
-
-    if (!pldmImg->getCompProperty<uint16_t>(tempShort, "CompClassification",
-                                            currentComp))
+    const PkgComponent* pkgComponent = pldmImg->getComponent(currentComp);
+    if (!pkgComponent)
     {
         return false;
     }
-    component.comp_classification = tempShort;
-    if (!pldmImg->getCompProperty<uint16_t>(tempShort, "CompIdentifier",
-                                            currentComp))
-    {
-        return false;
-    }
-    component.comp_identifier = tempShort;
+    component.comp_classification = pkgComponent->classification;
+    component.comp_identifier = pkgComponent->identifier;
     component.comp_classification_index = 0;
-    if (!pldmImg->getCompProperty<uint32_t>(tempLong, "CompComparisonStamp",
-                                            currentComp))
-    {
-        return false;
-    }
-    component.comp_comparison_stamp = tempLong;
-    if (!pldmImg->getCompProperty<uint32_t>(tempLong, "CompSize", currentComp))
-    {
-        return false;
-    }
-    component.comp_image_size = tempLong;
+    component.comp_comparison_stamp = pkgComponent->comparisonStamp;
+    component.comp_image_size = pkgComponent->size;
     component.update_option_flags = {};
-    if (!pldmImg->getCompProperty<uint8_t>(component.comp_ver_str_type,
-                                           "CmpVerStrType", currentComp))
-    {
-        return false;
-    }
-    if (!pldmImg->getCompProperty<uint8_t>(component.comp_ver_str_len,
-                                           "CompVerStrLen", currentComp))
-    {
-        return false;
-    }
-    if (!pldmImg->getCompProperty<std::string>(compVersionString, "CompVerStr",
-                                               currentComp))
-    {
-        return false;
-    }
+    component.comp_ver_str_type = pkgComponent->versionStringType;
+    component.comp_ver_str_len =
+        static_cast<uint8_t>(pkgComponent->versionString.size());
+    compVersionString = std::string(pkgComponent->versionString);
     return true;
 }
 
@@ -556,7 +740,6 @@ int FWUpdate::processSendMetaData(const boost::asio::yield_context yield)
         return PLDM_SUCCESS;
     }
     transferHandle = 0; // Resetting transferHandle
-    expectedCmd = PLDM_GET_META_DATA;
 
     size_t offset = 0;
     int retVal = 0;
@@ -578,8 +761,7 @@ int FWUpdate::processSendMetaData(const boost::asio::yield_context yield)
 
     while (maxNumReq--)
     {
-        startTimer(yield, fdCmdTimeout);
-        if (!fdReqMatched)
+        if (!waitForFDRequest(yield, PLDM_GET_META_DATA, fdCmdTimeout))
         {
             phosphor::logging::log<phosphor::logging::level::WARNING>(
                 "TimeoutWaiting for processsendMetaData packet");
@@ -588,7 +770,7 @@ int FWUpdate::processSendMetaData(const boost::asio::yield_context yield)
             break;
         }
 
-        retVal = sendMetaData(yield, offset, length, recvdRequests);
+        retVal = sendMetaData(yield, fdReq, offset, length, recvdRequests);
         if (retVal != PLDM_SUCCESS)
         {
             phosphor::logging::log<phosphor::logging::level::ERR>(
@@ -601,18 +783,14 @@ int FWUpdate::processSendMetaData(const boost::asio::yield_context yield)
             break;
         }
         fdReq.clear();
-        fdReqMatched = false;
 
         // Confirm if meta data is been transferred completely
         if (recvdRequests.size() == numExpectedRequests)
         {
             phosphor::logging::log<phosphor::logging::level::INFO>(
                 "sendMetaData successful");
-            expectedCmd = 0; // clear expected command
             return retVal;
         }
-
-        expectedCmd = PLDM_GET_META_DATA;
     }
 
     if (maxNumReq == 0)
@@ -620,19 +798,17 @@ int FWUpdate::processSendMetaData(const boost::asio::yield_context yield)
         phosphor::logging::log<phosphor::logging::level::ERR>(
             ("processSendMetaData: Failed as requests exceed limit "));
     }
-    // Clear expected command.
-    expectedCmd = 0;
     fdReq.clear();
     return retVal;
 }
 
 int FWUpdate::sendMetaData(const boost::asio::yield_context yield,
-                           size_t& offset, size_t& length,
-                           std::set<uint32_t>& recvdRequests)
+                           const std::vector<uint8_t>& pldmReq, size_t& offset,
+                           size_t& length, std::set<uint32_t>& recvdRequests)
 {
 
     const struct pldm_msg* msgReq =
-        reinterpret_cast<const pldm_msg*>(fdReq.data());
+        reinterpret_cast<const pldm_msg*>(pldmReq.data());
 
     uint32_t dataTransferHandle = 1;
     uint8_t transferOperationFlag = PLDM_GET_FIRSTPART;
@@ -1223,42 +1399,43 @@ int FWUpdate::processRequestFirmwareData(const boost::asio::yield_context yield)
     int prevProgress = 0;
     // Log interval for progess percentage
     constexpr int progressPercentLogLimit = 25;
-    uint32_t componentSize;
-    uint32_t componentOffset;
-    if (!pldmImg->getCompProperty<uint32_t>(componentSize, "CompSize",
-                                            currentComp))
+    const PkgComponent* pkgComponent = pldmImg->getComponent(currentComp);
+    if (!pkgComponent)
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
-            ("Failed to get component size. COMPONENT: " +
+            ("Failed to get component. COMPONENT: " +
              std::to_string(currentComp))
                 .c_str());
         return PLDM_ERROR;
     }
-    if (!pldmImg->getCompProperty<uint32_t>(componentOffset,
-                                            "CompLocationOffset", currentComp))
+    uint32_t componentSize = pkgComponent->size;
+    uint32_t componentOffset = pkgComponent->locationOffset;
+    uint32_t maxNumReq = findMaxNumReq(componentSize);
+    if (fwDataAckedOffset != 0)
     {
-        phosphor::logging::log<phosphor::logging::level::WARNING>(
-            ("Failed to get component location offset. COMPONENT: " +
-             std::to_string(currentComp))
-                .c_str());
-        return PLDM_ERROR;
+        // Resumed download, have the data the FD stopped at ready to serve
+        FWUComponentRange component{currentComp, componentOffset,
+                                    componentSize};
+        uint32_t resumeLength = std::min(updateProperties.max_transfer_size,
+                                         componentSize - fwDataAckedOffset);
+        chunkCache->getData(component, fwDataAckedOffset, resumeLength,
+                            fwDataWindow, fwDataScratch);
     }
-    uint32_t maxNumReq = findMaxNumReq(componentSize);
-    initialize_fw_update(updateProperties.max_transfer_size, componentSize);
 
     while (--maxNumReq)
     {
-        startTimer(yield, requestFirmwareDataIdleTimeoutMs);
-        if (!fdReqMatched)
+        if (!waitForFDRequest(yield, PLDM_REQUEST_FIRMWARE_DATA,
+                              requestFirmwareDataIdleTimeoutMs))
         {
             phosphor::logging::log<phosphor::logging::level::WARNING>(
                 ("TimeoutWaiting for requestFirmwareData packet. COMPONENT: " +
                  std::to_string(currentComp))
                     .c_str());
-
+            telemetry->recordTimeout();
+            // The FD stalled, the download can be resumed
+            retVal = PLDM_ERROR_NOT_READY;
             break;
         }
-        fdReqMatched = false;
 
         if (fdTransferCompleted)
         {
@@ -1279,7 +1456,10 @@ int FWUpdate::processRequestFirmwareData(const boost::asio::yield_context yield)
             continue;
         }
         fdReq.clear();
-        int progress = ((offset + length) * 100) / componentSize;
+        fwDataAckedOffset = std::max(fwDataAckedOffset, offset);
+        int progress = static_cast<int>(
+            std::min<uint64_t>(uint64_t{offset} + length, componentSize) * 100 /
+            componentSize);
         if ((progress - prevProgress) >= progressPercentLogLimit)
         {
             prevProgress = progress;
@@ -1290,22 +1470,79 @@ int FWUpdate::processRequestFirmwareData(const boost::asio::yield_context yield)
                  "%")
                     .c_str());
         }
-        if (offset + length > componentSize)
-        {
-            expectedCmd = PLDM_TRANSFER_COMPLETE;
-            break;
-        }
+        // The last part is padded past the component. Keep serving till
+        // TransferComplete, the FD may request the part again.
     }
+    // Let other sessions and the cache drop the window
+    fwDataWindow.reset();
     if (!maxNumReq)
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             "Exceeded maximum no of RequestFirmwareData requests");
-        return PLDM_ERROR;
+        return PLDM_ERROR_NOT_READY;
     }
 
     return retVal;
 }
 
+int FWUpdate::resumeComponentDownload(const boost::asio::yield_context yield)
+{
+    int retVal = PLDM_ERROR_NOT_READY;
+    for (size_t attempt = 1;
+         attempt <= maxDownloadResumes && retVal == PLDM_ERROR_NOT_READY;
+         attempt++)
+    {
+        phosphor::logging::log<phosphor::logging::level::INFO>(
+            "Resuming component download",
+            phosphor::logging::entry("TID=%d", currentTid),
+            phosphor::logging::entry("COMPONENT=%d", currentComp),
+            phosphor::logging::entry("OFFSET=%u", fwDataAckedOffset),
+            phosphor::logging::entry("ATTEMPT=%zu", attempt));
+        // An FD still in DOWNLOAD carries on once its requests are served,
+        // otherwise the component is offered again. The UpdateComponent
+        // request is built from the package, thus has the same comparison
+        // stamp and lets the FD continue from the data it holds.
+        if (getStatus(yield) != PLDM_SUCCESS || currentState != FD_DOWNLOAD)
+        {
+            if (fdState == FD_DOWNLOAD)
+            {
+                retVal = doCancelUpdateComponent(yield);
+                if (retVal != PLDM_SUCCESS)
+                {
+                    // Transport may still be recovering, try again
+                    retVal = PLDM_ERROR_NOT_READY;
+                    continue;
+                }
+            }
+            uint8_t compCompatabilityResp = 0;
+            uint8_t compCompatabilityRespCode = 0;
+            bitfield32_t updateOptFlagsEnabled = {};
+            uint16_t estimatedTimeReqFd = 0;
+            retVal = processUpdateComponent(
+                yield, compCompatabilityResp, compCompatabilityRespCode,
+                updateOptFlagsEnabled, estimatedTimeReqFd);
+            if (retVal != PLDM_SUCCESS)
+            {
+                retVal = PLDM_ERROR_NOT_READY;
+                continue;
+            }
+            if (compCompatabilityResp != COMPONENT_CAN_BE_UPDATED)
+            {
+                phosphor::logging::log<phosphor::logging::level::WARNING>(
+                    "FD refused resuming the component",
+                    phosphor::logging::entry("TID=%d", currentTid),
+                    phosphor::logging::entry("COMPONENT=%d", currentComp),
+                    phosphor::logging::entry("RESP_CODE=%d",
+                                             compCompatabilityRespCode));
+                return PLDM_ERROR;
+            }
+            fdState = FD_DOWNLOAD;
+        }
+        retVal = processRequestFirmwareData(yield);
+    }
+    return retVal;
+}
+
 int FWUpdate::requestFirmwareData(const boost::asio::yield_context yield,
                                   const std ::vector<uint8_t>& pldmReq,
                                   uint32_t& offset, uint32_t& length,
@@ -1314,8 +1551,23 @@ int FWUpdate::requestFirmwareData(const boost::asio::yield_context yield,
 {
     const struct pldm_msg* msgReq =
         reinterpret_cast<const pldm_msg*>(pldmReq.data());
+    // The library checks the request against limits it keeps process wide.
+    // Sessions of other FDs update those in between, set the limits of this
+    // session right before decoding, and check the request against the
+    // session below regardless.
+    initialize_fw_update(updateProperties.max_transfer_size, componentSize);
     int retVal = decode_request_firmware_data_req(
         msgReq, pldmReq.size() - hdrSize, &offset, &length);
+    if (retVal == PLDM_SUCCESS &&
+        (length < PLDM_FWU_BASELINE_TRANSFER_SIZE ||
+         length > updateProperties.max_transfer_size))
+    {
+        retVal = INVALID_TRANSFER_LENGTH;
+    }
+    else if (retVal == PLDM_SUCCESS && offset >= componentSize)
+    {
+        retVal = DATA_OUT_OF_RANGE;
+    }
     if (retVal != PLDM_SUCCESS)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
@@ -1333,32 +1585,14 @@ int FWUpdate::requestFirmwareData(const boost::asio::yield_context yield,
         return retVal;
     }
 
-    /* completion code plus requested data length */
-    size_t payload_length = 1 + length;
-
-    std::vector<uint8_t> pldmResp(PLDMCCOnlyResponse + length);
-    std ::vector<uint8_t> data(length);
-    if (offset + length > componentSize)
-    {
-        if (offset < componentSize)
-        {
-            length = componentSize - offset;
-        }
-        else
-        {
-            if (!sendErrorCompletionCode(yield, msgReq->hdr.instance_id,
-                                         PLDM_ERROR,
-                                         PLDM_REQUEST_FIRMWARE_DATA))
-            {
-                phosphor::logging::log<phosphor::logging::level::ERR>(
-                    "RequestFirmwareData: Failed to send PLDM message",
-                    phosphor::logging::entry("TID=%d", currentTid));
-            }
-            return PLDM_ERROR;
-        }
-    }
+    // Data past the end of the component is sent as zero padding. The offset
+    // is within the component, the difference cannot wrap.
+    uint32_t dataLen = std::min(length, componentSize - offset);
 
-    if (!pldmImg->readData(offset + componentOffset, data, length))
+    FWUComponentRange component{currentComp, componentOffset, componentSize};
+    const uint8_t* data = chunkCache->getData(component, offset, dataLen,
+                                              fwDataWindow, fwDataScratch);
+    if (!data)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "update image read failed",
@@ -1373,12 +1607,16 @@ int FWUpdate::requestFirmwareData(const boost::asio::yield_context yield,
         return PLDM_ERROR;
     }
 
+    // Encoded straight from the cached window into the response buffer, which
+    // is reused across the requests of the update
     struct variable_field componentImagePortion = {};
-    componentImagePortion.length = data.size();
-    componentImagePortion.ptr = data.data();
-    struct pldm_msg* msgResp = reinterpret_cast<pldm_msg*>(pldmResp.data());
+    componentImagePortion.length = dataLen;
+    componentImagePortion.ptr = data;
+    fwDataResp.resize(PLDMCCOnlyResponse + dataLen);
+    struct pldm_msg* msgResp = reinterpret_cast<pldm_msg*>(fwDataResp.data());
+    /* completion code plus data length */
     retVal = encode_request_firmware_data_resp(msgReq->hdr.instance_id, msgResp,
-                                               payload_length, completionCode,
+                                               1 + dataLen, completionCode,
                                                &componentImagePortion);
 
     if (retVal != PLDM_SUCCESS)
@@ -1389,16 +1627,19 @@ int FWUpdate::requestFirmwareData(const boost::asio::yield_context yield,
             phosphor::logging::entry("RETVAL=%d", retVal));
         return retVal;
     }
+    // Zero padding, appended only to the last chunk of the component
+    fwDataResp.resize(PLDMCCOnlyResponse + length);
 
     // tag Owner bit cleared to false for respose message
     if (!sendPldmMessage(yield, currentTid, retryCount, msgTag, false,
-                         pldmResp))
+                         fwDataResp))
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "requestFirmwareData: Failed to send PLDM message",
             phosphor::logging::entry("TID=%d", currentTid));
         return PLDM_ERROR;
     }
+    telemetry->recordFirmwareData(offset, length, componentSize);
 
     return PLDM_SUCCESS;
 }
@@ -1435,15 +1676,20 @@ int FWUpdate::processSendPackageData(const boost::asio::yield_context yield)
     }
 
     // get package data from pldmImg
-    if (!pldmImg->getDevIdRcrdProperty<std::vector<uint8_t>>(
-            packageData, "FirmwareDevicePackageData", currentDeviceIDRecord) ||
-        !packageData.size())
+    const PkgDeviceIDRecord* record =
+        pldmImg->getDeviceIDRecord(currentDeviceIDRecord);
+    if (record)
+    {
+        packageData.assign(record->fwDevPkgData.ptr,
+                           record->fwDevPkgData.ptr +
+                               record->fwDevPkgData.length);
+    }
+    if (!record || !packageData.size())
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "Failed to get FirmwareDevicePackageData or packageData size is 0");
         return PLDM_ERROR;
     }
-    expectedCmd = PLDM_GET_PACKAGE_DATA;
 
     size_t offset = 0;
     int retVal = 0;
@@ -1460,15 +1706,15 @@ int FWUpdate::processSendPackageData(const boost::asio::yield_context yield)
 
     while (maxNumReq--)
     {
-        startTimer(yield, fdCmdTimeout);
-        if (!fdReqMatched)
+        if (!waitForFDRequest(yield, PLDM_GET_PACKAGE_DATA, fdCmdTimeout))
         {
             phosphor::logging::log<phosphor::logging::level::WARNING>(
                 "TimeoutWaiting for packageData packet");
             break;
         }
 
-        retVal = sendPackageData(yield, offset, length, recvdRequests);
+        retVal =
+            sendPackageData(yield, fdReq, offset, length, recvdRequests);
         if (retVal != PLDM_SUCCESS)
         {
             phosphor::logging::log<phosphor::logging::level::WARNING>(
@@ -1481,18 +1727,14 @@ int FWUpdate::processSendPackageData(const boost::asio::yield_context yield)
             break;
         }
         fdReq.clear();
-        fdReqMatched = false;
 
         // Confirm if complete package data is been transferred
         if (recvdRequests.size() == numExpectedRequests)
         {
             phosphor::logging::log<phosphor::logging::level::INFO>(
                 "sendPackageData successful");
-            expectedCmd = 0; // clear expected command
             return retVal;
         }
-
-        expectedCmd = PLDM_GET_PACKAGE_DATA;
     }
 
     if (maxNumReq == 0)
@@ -1500,11 +1742,11 @@ int FWUpdate::processSendPackageData(const boost::asio::yield_context yield)
         phosphor::logging::log<phosphor::logging::level::ERR>(
             ("processSendPackageData: Failed as requests exceed limit "));
     }
-    expectedCmd = 0; // clear expected command
     return retVal;
 }
 
 int FWUpdate::sendPackageData(const boost::asio::yield_context yield,
+                              const std::vector<uint8_t>& pldmReq,
                               size_t& offset, size_t& length,
                               std::set<uint32_t>& recvdRequests)
 {
@@ -1513,7 +1755,7 @@ int FWUpdate::sendPackageData(const boost::asio::yield_context yield,
     size_t dataSize = 0;
 
     const struct pldm_msg* msgReq =
-        reinterpret_cast<const pldm_msg*>(fdReq.data());
+        reinterpret_cast<const pldm_msg*>(pldmReq.data());
 
     int retVal = decode_get_pacakge_data_req(
         msgReq, sizeof(struct get_fd_data_req), &dataTransferHandle,
@@ -1879,30 +2121,9 @@ int FWUpdate::cancelUpdate(const boost::asio::yield_context yield,
     return PLDM_SUCCESS;
 }
 
-uint64_t FWUpdate::getApplicableComponents()
-{
-    std::vector<uint8_t> applicableComp;
-    uint64_t value = 0;
-    pldmImg->getDevIdRcrdProperty(applicableComp, "ApplicableComponents",
-                                  currentDeviceIDRecord);
-    int byteCount = 0;
-    for (auto byte : applicableComp)
-    {
-        value = value | (static_cast<uint64_t>(byte) << (8 * byteCount++));
-        if (byteCount > static_cast<int>(sizeof(uint64_t) - 1))
-        {
-            phosphor::logging::log<phosphor::logging::level::WARNING>(
-                "ApplicableComponents exceeding 8 bytes");
-            break;
-        }
-    }
-
-    return value;
-}
-
 bool FWUpdate::isComponentApplicable()
 {
-    return (applicableComponentsVal >> currentComp) & 1;
+    return applicableComponents[currentComp];
 }
 
 constexpr uint32_t convertSecondsToMilliseconds(const uint16_t seconds)
@@ -1920,15 +2141,78 @@ boost::system::error_code
     return ec;
 }
 
+bool FWUpdate::waitForActivation(
+    const boost::asio::yield_context yield,
+    const uint16_t estimatedTimeForSelfContainedActivation)
+{
+    constexpr uint32_t pollIntervalMilliSec = 1000;
+    constexpr uint32_t activationMarginMilliSec = 5000;
+    // An FD resetting to activate does not answer. Failures count towards
+    // opening the circuit of the terminus, stay below its threshold of three.
+    constexpr size_t maxGetStatusFailures = 2;
+    auto deadline =
+        std::chrono::steady_clock::now() +
+        std::chrono::milliseconds(convertSecondsToMilliseconds(
+                                      estimatedTimeForSelfContainedActivation) +
+                                  activationMarginMilliSec);
+    size_t getStatusFailures = 0;
+    while (true)
+    {
+        if (getStatus(yield) == PLDM_SUCCESS)
+        {
+            getStatusFailures = 0;
+            if (currentState == FD_IDLE)
+            {
+                return true;
+            }
+        }
+        else if (++getStatusFailures >= maxGetStatusFailures)
+        {
+            break;
+        }
+        if (std::chrono::steady_clock::now() >= deadline ||
+            startTimer(yield, pollIntervalMilliSec))
+        {
+            break;
+        }
+    }
+    phosphor::logging::log<phosphor::logging::level::WARNING>(
+        "FD did not return to IDLE after activation",
+        phosphor::logging::entry("TID=%d", currentTid),
+        phosphor::logging::entry("ESTIMATED_TIME_SEC=%d",
+                                 estimatedTimeForSelfContainedActivation));
+    return false;
+}
+
+uint64_t FWUpdate::getApplicableComponentsSize()
+{
+    uint64_t totalSize = 0;
+    for (uint16_t comp = 0; comp < compCount; comp++)
+    {
+        if (applicableComponents[comp])
+        {
+            totalSize += pldmImg->getComponent(comp)->size;
+        }
+    }
+    return totalSize;
+}
+
 uint16_t FWUpdate::getReserveEidTimeOut()
 {
-    size_t updatableImagesize = pldmImg->getUpdatableImagesize();
-    // From the test results we observed that it took around 60 seconds for
-    // updating a pldm image of size 160KB, based on this bytesPerSec is
-    // calculated.
-    constexpr uint16_t bytesPerSec = 2730;
+    // Rate measured in this session, else in the last session of the FD
+    std::optional<double> bytesPerSec = telemetry->getBytesPerSecond();
+    if (!bytesPerSec)
+    {
+        bytesPerSec = FWUTelemetry::getObservedThroughput(currentTid);
+    }
+    double expectedSeconds =
+        static_cast<double>(telemetry->getRemainingBytes()) /
+        bytesPerSec.value_or(defaultBytesPerSec);
     // choosing 3x of expected duration for PLDM firmware update timeout
-    return static_cast<uint16_t>((1 + updatableImagesize / bytesPerSec) * 3);
+    double reserveEidTimeOut = (1 + expectedSeconds) * 3;
+    return static_cast<uint16_t>(
+        std::clamp<double>(reserveEidTimeOut, minReserveEidTimeOut,
+                           std::numeric_limits<uint16_t>::max()));
 }
 
 void FWUpdate::cancelReserveBWTimer()
@@ -1970,16 +2254,105 @@ void FWUpdate::activateReserveBandwidth()
     });
 }
 
-int FWUpdate::runUpdate(const boost::asio::yield_context yield)
+/** @brief Check whether a firmware parameter holds the same value in two
+ * reads
+ */
+template <typename T>
+static bool samePropertyValue(const FWUProperties& oldProperties,
+                              const FWUProperties& newProperties,
+                              const std::string& name)
 {
-    compCount = pldmImg->getTotalCompCount();
-    int retVal = processRequestUpdate(yield);
-    if (retVal != PLDM_SUCCESS)
+    auto oldValue = oldProperties.find(name);
+    auto newValue = newProperties.find(name);
+    if (oldValue == oldProperties.end() || newValue == newProperties.end())
+    {
+        return oldValue == oldProperties.end() &&
+               newValue == newProperties.end();
+    }
+    const T* oldPtr = std::get_if<T>(&oldValue->second);
+    const T* newPtr = std::get_if<T>(&newValue->second);
+    return oldPtr && newPtr && *oldPtr == *newPtr;
+}
+
+/** @brief Check whether an active firmware version of an FD differs between
+ * two reads of its firmware parameters
+ */
+static bool activeVersionChanged(const FDProperties& before,
+                                 const FDProperties& after)
+{
+    if (!samePropertyValue<std::string>(std::get<0>(before),
+                                        std::get<0>(after),
+                                        "ActiveCompImgSetVerStr"))
+    {
+        return true;
+    }
+    const CompPropertiesMap& oldCompProperties = std::get<2>(before);
+    for (const auto& [comp, newProperties] : std::get<2>(after))
+    {
+        auto oldProperties = oldCompProperties.find(comp);
+        if (oldProperties == oldCompProperties.end() ||
+            !samePropertyValue<uint32_t>(oldProperties->second, newProperties,
+                                         "ActiveComponentComparisonStamp") ||
+            !samePropertyValue<std::string>(oldProperties->second,
+                                            newProperties,
+                                            "ActiveComponentVersionString"))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** @brief Re-read the firmware parameters of an updated FD and publish the
+ * versions that changed, without discovering the FD again
+ *
+ * @return false if the FD did not report its firmware parameters, or still
+ * reports the versions that were active before the update
+ */
+static bool refreshFirmwareInventory(const boost::asio::yield_context yield,
+                                     const pldm_tid_t tid)
+{
+    auto properties = terminusFwuProperties.find(tid);
+    auto interfaces = fwuIface.find(tid);
+    auto inventoryPath = inventoryPaths.find(tid);
+    if (properties == terminusFwuProperties.end() ||
+        interfaces == fwuIface.end() || inventoryPath == inventoryPaths.end())
+    {
+        return false;
+    }
+    FDProperties previousProperties = properties->second;
+    FWInventoryInfo inventoryInfo(tid);
+    if (!inventoryInfo.refreshFirmwareParameters(yield, inventoryPath->second,
+                                                 interfaces->second,
+                                                 properties->second))
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "Failed to refresh firmware inventory",
+            phosphor::logging::entry("TID=%d", tid));
+        return false;
+    }
+    if (!activeVersionChanged(previousProperties, properties->second))
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "Active firmware version unchanged after activation",
+            phosphor::logging::entry("TID=%d", tid));
+        return false;
+    }
+    return true;
+}
+
+int FWUpdate::runUpdate(const boost::asio::yield_context yield)
+{
+    compCount = pldmImg->getTotalCompCount();
+    telemetry->startPhase(FWUPhase::requestUpdate);
+    int retVal = processRequestUpdate(yield);
+    if (retVal != PLDM_SUCCESS)
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             "FD cannot be put in update mode");
         return retVal;
     }
+    telemetry->setTotalBytes(getApplicableComponentsSize());
     phosphor::logging::log<phosphor::logging::level::INFO>(
         "RequestUpdate command is success");
     updateMode = true;
@@ -2006,6 +2379,7 @@ int FWUpdate::runUpdate(const boost::asio::yield_context yield)
         return retVal;
     }
 
+    telemetry->startPhase(FWUPhase::passComponentTable);
     retVal = processPassComponentTable(yield);
     if (retVal != PLDM_SUCCESS)
     {
@@ -2013,6 +2387,14 @@ int FWUpdate::runUpdate(const boost::asio::yield_context yield)
             "runUpdate: processPassComponentTable failed");
         return retVal;
     }
+    // Validation ran alongside the handshakes, transfer nothing if it failed
+    if (!packageValidator->wait(yield))
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "runUpdate: Package validation failed",
+            phosphor::logging::entry("TID=%d", currentTid));
+        return PLDM_ERROR;
+    }
     phosphor::logging::log<phosphor::logging::level::INFO>(
         "PassComponentTable command is success");
     fdState = FD_READY_XFER;
@@ -2034,6 +2416,9 @@ int FWUpdate::runUpdate(const boost::asio::yield_context yield)
             continue;
         }
 
+        telemetry->startPhase(FWUPhase::download);
+        telemetry->startComponent();
+        fwDataAckedOffset = 0;
         retVal = processUpdateComponent(
             yield, compCompatabilityResp, compCompatabilityRespCode,
             updateOptFlagsEnabled, estimatedTimeReqFd);
@@ -2072,9 +2457,12 @@ int FWUpdate::runUpdate(const boost::asio::yield_context yield)
         uint8_t transferResult = 0;
         uint8_t applyResult = 0;
         bitfield16_t compActivationMethodsModification = {};
-        expectedCmd = PLDM_REQUEST_FIRMWARE_DATA;
 
         retVal = processRequestFirmwareData(yield);
+        if (retVal == PLDM_ERROR_NOT_READY)
+        {
+            retVal = resumeComponentDownload(yield);
+        }
         if (retVal != PLDM_SUCCESS)
         {
             phosphor::logging::log<phosphor::logging::level::WARNING>(
@@ -2125,18 +2513,15 @@ int FWUpdate::runUpdate(const boost::asio::yield_context yield)
         phosphor::logging::log<phosphor::logging::level::DEBUG>(
             "FD changed state to VERIFY");
 
-        expectedCmd = PLDM_VERIFY_COMPLETE;
-
-        startTimer(yield, fdCmdTimeout);
+        telemetry->startPhase(FWUPhase::verify);
 
-        if (!fdReqMatched)
+        if (!waitForFDRequest(yield, PLDM_VERIFY_COMPLETE, fdCmdTimeout))
         {
             phosphor::logging::log<phosphor::logging::level::WARNING>(
                 "Timeout waiting for Verify complete",
                 phosphor::logging::entry("COMPONENT=%d", count));
             continue;
         }
-        fdReqMatched = false;
         retVal = processVerifyComplete(yield, fdReq, verifyResult);
         if (retVal != PLDM_SUCCESS)
         {
@@ -2165,11 +2550,9 @@ int FWUpdate::runUpdate(const boost::asio::yield_context yield)
         phosphor::logging::log<phosphor::logging::level::DEBUG>(
             "FD changed state to APPLY");
 
-        expectedCmd = PLDM_APPLY_COMPLETE;
+        telemetry->startPhase(FWUPhase::apply);
 
-        startTimer(yield, fdCmdTimeout);
-
-        if (!fdReqMatched)
+        if (!waitForFDRequest(yield, PLDM_APPLY_COMPLETE, fdCmdTimeout))
         {
             phosphor::logging::log<phosphor::logging::level::WARNING>(
                 ("Timeout waiting for Apply complete. COMPONENT: " +
@@ -2178,7 +2561,6 @@ int FWUpdate::runUpdate(const boost::asio::yield_context yield)
 
             continue;
         }
-        fdReqMatched = false;
         retVal = processApplyComplete(yield, fdReq, applyResult,
                                       compActivationMethodsModification);
         if (retVal != PLDM_SUCCESS)
@@ -2200,11 +2582,9 @@ int FWUpdate::runUpdate(const boost::asio::yield_context yield)
         phosphor::logging::log<phosphor::logging::level::DEBUG>(
             "FD changed state to READY XFER");
     }
-    // TODO: The FD can send this command when it is in any state, except the
-    // IDLE and LEARN COMPONENTS state. we need to note a limitation that FD
-    // cannot send this command when UA(BMC) is acting as requester and if FD
-    // present behind the MUX. In this patch we support send matadata command
-    // only after apply complete command.
+    // The FD can send GetMetaData in any state except IDLE and LEARN
+    // COMPONENTS. Requests sent before ApplyComplete are answered by
+    // dispatchFDRequest, the transfer is expected here at the latest.
 
     if (fwDeviceMetaDataLen != 0)
     {
@@ -2236,6 +2616,7 @@ int FWUpdate::runUpdate(const boost::asio::yield_context yield)
         return PLDM_ERROR;
     }
 
+    telemetry->startPhase(FWUPhase::activate);
     bool8_t selfContainedActivationReq = true;
     uint16_t estimatedTimeForSelfContainedActivation = 0;
     retVal = processActivateFirmware(yield, selfContainedActivationReq,
@@ -2256,46 +2637,28 @@ int FWUpdate::runUpdate(const boost::asio::yield_context yield)
          std::to_string(currentTid))
             .c_str());
 
-    constexpr int bufferTimeMilliSec = 1000;
-    startTimer(yield, bufferTimeMilliSec + selfContainedActivationReq);
-    triggerDeviceDiscovery(currentTid);
-
-    return PLDM_SUCCESS;
-}
-
-template <typename propertyType>
-void FWUpdate::updateFWUProperty(const boost::asio::yield_context yield,
-                                 const std::string& interfaceName,
-                                 const std::string& propertyName,
-                                 const propertyType& propertyValue)
-{
-    auto bus = getSdBus();
-    boost::system::error_code ec;
-    // pldm image filename from image path
-    std::string pldm_image =
-        std::filesystem::path(pldmImg->getImagePath()).parent_path().filename();
-    std::string objPath = "/xyz/openbmc_project/software/" + pldm_image;
-
-    bus->yield_method_call<>(
-        yield, ec, "xyz.openbmc_project.Software.BMC.Updater", objPath,
-        "org.freedesktop.DBus.Properties", "Set", interfaceName, propertyName,
-        std::variant<std::decay_t<decltype(propertyValue)>>(propertyValue));
-    if (ec)
+    // Simulated FDs have no inventory
+    if (dryRun)
     {
-        phosphor::logging::log<phosphor::logging::level::ERR>(
-            ("Firmware update property updation failed. PROPERTY: " +
-             propertyName)
-                .c_str());
+        return PLDM_SUCCESS;
+    }
+    // The inventory is refreshed once the FD is back to IDLE. An FD that does
+    // not get there in time, e.g. while it resets, or that still reports the
+    // versions active before the update, is discovered again instead.
+    if (!waitForActivation(yield, estimatedTimeForSelfContainedActivation) ||
+        !refreshFirmwareInventory(yield, currentTid))
+    {
+        triggerDeviceDiscovery(currentTid);
     }
+
+    return PLDM_SUCCESS;
 }
 
 void FWUpdate::compUpdateProgress(const boost::asio::yield_context yield)
 {
-    uint8_t compUpdateProgress =
+    updateProgress =
         static_cast<uint8_t>(((currentComp + 1) * 100) / (compCount));
-    fwUpdate->updateFWUProperty(
-        yield, "xyz.openbmc_project.Software.ActivationProgress", "Progress",
-        compUpdateProgress);
+    updateActivationProgress(yield);
 }
 
 void pldmMsgRecvFwUpdCallback(const pldm_tid_t tid, const uint8_t msgTag,
@@ -2307,10 +2670,12 @@ void pldmMsgRecvFwUpdCallback(const pldm_tid_t tid, const uint8_t msgTag,
         phosphor::logging::entry("TID=0x%X", tid));
     // pldmImg points to null if FW update is not in progress at this point
     // firmware device should not send any firmware update commands
-    if (!pldmImg || !fwUpdate)
+    auto session = fwUpdateSessions.find(tid);
+    if (!pldmImg || session == fwUpdateSessions.end())
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
-            "Firmware update is not in process, command not excepted");
+            "Firmware update is not in process, command not excepted",
+            phosphor::logging::entry("TID=%d", tid));
         return;
     }
     if (!tagOwner)
@@ -2319,7 +2684,7 @@ void pldmMsgRecvFwUpdCallback(const pldm_tid_t tid, const uint8_t msgTag,
             "MCTP Tag Owner is not set, dropping unexpected packet");
         return;
     }
-    fwUpdate->validateReqForFWUpdCmd(tid, msgTag, message);
+    session->second->validateReqForFWUpdCmd(tid, msgTag, message);
     return;
 }
 
@@ -2356,6 +2721,7 @@ bool deleteFWDevice(const pldm_tid_t tid)
         return false;
     }
     terminusFwuProperties.erase(itr);
+    fwuTelemetry.erase(tid);
 
     if (fwuIface.erase(tid) == 0)
     {
@@ -2383,112 +2749,687 @@ bool deleteFWDevice(const pldm_tid_t tid)
     return true;
 }
 
-static bool updateMode = false;
+/** @brief Run the queued update sessions of a contention domain after
+ * another, then move on to the next domain. Several runners take domains from
+ * the same queue, thus each domain has one session in progress, which holds
+ * the bandwidth of the domain, and the number of runners bounds the domains
+ * updated at a time.
+ */
+static void
+    runUpdateSessions(const boost::asio::yield_context yield,
+                      std::deque<std::deque<FWUpdate*>>& pendingDomains,
+                      bool& fwUpdateStatus)
+{
+    while (!pendingDomains.empty())
+    {
+        std::deque<FWUpdate*> domainSessions =
+            std::move(pendingDomains.front());
+        pendingDomains.pop_front();
+        for (FWUpdate* session : domainSessions)
+        {
+            int retVal = session->runUpdate(yield);
+            if (retVal != PLDM_SUCCESS)
+            {
+                phosphor::logging::log<phosphor::logging::level::ERR>(
+                    ("runUpdate failed for TID: " +
+                     std::to_string(session->getTid()) +
+                     ". RETVAL:" + std::to_string(retVal))
+                        .c_str());
+                fwUpdateStatus = false;
+                session->terminateFwUpdate(yield);
+            }
+            session->finishTelemetry(retVal == PLDM_SUCCESS);
+        }
+    }
+}
+
+/** @brief Components applicable to any of the matched termini*/
+static std::vector<FWUComponentRange> getApplicableComponentRanges()
+{
+    ApplicableComponents applicable;
+    for (const auto& it : pldmImg->getMatchedTermini())
+    {
+        if (const PkgDeviceIDRecord* record =
+                pldmImg->getDeviceIDRecord(it.first))
+        {
+            applicable |= record->applicableComponents;
+        }
+    }
+
+    std::vector<FWUComponentRange> components;
+    for (uint16_t comp = 0; comp < pldmImg->getTotalCompCount(); comp++)
+    {
+        if (applicable[comp])
+        {
+            const PkgComponent* pkgComponent = pldmImg->getComponent(comp);
+            components.push_back(
+                {comp, pkgComponent->locationOffset, pkgComponent->size});
+        }
+    }
+    return components;
+}
+
 static int initUpdate(const boost::asio::yield_context yield)
 {
-    if (updateMode)
+    if (!fwUpdateSessions.empty())
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "initUpdate: Cannot start firmware update. Firmware update is "
             "already in progress");
         return PLDM_ERROR;
     }
-    bool fwUpdateStatus = true;
     auto matchedTermini = pldmImg->getMatchedTermini();
+    // Termini of unknown contention domain are put together, in case they
+    // share a bus
+    std::map<ContentionDomain, std::deque<FWUpdate*>> domainSessions;
+    size_t sessionCount = 0;
     for (const auto& it : matchedTermini)
     {
         pldm_tid_t matchedTid = it.second;
         uint8_t matchedDevIdRecord = it.first;
-        fwUpdate = std::make_unique<FWUpdate>(matchedTid, matchedDevIdRecord);
-        if (!fwUpdate->setMatchedFDDescriptors())
+        if (fwUpdateSessions.count(matchedTid) != 0)
         {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                ("initUpdate: Failed to set TargetFDProperties for "
+            phosphor::logging::log<phosphor::logging::level::WARNING>(
+                ("initUpdate: More than one device ID record matched for "
                  "TID: " +
                  std::to_string(matchedTid))
                     .c_str());
             continue;
         }
-        pldm::platform::pauseSensorPolling();
-        int retVal = fwUpdate->runUpdate(yield);
-        if (retVal != PLDM_SUCCESS)
+        auto session =
+            std::make_unique<FWUpdate>(matchedTid, matchedDevIdRecord);
+        if (!session->setMatchedFDDescriptors())
         {
             phosphor::logging::log<phosphor::logging::level::ERR>(
-                ("runUpdate failed for TID: " + std::to_string(matchedTid) +
-                 ". RETVAL:" + std::to_string(retVal))
+                ("initUpdate: Failed to set TargetFDProperties for "
+                 "TID: " +
+                 std::to_string(matchedTid))
                     .c_str());
-            fwUpdateStatus = false;
-            fwUpdate->terminateFwUpdate(yield);
+            continue;
         }
+        ContentionDomain domain =
+            getContentionDomain(matchedTid).value_or(ContentionDomain{});
+        domainSessions[domain].push_back(session.get());
+        sessionCount++;
+        fwUpdateSessions.emplace(matchedTid, std::move(session));
+    }
+    std::deque<std::deque<FWUpdate*>> pendingDomains;
+    for (auto& it : domainSessions)
+    {
+        pendingDomains.push_back(std::move(it.second));
+    }
+
+    bool fwUpdateStatus = true;
+    size_t activeRunners =
+        std::min<size_t>(maxParallelUpdates, pendingDomains.size());
+    boost::asio::steady_timer runnersDone(
+        *getIoContext(), boost::asio::steady_timer::time_point::max());
+    phosphor::logging::log<phosphor::logging::level::INFO>(
+        ("Updating " + std::to_string(sessionCount) + " termini on " +
+         std::to_string(pendingDomains.size()) + " buses, " +
+         std::to_string(activeRunners) + " buses at a time")
+            .c_str());
+
+    if (!dryRun)
+    {
+        pldm::platform::pauseSensorPolling();
+    }
+    for (size_t runner = activeRunners; runner > 0; runner--)
+    {
+        // Locals outlive the runners as this coroutine waits for all of them
+        boost::asio::spawn(
+            *getIoContext(), [&](boost::asio::yield_context runnerYield) {
+                runUpdateSessions(runnerYield, pendingDomains,
+                                  fwUpdateStatus);
+                if (--activeRunners == 0)
+                {
+                    runnersDone.cancel();
+                }
+            });
+    }
+    while (activeRunners > 0)
+    {
+        boost::system::error_code ec;
+        runnersDone.async_wait(yield[ec]);
+    }
+    if (!dryRun)
+    {
         pldm::platform::resumeSensorPolling();
-        updateMode = false;
     }
 
     if (!fwUpdateStatus)
     {
-        fwUpdate->updateFWUProperty(
+        updateFWUProperty(
             yield, "xyz.openbmc_project.Software.Activation", "Activation",
             "xyz.openbmc_project.Software.Activation.Activations.Failed");
     }
     else
     {
-        fwUpdate->updateFWUProperty(
+        updateFWUProperty(
             yield, "xyz.openbmc_project.Software.Activation", "Activation",
             "xyz.openbmc_project.Software.Activation.Activations.Active");
     }
+    fwUpdateSessions.clear();
     return PLDM_SUCCESS;
 }
 
+/** @brief Simulate an FD for each device ID record of pldmImg. The FD
+ * identifies by the descriptors of the record and takes the components
+ * applicable to it.
+ *
+ * @return false if no FD matches the package
+ */
+static bool addSimulatedDevices()
+{
+    TIDMapper::TIDMap tidMap = tidMapper.getTIDMap();
+    pldm_tid_t tid = firstSimulatedTid;
+    for (uint8_t index = 0; index < pldmImg->getDevIDRecordCount(); index++)
+    {
+        while (tid > 0 && (tidMap.count(tid) != 0 ||
+                           terminusFwuProperties.count(tid) != 0))
+        {
+            tid--;
+        }
+        if (tid == 0)
+        {
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                "No TID left for the simulated FDs");
+            return false;
+        }
+        const PkgDeviceIDRecord* record = pldmImg->getDeviceIDRecord(index);
+        std::set<FWUSimulatedDevice::ComponentKey> components;
+        for (uint16_t comp = 0; comp < pldmImg->getTotalCompCount(); comp++)
+        {
+            if (record->applicableComponents[comp])
+            {
+                const PkgComponent* pkgComponent = pldmImg->getComponent(comp);
+                components.emplace(pkgComponent->classification,
+                                   pkgComponent->identifier);
+            }
+        }
+        auto device = std::make_shared<FWUSimulatedDevice>(
+            tid, record->descriptors, std::move(components), simulationConfig);
+        simulatedFwuProperties.emplace(tid, device->getProperties());
+        simulatedDevices.emplace(tid, device);
+        addSimulatedTerminus(tid, device);
+        tid--;
+    }
+    return pldmImg->matchTermini(simulatedFwuProperties);
+}
+
+/** @brief Stop the simulated FDs and end the dry run*/
+static void removeSimulatedDevices()
+{
+    for (const auto& it : simulatedDevices)
+    {
+        it.second->stop();
+        removeSimulatedTerminus(it.first);
+        fwuTelemetry.erase(it.first);
+        FWUTelemetry::forgetObservedThroughput(it.first);
+    }
+    simulatedDevices.clear();
+    simulatedFwuProperties.clear();
+    dryRun = false;
+}
+
+/** @brief Publish duration and throughput of the dry run that just ended
+ *
+ * @param elapsed[in] - Time the update sessions took
+ */
+static void
+    publishDryRunResult(const std::chrono::steady_clock::duration elapsed)
+{
+    uint64_t transferredBytes = 0;
+    bool succeeded = !simulatedDevices.empty();
+    for (const auto& it : simulatedDevices)
+    {
+        transferredBytes += it.second->getReceivedBytes();
+        succeeded = succeeded && it.second->isActivated();
+    }
+    uint64_t durationMs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(elapsed)
+            .count());
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    double bytesPerSecond =
+        seconds > 0 ? static_cast<double>(transferredBytes) / seconds : 0;
+    std::string result = succeeded ? "Succeeded" : "Failed";
+
+    dryRunIface->set_property("DurationMilliseconds", durationMs);
+    dryRunIface->set_property("TransferredBytes", transferredBytes);
+    dryRunIface->set_property("BytesPerSecond", bytesPerSecond);
+    dryRunIface->set_property("Result", result);
+    phosphor::logging::log<phosphor::logging::level::INFO>(
+        ("Dry run " + result + ". FDs: " +
+         std::to_string(simulatedDevices.size()) +
+         ", duration ms: " + std::to_string(durationMs) +
+         ", bytes: " + std::to_string(transferredBytes) +
+         ", bytes per second: " + std::to_string(bytesPerSecond))
+            .c_str());
+}
+
+/** @brief Read the component digests a package is expected to have from
+ * the file next to it, named as the package with ".digests" appended. Each
+ * line holds a component index and its CRC-32 in hex, e.g. "0 1a2b3c4d".
+ *
+ * @return Digests, empty if there is no such file. std::nullopt if the file
+ * is malformed.
+ */
+static std::optional<FWUComponentDigests>
+    readComponentDigests(const std::string& filePath)
+{
+    FWUComponentDigests digests;
+    std::ifstream digestFile(filePath + ".digests");
+    if (!digestFile)
+    {
+        return digests;
+    }
+    uint32_t index = 0;
+    uint32_t digest = 0;
+    while (digestFile >> std::dec >> index >> std::hex >> digest)
+    {
+        if (index > std::numeric_limits<uint16_t>::max() ||
+            !digests.emplace(static_cast<uint16_t>(index), digest).second)
+        {
+            break;
+        }
+    }
+    if (!digestFile.eof())
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Invalid component digests of the package",
+            phosphor::logging::entry("PLDM_IMAGE=%s", filePath.c_str()));
+        return std::nullopt;
+    }
+    return digests;
+}
+
+/** @brief Open a package and check its header, ready to update from it. In a
+ * dry run the package is matched against simulated FDs instead of the
+ * termini.
+ *
+ * @param filePath[in] - Package
+ * @param expectedDigests[in] - CRC-32 the components of this package must
+ * have. Discarded with the package once the update ends.
+ *
+ * @return false if the package cannot be used
+ */
+static bool loadPackage(const std::string& filePath,
+                        FWUComponentDigests expectedDigests)
+{
+    try
+    {
+        pldmImg = std::make_unique<PLDMImg>(filePath);
+    }
+    catch (const std::exception&)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Failed to process pldm image",
+            phosphor::logging::entry("PLDM_IMAGE=%s", filePath.c_str()));
+        return false;
+    }
+    bool headerProcessed = dryRun
+                               ? pldmImg->parsePkgHdr() && addSimulatedDevices()
+                               : pldmImg->processPkgHdr();
+    if (!headerProcessed)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "processPkgHdr: Failed");
+        pldmImg = nullptr;
+        return false;
+    }
+    chunkCache = std::make_unique<FWUChunkCache>(*pldmImg, fwDataWindowSize,
+                                                 fwDataRecentWindows);
+    packageValidator = std::make_unique<FWUPackageValidator>(
+        *pldmImg, getApplicableComponentRanges(), std::move(expectedDigests));
+    packageValidator->start();
+    return true;
+}
+
+/** @brief Update the matched termini from the loaded package, then unload
+ * it
+ */
+static void runPackageUpdate(boost::asio::yield_context yield)
+{
+    auto started = std::chrono::steady_clock::now();
+    int ret = initUpdate(yield);
+    if (ret != PLDM_SUCCESS)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "StartFWUpdate: initUpdate failed.");
+    }
+    if (dryRun)
+    {
+        publishDryRunResult(std::chrono::steady_clock::now() - started);
+        removeSimulatedDevices();
+    }
+    phosphor::logging::log<phosphor::logging::level::INFO>(
+        ("Package windows read: " + std::to_string(chunkCache->getMisses()) +
+         ", served from cache: " + std::to_string(chunkCache->getHits()))
+            .c_str());
+    // The validator reads pldmImg till it is done
+    packageValidator->wait(yield);
+    packageValidator = nullptr;
+    chunkCache = nullptr;
+    pldmImg = nullptr;
+}
+
+/** @brief Copy a package into the staging directory of its software image
+ *
+ * @param packageFd[in] - Package, either a stream or a file. Closed when
+ * staged.
+ * @param imageId[in] - Software image the package belongs to
+ *
+ * @return Staged package, std::nullopt if it cannot be staged
+ */
+static std::optional<std::string> stagePackage(boost::asio::yield_context yield,
+                                               const int packageFd,
+                                               const std::string& imageId)
+{
+    std::error_code ec;
+    std::filesystem::path stagingDir =
+        std::filesystem::path(fwuStagingDir) / imageId;
+    std::filesystem::create_directories(stagingDir, ec);
+    std::string stagingFile = stagingDir / "package.pldm";
+    bool staged = false;
+    std::filesystem::space_info stagingSpace{};
+    if (!ec)
+    {
+        stagingSpace = std::filesystem::space(stagingDir, ec);
+    }
+    if (ec)
+    {
+        close(packageFd);
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Unable to create staging directory",
+            phosphor::logging::entry("PATH=%s", stagingDir.c_str()));
+    }
+    else if (stagingSpace.available <= stagingFreeSpaceMargin)
+    {
+        close(packageFd);
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "No space left to stage the package",
+            phosphor::logging::entry("PATH=%s", stagingDir.c_str()));
+    }
+    else
+    {
+        FWUPackageStager stager(packageFd, stagingFile,
+                                stagingSpace.available -
+                                    stagingFreeSpaceMargin);
+        staged = stager.stage(yield);
+    }
+    if (!staged)
+    {
+        std::filesystem::remove_all(stagingDir, ec);
+        return std::nullopt;
+    }
+    return stagingFile;
+}
+
+/** @brief Remove a package staged by stagePackage*/
+static void removeStagedPackage(const std::string& stagingFile)
+{
+    std::error_code ec;
+    std::filesystem::remove_all(
+        std::filesystem::path(stagingFile).parent_path(), ec);
+}
+
+/** @brief Stage a package streamed from an fd, then update from it
+ *
+ * @param packageFd[in] - Stream of the package, closed when staged
+ * @param imageId[in] - Software image the package belongs to
+ * @param expectedDigests[in] - CRC-32 the components of the package must have
+ */
+static void stageAndRunPackageUpdate(boost::asio::yield_context yield,
+                                     const int packageFd,
+                                     const std::string& imageId,
+                                     FWUComponentDigests expectedDigests)
+{
+    std::optional<std::string> stagingFile =
+        stagePackage(yield, packageFd, imageId);
+    packageStaging = false;
+    if (!stagingFile)
+    {
+        return;
+    }
+
+    if (!pldmImg && loadPackage(*stagingFile, std::move(expectedDigests)))
+    {
+        runPackageUpdate(yield);
+    }
+    removeStagedPackage(*stagingFile);
+}
+
+/** @brief Stage a package given by its path and load it
+ *
+ * The package is updated from a staged copy, the file given may be replaced
+ * or truncated meanwhile. The software image is the directory holding the
+ * package.
+ *
+ * @return Staged package, std::nullopt if it cannot be staged or loaded
+ */
+static std::optional<std::string>
+    stageAndLoadPackage(boost::asio::yield_context yield,
+                        const std::string& filePath)
+{
+    std::optional<FWUComponentDigests> digests =
+        readComponentDigests(filePath);
+    if (!digests)
+    {
+        return std::nullopt;
+    }
+    std::filesystem::path packagePath(filePath);
+    std::string imageId = packagePath.parent_path().filename();
+    if (imageId.empty() || imageId == "." || imageId == "..")
+    {
+        imageId = packagePath.filename();
+    }
+    int packageFd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (packageFd < 0)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Unable to open pldm image",
+            phosphor::logging::entry("PLDM_IMAGE=%s", filePath.c_str()));
+        return std::nullopt;
+    }
+
+    packageStaging = true;
+    std::optional<std::string> stagingFile =
+        stagePackage(yield, packageFd, imageId);
+    packageStaging = false;
+    if (!stagingFile)
+    {
+        return std::nullopt;
+    }
+    if (pldmImg || !loadPackage(*stagingFile, std::move(*digests)))
+    {
+        removeStagedPackage(*stagingFile);
+        return std::nullopt;
+    }
+    return stagingFile;
+}
+
+/** @brief Remove the packages left staged by a previous run, e.g. one that
+ * crashed or lost power while staging or updating
+ */
+static void removeStaleStagedPackages()
+{
+    std::error_code ec;
+    size_t removedCount = 0;
+    for (const auto& entry :
+         std::filesystem::directory_iterator(fwuStagingDir, ec))
+    {
+        std::error_code removeEc;
+        std::filesystem::remove_all(entry.path(), removeEc);
+        if (removeEc)
+        {
+            phosphor::logging::log<phosphor::logging::level::WARNING>(
+                "Unable to remove stale staged package",
+                phosphor::logging::entry("PATH=%s", entry.path().c_str()));
+            continue;
+        }
+        removedCount++;
+    }
+    if (removedCount != 0)
+    {
+        phosphor::logging::log<phosphor::logging::level::INFO>(
+            "Removed stale staged packages",
+            phosphor::logging::entry("COUNT=%zu", removedCount));
+    }
+}
+
 static bool fwuBaseInitialized = false;
 static void initializeFWUBase()
 {
     std::string objPath = "/xyz/openbmc_project/pldm/fwu";
-    expectedCommandTimer =
-        std::make_shared<boost::asio::steady_timer>(*getIoContext());
     auto objServer = getObjServer();
     auto fwuBaseIface = objServer->add_interface(objPath, FWUBase::interface);
     fwuBaseIface->register_method(
-        "StartFWUpdate", [](const std::string filePath) {
-            int rc = -1;
-            if (pldmImg)
+        "StartFWUpdate",
+        [](boost::asio::yield_context yield, const std::string filePath) {
+            if (pldmImg || packageStaging)
             {
-                return rc;
+                return -1;
             }
             phosphor::logging::log<phosphor::logging::level::INFO>(
                 "StartFWUpdate is called");
-            try
+            std::optional<std::string> stagingFile =
+                stageAndLoadPackage(yield, filePath);
+            if (!stagingFile)
             {
-                pldmImg = std::make_unique<PLDMImg>(filePath);
-                if (!pldmImg->processPkgHdr())
-                {
-                    phosphor::logging::log<phosphor::logging::level::ERR>(
-                        "processPkgHdr: Failed");
-                }
-                else
-                {
-                    rc = 0;
-                }
+                return -1;
             }
-            catch (const std::exception&)
+            boost::asio::spawn(
+                *getIoContext(),
+                [stagingFile](boost::asio::yield_context yieldUpdate) {
+                    runPackageUpdate(yieldUpdate);
+                    removeStagedPackage(*stagingFile);
+                });
+            return 0;
+        });
+    fwuBaseIface->initialize();
+
+    auto policyIface = objServer->add_interface(
+        objPath, "xyz.openbmc_project.PLDM.FWU.UpdatePolicy");
+    policyIface->register_property(
+        "MaxParallelUpdates", maxParallelUpdates,
+        [](const uint8_t& req, uint8_t& propertyValue) -> int {
+            if (req == 0)
             {
-                phosphor::logging::log<phosphor::logging::level::ERR>(
-                    "Failed to process pldm image",
-                    phosphor::logging::entry("PLDM_IMAGE=%s",
-                                             filePath.c_str()));
-                return rc;
+                throw sdbusplus::exception::SdBusError(
+                    -EINVAL, "MaxParallelUpdates cannot be 0");
             }
-            boost::asio::spawn([](boost::asio::yield_context yield) {
-                int ret = initUpdate(yield);
-                if (ret != PLDM_SUCCESS)
-                {
-                    phosphor::logging::log<phosphor::logging::level::ERR>(
-                        "StartFWUpdate: initUpdate failed.");
-                }
-                pldmImg = nullptr;
-            });
-            return rc;
+            // Takes effect from the next StartFWUpdate
+            maxParallelUpdates = req;
+            propertyValue = req;
+            return 1;
         });
-    fwuBaseIface->initialize();
+    policyIface->register_property(
+        "MaxTransferSize", maxTransferSize,
+        [](const uint32_t& req, uint32_t& propertyValue) -> int {
+            if (req < PLDM_FWU_BASELINE_TRANSFER_SIZE)
+            {
+                throw sdbusplus::exception::SdBusError(
+                    -EINVAL, "MaxTransferSize is below the baseline");
+            }
+            if (req > maxTransferSizeLimit)
+            {
+                throw sdbusplus::exception::SdBusError(
+                    -EINVAL, "MaxTransferSize is above the limit");
+            }
+            // Takes effect from the next StartFWUpdate
+            maxTransferSize = req;
+            propertyValue = req;
+            return 1;
+        });
+    policyIface->initialize();
+
+    auto streamIface = objServer->add_interface(
+        objPath, "xyz.openbmc_project.PLDM.FWU.StreamUpdate");
+    streamIface->register_method(
+        "StartFWUpdateFromFd",
+        [](const sdbusplus::message::unix_fd& fd, const std::string& imageId,
+           const FWUComponentDigests& expectedDigests) {
+            if (imageId.empty() || imageId == "." || imageId == ".." ||
+                imageId.find('/') != std::string::npos)
+            {
+                throw sdbusplus::exception::SdBusError(-EINVAL,
+                                                       "Invalid image ID");
+            }
+            if (pldmImg || packageStaging)
+            {
+                return -1;
+            }
+            // The fd received is closed once the method returns
+            int packageFd = fcntl(fd.fd, F_DUPFD_CLOEXEC, 0);
+            if (packageFd < 0)
+            {
+                throw sdbusplus::exception::SdBusError(
+                    -errno, "Unable to duplicate firmware package fd");
+            }
+            phosphor::logging::log<phosphor::logging::level::INFO>(
+                "StartFWUpdateFromFd is called",
+                phosphor::logging::entry("IMAGE_ID=%s", imageId.c_str()));
+            packageStaging = true;
+            boost::asio::spawn(
+                *getIoContext(),
+                [packageFd, imageId,
+                 expectedDigests](boost::asio::yield_context yield) {
+                    stageAndRunPackageUpdate(yield, packageFd, imageId,
+                                             expectedDigests);
+                });
+            return 0;
+        });
+    streamIface->initialize();
+
+    dryRunIface = objServer->add_interface(
+        objPath, "xyz.openbmc_project.PLDM.FWU.DryRun");
+    dryRunIface->register_method(
+        "StartFWUpdate",
+        [](boost::asio::yield_context yield, const std::string filePath) {
+            if (pldmImg || packageStaging)
+            {
+                return -1;
+            }
+            phosphor::logging::log<phosphor::logging::level::INFO>(
+                "StartFWUpdate dry run is called");
+            dryRun = true;
+            std::optional<std::string> stagingFile =
+                stageAndLoadPackage(yield, filePath);
+            if (!stagingFile)
+            {
+                removeSimulatedDevices();
+                return -1;
+            }
+            boost::asio::spawn(
+                *getIoContext(),
+                [stagingFile](boost::asio::yield_context yieldUpdate) {
+                    runPackageUpdate(yieldUpdate);
+                    removeStagedPackage(*stagingFile);
+                });
+            return 0;
+        });
+    // Behaviour of the simulated FDs, takes effect from the next dry run
+    dryRunIface->register_property(
+        "ResponseLatency",
+        static_cast<uint16_t>(simulationConfig.latency.count()),
+        [](const uint16_t& req, uint16_t& propertyValue) -> int {
+            simulationConfig.latency = std::chrono::milliseconds(req);
+            propertyValue = req;
+            return 1;
+        });
+    dryRunIface->register_property(
+        "ErrorInterval", simulationConfig.errorInterval,
+        [](const uint32_t& req, uint32_t& propertyValue) -> int {
+            simulationConfig.errorInterval = req;
+            propertyValue = req;
+            return 1;
+        });
+    // Results of the last dry run
+    dryRunIface->register_property("DurationMilliseconds", uint64_t(0));
+    dryRunIface->register_property("TransferredBytes", uint64_t(0));
+    dryRunIface->register_property("BytesPerSecond", 0.0);
+    dryRunIface->register_property("Result", std::string("None"));
+    dryRunIface->initialize();
 }
 
 static void registerAssociationsProperty()
@@ -2514,6 +3455,7 @@ bool fwuInit(boost::asio::yield_context yield, const pldm_tid_t tid)
 
     if (!fwuBaseInitialized)
     {
+        removeStaleStagedPackages();
         initializeFWUBase();
         registerAssociationsProperty();
         fwuBaseInitialized = true;
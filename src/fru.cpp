@@ -15,8 +15,12 @@
  */
 #include "fru.hpp"
 
+#include "base.hpp"
+#include "fru_cache.hpp"
 #include "fru_support.hpp"
+#include "utils.hpp"
 
+#include <cstdint>
 #include <string>
 #include <xyz/openbmc_project/Inventory/Source/PLDM/FRU/server.hpp>
 
@@ -35,15 +39,25 @@ std::shared_ptr<sdbusplus::asio::dbus_interface> getFRUIface;
 std::vector<std::shared_ptr<sdbusplus::asio::dbus_interface>> fruInterface;
 
 static std::map<pldm_tid_t, FRUMetadata> terminusFRUMetadata;
-static std::map<pldm_tid_t, FRUProperties> terminusFRUProperties;
 
-// Fru record data is saved in byte format as it is received. This data is
-// used by GetPldmFRU method
-using FRUData = std::unordered_map<pldm_tid_t, std::vector<uint8_t>>;
+// Fru record data is saved in byte format as it is received, along with the
+// index of its records. Properties are decoded from it on demand. The table is
+// also used by GetPldmFRU method
+using FRUData = std::unordered_map<pldm_tid_t, PLDMFRUTable>;
 static FRUData fruData;
 
 constexpr size_t pldmHdrSize = sizeof(pldm_msg_hdr);
 constexpr size_t pldmFruBaselineTransferSize = 32;
+// SetFRU starts with the baseline chunk size and doubles it after every
+// acknowledged chunk up to this size
+constexpr size_t pldmFruMaxTransferSize = 1024;
+// Largest FRU record table accepted from a terminus. FRUTableLength is reported
+// by the device and sizes the table buffer, larger tables are discarded.
+constexpr size_t maxFRUTableLength = 64 * 1024;
+// Times a chunk is resent after a transport failure before giving up. Every
+// failure counts towards opening the circuit of the terminus, keep the
+// failures in a row below its threshold of three.
+constexpr size_t setFruResumeLimit = 1;
 
 // IpmiFru object is used to convert PLDM FRU to IPMI Format
 IpmiFru ipmiFru;
@@ -54,125 +68,38 @@ RedfishFru redfishFru;
 
 std::optional<FRUProperties> getProperties(const pldm_tid_t tid)
 {
-    auto it = terminusFRUProperties.find(tid);
-    if (it != terminusFRUProperties.end())
-    {
-        return it->second;
-    }
-    return std::nullopt;
-}
-
-bool PLDMFRUTable::parseFRUField(uint8_t recordType, uint8_t type,
-                                 uint8_t length, const uint8_t* value)
-{
-    if (value == NULL)
-    {
-        return false;
-    }
-    try
+    auto it = fruData.find(tid);
+    if (it == fruData.end())
     {
-        auto& [typeString, parser] = fruFieldTypes.at(recordType).at(type);
-        fruProperties[typeString] = parser(value, length);
+        return std::nullopt;
     }
-    catch (const std::out_of_range& e)
+    std::optional<FRURecordSetID> recordSetID =
+        it->second.getPrimaryRecordSetID();
+    if (!recordSetID)
     {
-        phosphor::logging::log<phosphor::logging::level::WARNING>(
-            "fruFieldTypes key not available in map",
-            phosphor::logging::entry("TID=%d", tid));
-        return false;
+        return std::nullopt;
     }
-
-    return true;
+    return it->second.getProperties(*recordSetID);
 }
 
-bool PLDMFRUTable::isTableEnd(const uint8_t* pTable)
+std::optional<FRUVariantType> getProperty(const pldm_tid_t tid,
+                                          const std::string& name)
 {
-    if (pTable == NULL)
+    auto it = fruData.find(tid);
+    if (it == fruData.end())
     {
-        return false;
+        return std::nullopt;
     }
-    constexpr size_t fixedFRUBytes = 7;
-    if (pTable < table.data())
+    std::optional<FRURecordSetID> recordSetID =
+        it->second.getPrimaryRecordSetID();
+    if (!recordSetID)
     {
-        return false;
-    }
-    auto offset = pTable - table.data();
-    return (table.size() - offset) <= fixedFRUBytes;
-}
-
-std::optional<FRUProperties> PLDMFRUTable::parseTable()
-{
-    const uint8_t* pTable = table.data();
-    while (!isTableEnd(pTable))
-    {
-        auto record =
-            reinterpret_cast<const pldm_fru_record_data_format*>(pTable);
-        uint16_t recordSetID = le16toh(record->record_set_id);
-        std::string recordType =
-            typeToString(fruRecordTypes, record->record_type);
-        uint8_t fruFieldNum = static_cast<uint8_t>(record->num_fru_fields);
-        std::string encodeType =
-            typeToString(fruEncodingType, record->encoding_type);
-
-        phosphor::logging::log<phosphor::logging::level::INFO>(
-            "FRU Record Set Identifier",
-            phosphor::logging::entry("REC_SET_ID=%d", recordSetID));
-        phosphor::logging::log<phosphor::logging::level::INFO>(
-            "FRU Record Type",
-            phosphor::logging::entry("REC_TYPE=%s", recordType.c_str()));
-        phosphor::logging::log<phosphor::logging::level::INFO>(
-            "FRU field number",
-            phosphor::logging::entry("FRU_FIELD_NUM=%d", fruFieldNum));
-        phosphor::logging::log<phosphor::logging::level::INFO>(
-            "FRU Encode Type",
-            phosphor::logging::entry("FRU_ENCODE_TYPE=%s", encodeType.c_str()));
-
-        if (fruFieldNum < 1)
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "Number of FRU fields cannot be 0.");
-            return std::nullopt;
-        }
-
-        auto isGeneralRec = false;
-        if (record->record_type == PLDM_FRU_RECORD_TYPE_GENERAL)
-        {
-            isGeneralRec = true;
-        }
-
-        pTable +=
-            sizeof(pldm_fru_record_data_format) - sizeof(pldm_fru_record_tlv);
-        for (int i = 0; i < record->num_fru_fields; i++)
-        {
-            auto tlv = reinterpret_cast<const pldm_fru_record_tlv*>(pTable);
-            if (isGeneralRec)
-            {
-                if (!parseFRUField(record->record_type, tlv->type, tlv->length,
-                                   tlv->value))
-                {
-                    phosphor::logging::log<phosphor::logging::level::WARNING>(
-                        "Failed to parse fru fields",
-                        phosphor::logging::entry("TID=%d", tid));
-                }
-            }
-            pTable += sizeof(pldm_fru_record_tlv) - 1 + tlv->length;
-        }
+        return std::nullopt;
     }
-    return fruProperties;
-}
-
-PLDMFRUTable::PLDMFRUTable(const std::vector<uint8_t> tableVal,
-                           const pldm_tid_t tidVal) :
-    table(tableVal),
-    tid(tidVal)
-{
-}
-
-PLDMFRUTable::~PLDMFRUTable()
-{
+    return it->second.getProperty(*recordSetID, name);
 }
 
-bool GetPLDMFRU::verifyCRC(std::vector<uint8_t>& fruTable)
+bool GetPLDMFRU::verifyCRC(const uint32_t checksum)
 {
     auto crcFound = fruMetadata.find("Checksum");
     if (crcFound == fruMetadata.end())
@@ -183,18 +110,6 @@ bool GetPLDMFRU::verifyCRC(std::vector<uint8_t>& fruTable)
         return false;
     }
 
-    constexpr size_t mod = 4;
-    size_t numPadBytes = 0;
-    if (fruTable.size() % mod)
-    {
-        numPadBytes = mod - (fruTable.size() % mod);
-    }
-
-    // fill padding with zeros
-    fruTable.resize(fruTable.size() + numPadBytes);
-
-    uint32_t checksum = crc32(fruTable.data(), fruTable.size());
-
     if (crcFound->second != checksum)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
@@ -207,16 +122,31 @@ bool GetPLDMFRU::verifyCRC(std::vector<uint8_t>& fruTable)
     return true;
 }
 
+// Fru record data is saved in byte format as it is received. This data is
+// used by GetPldmFRU method
+static void saveFRUData(const pldm_tid_t tid, PLDMFRUTable&& fruTable)
+{
+    auto it = fruData.find(tid);
+    if (it != fruData.end())
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            ("PLDM FRU device already exist for TID " + std::to_string(tid))
+                .c_str());
+        fruData.erase(it);
+    }
+    fruData.emplace(tid, std::move(fruTable));
+}
+
 static bool addFRUObjectToDbus(const std::string& fruObjPath,
                                const pldm_tid_t tid,
-                               FRUProperties& fruProperties)
+                               const FRUProperties& fruProperties)
 {
     auto objServer = getObjServer();
     std::shared_ptr<sdbusplus::asio::dbus_interface> fruIface =
         objServer->add_interface(fruObjPath, FRU::interface);
 
     std::string propertyVal = "";
-    for (auto i : fruProperties)
+    for (const auto& i : fruProperties)
     {
         try
         {
@@ -238,7 +168,31 @@ static bool addFRUObjectToDbus(const std::string& fruObjPath,
     return true;
 }
 
-int GetPLDMFRU::getFRURecordTableCmd(FRUProperties& fruProperties)
+// Primary record set is exposed on the TID object and the rest of the record
+// sets on child objects named by Record Set Identifier
+static void addFRUObjectsToDbus(const pldm_tid_t tid,
+                                const PLDMFRUTable& fruTable)
+{
+    std::optional<FRURecordSetID> primaryRecordSetID =
+        fruTable.getPrimaryRecordSetID();
+    std::string tidFRUObjPath = fruPath + std::to_string(tid);
+    for (FRURecordSetID recordSetID : fruTable.getRecordSetIDs())
+    {
+        if (recordSetID == primaryRecordSetID)
+        {
+            addFRUObjectToDbus(tidFRUObjPath, tid,
+                               fruTable.getProperties(recordSetID));
+        }
+        else
+        {
+            addFRUObjectToDbus(tidFRUObjPath + "/" +
+                                   std::to_string(recordSetID),
+                               tid, fruTable.getProperties(recordSetID));
+        }
+    }
+}
+
+int GetPLDMFRU::getFRURecordTableCmd()
 {
     uint32_t dataTransferHandle = 0;
     uint8_t transferOperationFlag = PLDM_GET_FIRSTPART;
@@ -248,21 +202,43 @@ int GetPLDMFRU::getFRURecordTableCmd(FRUProperties& fruProperties)
     uint8_t transferFlag = 0;
     uint32_t nextDataTransferHandle = 0;
     size_t fruRecordTableLen = 0;
-    std::vector<uint8_t> fruRecordTableData = {};
 
+    auto fruTableLen = fruMetadata.find("FRUTableLength");
+    if (fruTableLen == fruMetadata.end())
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "GetFruRecordTable: No FRUTableLength available in "
+            "metadata",
+            phosphor::logging::entry("TID=%d", tid));
+        return PLDM_ERROR;
+    }
+
+    const size_t fruTableLength = fruTableLen->second;
+    if (fruTableLength > maxFRUTableLength)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "GetFruRecordTable: FRUTableLength exceeds the supported size",
+            phosphor::logging::entry("TID=%d", tid),
+            phosphor::logging::entry("LENGTH=%zu", fruTableLength),
+            phosphor::logging::entry("MAX_LENGTH=%zu", maxFRUTableLength));
+        return PLDM_ERROR;
+    }
+
+    // Parts are decoded directly into the table, which is allocated once.
+    // Space for CRC-32 padding is zero filled up front.
+    constexpr size_t mod = 4;
+    static_assert(maxFRUTableLength <= SIZE_MAX - (mod - 1),
+                  "Padded FRU record table size overflows size_t");
+    std::vector<uint8_t> fruRecordTableData(fruTableLength + mod - 1);
+    size_t receivedLen = 0;
+    utils::Crc32 checksum;
+
+    std::vector<uint8_t> requestMsg(pldmHdrSize +
+                                    PLDM_GET_FRU_RECORD_TABLE_REQ_BYTES);
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
     while (transferFlag != PLDM_END && transferFlag != PLDM_START_AND_END)
     {
-        auto fruTableLen = fruMetadata.find("FRUTableLength");
-        if (fruTableLen == fruMetadata.end())
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "GetFruRecordTable: No FRUTableLength available in "
-                "metadata",
-                phosphor::logging::entry("TID=%d", tid));
-            return PLDM_ERROR;
-        }
-        if (fruRecordTableData.size() > fruTableLen->second ||
-            !(--multipartTransferLimit))
+        if (!(--multipartTransferLimit))
         {
             phosphor::logging::log<phosphor::logging::level::WARNING>(
                 "Max FRU record table length limit reached. Discarding the "
@@ -273,10 +249,6 @@ int GetPLDMFRU::getFRURecordTableCmd(FRUProperties& fruProperties)
 
         uint8_t instanceID = createInstanceId(tid);
 
-        std::vector<uint8_t> requestMsg(pldmHdrSize +
-                                        PLDM_GET_FRU_RECORD_TABLE_REQ_BYTES);
-        auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
-
         int rc = encode_get_fru_record_table_req(
             instanceID, dataTransferHandle, transferOperationFlag, request,
             requestMsg.size() - pldmHdrSize);
@@ -308,13 +280,20 @@ int GetPLDMFRU::getFRURecordTableCmd(FRUProperties& fruProperties)
             return PLDM_ERROR;
         }
 
-        std::vector<uint8_t> partialFRURecordTableData(
-            payloadLen - PLDM_GET_FRU_RECORD_TABLE_MIN_RESP_BYTES);
+        if (payloadLen - PLDM_GET_FRU_RECORD_TABLE_MIN_RESP_BYTES >
+            fruTableLength - receivedLen)
+        {
+            phosphor::logging::log<phosphor::logging::level::WARNING>(
+                "Max FRU record table length limit reached. Discarding the "
+                "record",
+                phosphor::logging::entry("TID=%d", tid));
+            return PLDM_ERROR;
+        }
 
+        uint8_t* part = fruRecordTableData.data() + receivedLen;
         rc = decode_get_fru_record_table_resp(
             responsePtr, payloadLen, &cc, &nextDataTransferHandle,
-            &transferFlag, partialFRURecordTableData.data(),
-            &fruRecordTableLen);
+            &transferFlag, part, &fruRecordTableLen);
 
         if (!validatePLDMRespDecode(tid, rc, cc, "GetFruRecordTable"))
         {
@@ -323,50 +302,85 @@ int GetPLDMFRU::getFRURecordTableCmd(FRUProperties& fruProperties)
         dataTransferHandle = nextDataTransferHandle;
         transferOperationFlag = PLDM_GET_NEXTPART;
 
-        // Copy multipart fru data into fruRecordTableData to create
-        // final fru
-        std::copy(partialFRURecordTableData.begin(),
-                  partialFRURecordTableData.end(),
-                  std::back_inserter(fruRecordTableData));
+        checksum.update(part, fruRecordTableLen);
+        receivedLen += fruRecordTableLen;
     }
 
-    if (!verifyCRC(fruRecordTableData))
+    // Integrity checksum is calculated over the table padded with zeros to a
+    // multiple of 4 bytes
+    size_t numPadBytes = (mod - receivedLen % mod) % mod;
+    checksum.update(fruRecordTableData.data() + receivedLen, numPadBytes);
+    fruRecordTableData.resize(receivedLen + numPadBytes);
+
+    if (!verifyCRC(checksum.value()))
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "Failed at CRC Match", phosphor::logging::entry("TID=%d", tid));
         return PLDM_ERROR;
     }
 
-    auto it = fruData.find(tid);
-    if (it != fruData.end())
-    {
-        phosphor::logging::log<phosphor::logging::level::WARNING>(
-            ("PLDM FRU device already exist for TID " + std::to_string(tid))
-                .c_str());
-        fruData.erase(it);
-    }
-    // Fru record data is saved in byte format as it is received. This data is
-    // used by GetPldmFRU method
-    fruData.emplace(tid, fruRecordTableData);
-
-    PLDMFRUTable tableParse(std::move(fruRecordTableData), tid);
-
-    std::optional<FRUProperties> fruProp = tableParse.parseTable();
-    if (!fruProp.has_value())
+    PLDMFRUTable fruTable(std::move(fruRecordTableData), tid);
+    if (!fruTable.indexTable())
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "Failed to parse fru table data",
             phosphor::logging::entry("TID=%d", tid));
         return PLDM_ERROR_INVALID_DATA;
     }
-    fruProperties = std::move(fruProp.value());
-
-    std::string tidFRUObjPath = fruPath + std::to_string(tid);
-    addFRUObjectToDbus(tidFRUObjPath, tid, fruProperties);
+    cacheFRURecordTable(fruTable.getTable());
+    addFRUObjectsToDbus(tid, fruTable);
+    saveFRUData(tid, std::move(fruTable));
 
     return PLDM_SUCCESS;
 }
 
+bool GetPLDMFRU::loadCachedFRURecordTable()
+{
+    auto fruTableLen = fruMetadata.find("FRUTableLength");
+    auto crcFound = fruMetadata.find("Checksum");
+    if (fruTableLen == fruMetadata.end() || crcFound == fruMetadata.end())
+    {
+        return false;
+    }
+
+    std::optional<UUID> uuid = base::getTerminusUUID(tid);
+    if (!uuid)
+    {
+        return false;
+    }
+
+    std::optional<std::vector<uint8_t>> cachedTable =
+        loadFRUTableCache(*uuid, fruTableLen->second, crcFound->second);
+    if (!cachedTable)
+    {
+        return false;
+    }
+
+    PLDMFRUTable fruTable(std::move(*cachedTable), tid);
+    if (!fruTable.indexTable())
+    {
+        return false;
+    }
+    addFRUObjectsToDbus(tid, fruTable);
+    saveFRUData(tid, std::move(fruTable));
+
+    phosphor::logging::log<phosphor::logging::level::INFO>(
+        "FRU Record Table restored from cache",
+        phosphor::logging::entry("TID=%d", tid));
+    return true;
+}
+
+void GetPLDMFRU::cacheFRURecordTable(const std::vector<uint8_t>& fruTable)
+{
+    std::optional<UUID> uuid = base::getTerminusUUID(tid);
+    if (!uuid)
+    {
+        return;
+    }
+    storeFRUTableCache(*uuid, fruMetadata["FRUTableLength"],
+                       fruMetadata["Checksum"], fruTable);
+}
+
 int GetPLDMFRU::getFRURecordTableMetadataCmd()
 {
     uint8_t instanceID = createInstanceId(tid);
@@ -445,18 +459,20 @@ bool GetPLDMFRU::runGetFRUCommands()
         return false;
     }
 
-    FRUProperties fruProperties;
-    retVal = getFRURecordTableCmd(fruProperties);
-    if (retVal != PLDM_SUCCESS)
+    // Bulk transfer of the table is skipped if it is unchanged since cached
+    if (!loadCachedFRURecordTable())
     {
-        phosphor::logging::log<phosphor::logging::level::ERR>(
-            "Failed to run GetFruRecordTable command",
-            phosphor::logging::entry("TID=%d", tid));
-        return false;
+        retVal = getFRURecordTableCmd();
+        if (retVal != PLDM_SUCCESS)
+        {
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                "Failed to run GetFruRecordTable command",
+                phosphor::logging::entry("TID=%d", tid));
+            return false;
+        }
     }
 
     terminusFRUMetadata.insert_or_assign(tid, fruMetadata);
-    terminusFRUProperties.insert_or_assign(tid, std::move(fruProperties));
     return true;
 }
 
@@ -509,47 +525,34 @@ int SetPLDMFRU::formatSetFruReq(std::vector<uint8_t>& requestMsg,
 int SetPLDMFRU::sendFruData(boost::asio::yield_context yield,
                             const std::vector<uint8_t>& setFruData)
 {
-    size_t offset = 0;
-    int retVal = PLDM_SUCCESS;
-    size_t length = pldmFruBaselineTransferSize; // max payload size
     const size_t dataSize = setFruData.size();
-
-    // Max number of unique requests (excluding requeries)
-    size_t numExpectedRequests = dataSize / pldmFruBaselineTransferSize;
-
-    if (dataSize % pldmFruBaselineTransferSize > 0)
-    {
-        numExpectedRequests += 1;
-    }
-
-    // Calculate based on size of payload and maximum transfer size
-    // Max number of requests including the requeries
-    size_t maxNumReq = numExpectedRequests * 3;
-    std::set<uint32_t> sentRequests;
+    size_t chunkSize = pldmFruBaselineTransferSize;
+    // Lowered to the largest chunk known to go through
+    size_t chunkSizeLimit = pldmFruMaxTransferSize;
+    size_t resumeCount = 0;
+
+    // Chunks are never smaller than the baseline transfer size. Allow
+    // requeries on top of the requests needed at that size.
+    size_t maxNumReq = (dataSize / pldmFruBaselineTransferSize + 1) * 3;
+
+    // The offset acknowledged by the terminus is tracked here, the transfer
+    // handles are opaque and only echoed back. Each request carries the
+    // handle returned for the previous chunk, thus only one request can be
+    // outstanding.
+    size_t offset = 0;
     uint32_t dataTransferHandle = 0;
 
+    constexpr size_t reqHdrSize =
+        pldmHdrSize + sizeof(pldm_set_fru_record_table_req);
+    std::vector<uint8_t> requestMsg;
+    requestMsg.reserve(reqHdrSize +
+                       std::min(pldmFruMaxTransferSize, dataSize));
+    std::vector<uint8_t> responseMsg;
+
     while (maxNumReq--)
     {
-        offset = dataTransferHandle * pldmFruBaselineTransferSize;
-
-        if (offset > dataSize)
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "SetFruRecordTable: Offset out of range",
-                phosphor::logging::entry("TID=%d", tid));
-            return PLDM_ERROR;
-        }
-        if (dataSize - offset < pldmFruBaselineTransferSize)
-        {
-            length = dataSize - offset;
-        }
-        else
-        {
-            length = pldmFruBaselineTransferSize;
-        }
-
-        std::vector<uint8_t> requestMsg(
-            pldmHdrSize + sizeof(pldm_set_fru_record_table_req) + length);
+        size_t length = std::min(chunkSize, dataSize - offset);
+        requestMsg.resize(reqHdrSize + length);
 
         if (formatSetFruReq(requestMsg, dataTransferHandle, offset, length,
                             setFruData) != PLDM_SUCCESS)
@@ -560,10 +563,23 @@ int SetPLDMFRU::sendFruData(boost::asio::yield_context yield,
             return PLDM_ERROR;
         }
 
-        std::vector<uint8_t> responseMsg;
+        responseMsg.clear();
         if (!sendReceivePldmMessage(yield, tid, timeout, retryCount, requestMsg,
                                     responseMsg))
         {
+            if (resumeCount < setFruResumeLimit)
+            {
+                // The terminus may have applied the chunk before the response
+                // got lost, resend it unchanged from the last acknowledged
+                // handle so that a replay writes the same bytes.
+                ++resumeCount;
+                phosphor::logging::log<phosphor::logging::level::WARNING>(
+                    "SetFruRecordTable: Resuming transfer",
+                    phosphor::logging::entry("TID=%d", tid),
+                    phosphor::logging::entry("OFFSET=%zu", offset),
+                    phosphor::logging::entry("LENGTH=%zu", chunkSize));
+                continue;
+            }
             phosphor::logging::log<phosphor::logging::level::ERR>(
                 "SetFruRecordTable: Failed to send or receive PLDM message",
                 phosphor::logging::entry("TID=%d", tid));
@@ -580,30 +596,40 @@ int SetPLDMFRU::sendFruData(boost::asio::yield_context yield,
         int rc = decode_set_fru_record_table_resp(responsePtr, payloadLen, &cc,
                                                   &nextDataTransferHandle);
 
+        if (rc == PLDM_SUCCESS && cc == PLDM_ERROR_INVALID_LENGTH &&
+            chunkSize > pldmFruBaselineTransferSize)
+        {
+            chunkSize = std::max(chunkSize / 2, pldmFruBaselineTransferSize);
+            chunkSizeLimit = chunkSize;
+            phosphor::logging::log<phosphor::logging::level::INFO>(
+                "SetFruRecordTable: Chunk length rejected, reducing",
+                phosphor::logging::entry("TID=%d", tid),
+                phosphor::logging::entry("LENGTH=%zu", chunkSize));
+            continue;
+        }
+
         if (!validatePLDMRespDecode(tid, rc, cc, "SetFruRecordTable"))
         {
             phosphor::logging::log<phosphor::logging::level::ERR>(
                 "SetFruRecordTable: Invalid Response");
             return PLDM_ERROR;
         }
-        sentRequests.insert(dataTransferHandle);
+        resumeCount = 0;
+        offset += length;
         dataTransferHandle = nextDataTransferHandle;
+        chunkSize = std::min(chunkSize * 2, chunkSizeLimit);
         // Confirm if complete package data is been transferred
-        if (sentRequests.size() == numExpectedRequests)
+        if (offset == dataSize)
         {
             phosphor::logging::log<phosphor::logging::level::INFO>(
                 "Set fru successful");
-            break;
+            return PLDM_SUCCESS;
         }
     }
 
-    if (maxNumReq == 0)
-    {
-        phosphor::logging::log<phosphor::logging::level::ERR>(
-            ("SetFruRecordTableData: Failed as requests exceed limit "));
-        retVal = PLDM_ERROR;
-    }
-    return retVal;
+    phosphor::logging::log<phosphor::logging::level::ERR>(
+        ("SetFruRecordTableData: Failed as requests exceed limit "));
+    return PLDM_ERROR;
 }
 
 int SetPLDMFRU::setFruRecordTableCmd(boost::asio::yield_context yield,
@@ -667,11 +693,11 @@ int SetPLDMFRU::setFruRecordTableCmd(boost::asio::yield_context yield,
             phosphor::logging::entry("TID=%d", tid));
         return PLDM_ERROR;
     }
-    try
+    if (std::optional<FRUProperties> fruProperties = getProperties(tid))
     {
-        ipmiFru.convertFRUToIpmiFRU(tid, terminusFRUProperties.at(tid));
+        ipmiFru.convertFRUToIpmiFRU(tid, *fruProperties);
     }
-    catch (const std::out_of_range&)
+    else
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             "Failed to map PLDM Fru to IPMI fru",
@@ -681,22 +707,29 @@ int SetPLDMFRU::setFruRecordTableCmd(boost::asio::yield_context yield,
     return PLDM_SUCCESS;
 }
 
+// Removes the interface on interfacePath along with the ones on its child
+// objects, which represent the additional FRU record sets
 static void removeInterface(
     std::string& interfacePath,
     std::vector<std::shared_ptr<sdbusplus::asio::dbus_interface>>& interfaces)
 {
     auto objServer = getObjServer();
+    std::string childPathPrefix = interfacePath + "/";
     for (auto dbusInterface = interfaces.begin();
-         dbusInterface != interfaces.end(); dbusInterface++)
+         dbusInterface != interfaces.end();)
     {
-        if ((*dbusInterface)->get_object_path() == interfacePath)
+        const std::string& objectPath = (*dbusInterface)->get_object_path();
+        if (objectPath == interfacePath ||
+            objectPath.compare(0, childPathPrefix.size(), childPathPrefix) ==
+                0)
         {
             std::shared_ptr<sdbusplus::asio::dbus_interface> tmpIf =
                 *dbusInterface;
             objServer->remove_interface(tmpIf);
-            interfaces.erase(dbusInterface);
-            break;
+            dbusInterface = interfaces.erase(dbusInterface);
+            continue;
         }
+        dbusInterface++;
     }
 }
 
@@ -712,35 +745,20 @@ bool deleteFRUDevice(const pldm_tid_t tid)
             ("PLDM FRU device not matched for TID " + std::to_string(tid))
                 .c_str());
         // If terminusFRUMetadata[tid] is not present, then it is safe to return
-        // as terminusFRUProperties / fruInterface will not be there.
+        // as fruData / fruInterface will not be there.
         return false;
     }
     terminusFRUMetadata.erase(it);
 
-    auto itr = terminusFRUProperties.find(tid);
-    if (itr == terminusFRUProperties.end())
-    {
-        phosphor::logging::log<phosphor::logging::level::WARNING>(
-            ("PLDM FRU device properties not matched for TID " +
-             std::to_string(tid))
-                .c_str());
-        // Only terminusFRUMeta[tid] is present, which is cleared. No
-        // terminusFRUProperties[tid] is present meaning terminusFRUProperties /
-        // fruInterface will not be there to clear. So return true.
-        return true;
-    }
-    terminusFRUProperties.erase(itr);
-
     auto itData = fruData.find(tid);
     if (itData == fruData.end())
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             ("PLDM FRU device not available for TID " + std::to_string(tid))
                 .c_str());
-        // terminusFRUMeta[tid] is present, which is cleared.
-        // terminusFRUProperties[tid] is cleared .NO fruData present meaning
-        // terminusFRUProperties / fruInterface will not be there to clear. So
-        // return true.
+        // Only terminusFRUMeta[tid] is present, which is cleared. NO fruData
+        // present meaning fruInterface will not be there to clear. So return
+        // true.
         return true;
     }
     fruData.erase(itData);
@@ -770,7 +788,7 @@ std::optional<std::vector<uint8_t>> GetPLDMFRU::getPLDMFruRecordData()
         return std::nullopt;
     }
 
-    return itr->second;
+    return itr->second.getTable();
 }
 
 static void initializeGetFruIntf()
@@ -849,19 +867,19 @@ bool fruInit(boost::asio::yield_context yield, const pldm_tid_t tid)
         return retVal;
     }
 
-    try
-    {
-        ipmiFru.convertFRUToIpmiFRU(tid, terminusFRUProperties.at(tid));
-    }
-    catch (const std::out_of_range&)
+    // Properties are decoded once for all the FRU representations
+    std::optional<FRUProperties> fruProperties = getProperties(tid);
+    if (!fruProperties)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "Failed to map PLDM Fru to IPMI fru",
             phosphor::logging::entry("TID=%d", tid));
+        return retVal;
     }
+    ipmiFru.convertFRUToIpmiFRU(tid, *fruProperties);
 
 #ifdef EXPOSE_CHASSIS
-    redfishFru.createInterface(tid, terminusFRUProperties.at(tid));
+    redfishFru.createInterface(tid, *fruProperties);
 #endif
 
     return retVal;
@@ -0,0 +1,197 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "fru_cache.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <phosphor-logging/log.hpp>
+
+#include "utils.h"
+
+namespace pldm
+{
+namespace fru
+{
+
+static const std::filesystem::path fruCacheDir = "/var/lib/pldm/fru";
+constexpr std::array<uint8_t, 4> fruCacheMagic = {'P', 'F', 'R', 'U'};
+constexpr uint8_t fruCacheVersion = 0x02;
+
+static std::filesystem::path getCachePath(const UUID& uuid)
+{
+    std::string fileName;
+    for (uint8_t byte : uuid)
+    {
+        constexpr size_t hexLength = 3;
+        char hex[hexLength];
+        snprintf(hex, hexLength, "%02x", byte);
+        fileName += hex;
+    }
+    return fruCacheDir / fileName;
+}
+
+static void appendLE(std::vector<uint8_t>& buffer, const uint32_t value,
+                     const size_t size)
+{
+    for (size_t byte = 0; byte < size; byte++)
+    {
+        buffer.push_back(static_cast<uint8_t>(value >> (byte * 8)));
+    }
+}
+
+/** @brief Bounds checked reader of the cache file content*/
+class CacheReader
+{
+  public:
+    CacheReader(const std::vector<uint8_t>& content) : data(content)
+    {
+    }
+
+    bool read(uint32_t& value, const size_t size)
+    {
+        if (data.size() - offset < size)
+        {
+            return false;
+        }
+        value = 0;
+        for (size_t byte = 0; byte < size; byte++)
+        {
+            value |= static_cast<uint32_t>(data[offset++]) << (byte * 8);
+        }
+        return true;
+    }
+
+    bool read(std::vector<uint8_t>& bytes, const size_t size)
+    {
+        if (data.size() - offset < size)
+        {
+            return false;
+        }
+        auto begin = data.begin() + static_cast<std::ptrdiff_t>(offset);
+        bytes.assign(begin, begin + static_cast<std::ptrdiff_t>(size));
+        offset += size;
+        return true;
+    }
+
+  private:
+    const std::vector<uint8_t>& data;
+    size_t offset = 0;
+};
+
+std::optional<std::vector<uint8_t>>
+    loadFRUTableCache(const UUID& uuid, const uint32_t tableLength,
+                      const uint32_t checksum)
+{
+    std::ifstream cacheFile(getCachePath(uuid), std::ios::binary);
+    if (!cacheFile)
+    {
+        return std::nullopt;
+    }
+    std::vector<uint8_t> content((std::istreambuf_iterator<char>(cacheFile)),
+                                 std::istreambuf_iterator<char>());
+
+    // Whole file is protected by a trailing CRC-32
+    if (content.size() < fruCacheMagic.size() + sizeof(uint32_t) ||
+        !std::equal(fruCacheMagic.begin(), fruCacheMagic.end(),
+                    content.begin()))
+    {
+        return std::nullopt;
+    }
+    size_t crcOffset = content.size() - sizeof(uint32_t);
+    uint32_t fileCRC = 0;
+    for (size_t byte = 0; byte < sizeof(uint32_t); byte++)
+    {
+        fileCRC |= static_cast<uint32_t>(content[crcOffset + byte])
+                   << (byte * 8);
+    }
+    if (crc32(content.data(), crcOffset) != fileCRC)
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "FRU table cache corrupted");
+        return std::nullopt;
+    }
+    content.resize(crcOffset);
+
+    CacheReader reader(content);
+    std::vector<uint8_t> magic;
+    uint32_t version;
+    uint32_t cachedLength;
+    uint32_t cachedChecksum;
+    uint32_t tableSize;
+    std::vector<uint8_t> table;
+    if (!reader.read(magic, fruCacheMagic.size()) ||
+        !reader.read(version, sizeof(uint8_t)) || version != fruCacheVersion ||
+        !reader.read(cachedLength, sizeof(uint32_t)) ||
+        !reader.read(cachedChecksum, sizeof(uint32_t)) ||
+        !reader.read(tableSize, sizeof(uint32_t)) ||
+        !reader.read(table, tableSize))
+    {
+        return std::nullopt;
+    }
+
+    if (cachedLength != tableLength || cachedChecksum != checksum ||
+        crc32(table.data(), table.size()) != checksum)
+    {
+        phosphor::logging::log<phosphor::logging::level::INFO>(
+            "FRU table changed, discarding cache");
+        return std::nullopt;
+    }
+    return table;
+}
+
+void storeFRUTableCache(const UUID& uuid, const uint32_t tableLength,
+                        const uint32_t checksum,
+                        const std::vector<uint8_t>& table)
+{
+    std::vector<uint8_t> content(fruCacheMagic.begin(), fruCacheMagic.end());
+    content.push_back(fruCacheVersion);
+    appendLE(content, tableLength, sizeof(uint32_t));
+    appendLE(content, checksum, sizeof(uint32_t));
+    appendLE(content, static_cast<uint32_t>(table.size()), sizeof(uint32_t));
+    content.insert(content.end(), table.begin(), table.end());
+    appendLE(content, crc32(content.data(), content.size()), sizeof(uint32_t));
+
+    std::error_code ec;
+    std::filesystem::create_directories(fruCacheDir, ec);
+    std::filesystem::path cachePath = getCachePath(uuid);
+    std::filesystem::path tmpPath = cachePath;
+    tmpPath += ".tmp";
+    {
+        std::ofstream cacheFile(tmpPath, std::ios::binary | std::ios::trunc);
+        cacheFile.write(reinterpret_cast<const char*>(content.data()),
+                        static_cast<std::streamsize>(content.size()));
+        if (!cacheFile)
+        {
+            phosphor::logging::log<phosphor::logging::level::WARNING>(
+                "Unable to write FRU table cache");
+            std::filesystem::remove(tmpPath, ec);
+            return;
+        }
+    }
+    // Replace atomically so that a reader never sees a partial cache
+    std::filesystem::rename(tmpPath, cachePath, ec);
+    if (ec)
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "Unable to store FRU table cache");
+        std::filesystem::remove(tmpPath, ec);
+    }
+}
+
+} // namespace fru
+} // namespace pldm
@@ -66,7 +66,7 @@ void IpmiFru::initializeFRUSupport()
                 std::make_error_code(std::errc::no_message_available));
         }
 
-        return retVal.value();
+        return std::move(*retVal);
     });
 
     fruIface->initialize();
@@ -147,7 +147,10 @@ void IpmiFru::convertFRUToIpmiFRU(const pldm_tid_t tid,
 
     iface->initialize();
     ipmiFruInterface.emplace(tid, iface);
-    ipmiFRUProperties.emplace(tid, std::move(ipmiProps));
+    // FRU is re-read on re-discovery and after SetFRU. Drop the IPMI FRU
+    // encoded from the previous properties.
+    ipmiFRUProperties.insert_or_assign(tid, std::move(ipmiProps));
+    ipmiFRURawData.erase(tid);
 }
 
 void IpmiFru::removeInterfaces(const pldm_tid_t tid)
@@ -160,6 +163,7 @@ void IpmiFru::removeInterfaces(const pldm_tid_t tid)
         objServer->remove_interface(ipmiIface->second);
         ipmiFruInterface.erase(ipmiIface);
         ipmiFRUProperties.erase(tid);
+        ipmiFRURawData.erase(tid);
         return;
     }
     phosphor::logging::log<phosphor::logging::level::ERR>(
@@ -170,6 +174,12 @@ void IpmiFru::removeInterfaces(const pldm_tid_t tid)
 std::optional<std::vector<uint8_t>>
     IpmiFru::getRawFRURecordData(const pldm_tid_t tid)
 {
+    auto cached = ipmiFRURawData.find(tid);
+    if (cached != ipmiFRURawData.end())
+    {
+        return cached->second;
+    }
+
     std::vector<uint8_t> ipmiFruData;
     std::vector<uint8_t> rawFruData;
 
@@ -196,6 +206,7 @@ std::optional<std::vector<uint8_t>>
     std::move(rawFruData.begin(), rawFruData.end(),
               std::back_inserter(ipmiFruData));
 
+    ipmiFRURawData.emplace(tid, ipmiFruData);
     return ipmiFruData;
 }
 
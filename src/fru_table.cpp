@@ -0,0 +1,380 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "fru_table.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <phosphor-logging/log.hpp>
+
+namespace pldm
+{
+namespace fru
+{
+
+enum class FieldFormat
+{
+    string,
+    timestamp104,
+    uint32
+};
+
+struct FieldType
+{
+    uint8_t type;
+    const char* name;
+    FieldFormat format;
+};
+
+// Fields of General FRU records exposed as properties, DSP0257 Table 5
+static constexpr std::array<FieldType, 14> generalFields{{
+    {PLDM_FRU_FIELD_TYPE_CHASSIS, "ChassisType", FieldFormat::string},
+    {PLDM_FRU_FIELD_TYPE_MODEL, "Model", FieldFormat::string},
+    {PLDM_FRU_FIELD_TYPE_PN, "PN", FieldFormat::string},
+    {PLDM_FRU_FIELD_TYPE_SN, "SN", FieldFormat::string},
+    {PLDM_FRU_FIELD_TYPE_MANUFAC, "Manufacturer", FieldFormat::string},
+    {PLDM_FRU_FIELD_TYPE_MANUFAC_DATE, "ManufacturerDate",
+     FieldFormat::timestamp104},
+    {PLDM_FRU_FIELD_TYPE_VENDOR, "Vendor", FieldFormat::string},
+    {PLDM_FRU_FIELD_TYPE_NAME, "Name", FieldFormat::string},
+    {PLDM_FRU_FIELD_TYPE_SKU, "SKU", FieldFormat::string},
+    {PLDM_FRU_FIELD_TYPE_VERSION, "Version", FieldFormat::string},
+    {PLDM_FRU_FIELD_TYPE_ASSET_TAG, "AssetTag", FieldFormat::string},
+    {PLDM_FRU_FIELD_TYPE_DESC, "Description", FieldFormat::string},
+    {PLDM_FRU_FIELD_TYPE_EC_LVL, "ECLevel", FieldFormat::string},
+    {PLDM_FRU_FIELD_TYPE_IANA, "IANA", FieldFormat::uint32},
+}};
+
+// Fields of OEM FRU records, DSP0257 Table 6. OEM records are not part of
+// the FRU properties but their fields can be looked up by name.
+static constexpr std::array<FieldType, 1> oemFields{{
+    {1, "Vendor IANA", FieldFormat::uint32},
+}};
+
+template <size_t fieldCount>
+static const FieldType*
+    findFieldType(const std::array<FieldType, fieldCount>& fieldTypes,
+                  const uint8_t type)
+{
+    auto it = std::find_if(
+        fieldTypes.begin(), fieldTypes.end(),
+        [type](const FieldType& field) { return field.type == type; });
+    return it == fieldTypes.end() ? nullptr : &*it;
+}
+
+template <size_t fieldCount>
+static const FieldType*
+    findFieldType(const std::array<FieldType, fieldCount>& fieldTypes,
+                  const std::string& name)
+{
+    auto it = std::find_if(
+        fieldTypes.begin(), fieldTypes.end(),
+        [&name](const FieldType& field) { return name == field.name; });
+    return it == fieldTypes.end() ? nullptr : &*it;
+}
+
+static std::optional<FRUVariantType> decodeField(const FRUFieldView& view,
+                                                 const FieldFormat format)
+{
+    switch (format)
+    {
+        case FieldFormat::string:
+            return view.toString();
+        case FieldFormat::timestamp104:
+            return view.toCIMTimestamp();
+        case FieldFormat::uint32:
+            // Exposed as string like the rest of the FRU properties
+            if (auto value = view.toU32())
+            {
+                return std::to_string(*value);
+            }
+            return std::nullopt;
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string> FRUFieldView::toString() const
+{
+    if (length < 1)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Invalid FRU field length");
+        return std::nullopt;
+    }
+    std::string strVal(reinterpret_cast<const char*>(value), length);
+    std::replace_if(
+        strVal.begin(), strVal.end(),
+        [](const char& c) { return !isprint(c); }, ' ');
+    return strVal;
+}
+
+std::optional<uint32_t> FRUFieldView::toU32() const
+{
+    if (length != sizeof(uint32_t))
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Vendor IANA should be of length 4");
+        return std::nullopt;
+    }
+    uint32_t u32Val;
+    std::memcpy(&u32Val, value, sizeof(u32Val));
+    return le32toh(u32Val);
+}
+
+std::optional<timestamp104_t> FRUFieldView::toTimestamp104() const
+{
+    if (length != timeStamp104Size)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Invalid time stamp length");
+        return std::nullopt;
+    }
+    timestamp104_t fruStamp;
+    std::memcpy(&fruStamp, value, timeStamp104Size);
+    return fruStamp;
+}
+
+std::optional<std::string> FRUFieldView::toCIMTimestamp() const
+{
+    std::optional<timestamp104_t> fruStamp = toTimestamp104();
+    if (!fruStamp)
+    {
+        return std::nullopt;
+    }
+
+    uint32_t microsecond = fruStamp->microsecond;
+    int utcOffset = fruStamp->utc_offset;
+    if (!((fruStamp->year >= 1980 && fruStamp->year <= 9999) &&
+          (fruStamp->month >= 1 && fruStamp->month <= 12) &&
+          (fruStamp->day >= 1 && fruStamp->day <= 31) &&
+          (fruStamp->hour < 24) && (fruStamp->minute < 60) &&
+          (fruStamp->second < 60) && (microsecond <= 999999) &&
+          (utcOffset >= -999 && utcOffset <= 999)))
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "TimeStamp is not valid");
+        return std::nullopt;
+    }
+
+    // yyyymmddhhmmss.mmmmmmsutc
+    constexpr size_t cimTimestampSize = 26;
+    char cimTimestamp[cimTimestampSize];
+    snprintf(cimTimestamp, sizeof(cimTimestamp),
+             "%04u%02u%02u%02u%02u%02u.%06" PRIu32 "%c%03d",
+             static_cast<unsigned>(fruStamp->year),
+             static_cast<unsigned>(fruStamp->month),
+             static_cast<unsigned>(fruStamp->day),
+             static_cast<unsigned>(fruStamp->hour),
+             static_cast<unsigned>(fruStamp->minute),
+             static_cast<unsigned>(fruStamp->second), microsecond,
+             utcOffset < 0 ? '-' : '+', std::abs(utcOffset));
+    return std::string(cimTimestamp);
+}
+
+PLDMFRUTable::PLDMFRUTable(std::vector<uint8_t> tableVal,
+                           const pldm_tid_t tidVal) :
+    table(std::move(tableVal)),
+    tid(tidVal)
+{
+}
+
+bool PLDMFRUTable::indexTable()
+{
+    records.clear();
+    fields.clear();
+
+    constexpr size_t recordHdrSize =
+        sizeof(pldm_fru_record_data_format) - sizeof(pldm_fru_record_tlv);
+    constexpr size_t tlvHdrSize = sizeof(pldm_fru_record_tlv) - 1;
+    // Anything shorter than a record with one field is padding
+    constexpr size_t fixedFRUBytes = 7;
+
+    size_t offset = 0;
+    while (table.size() - offset > fixedFRUBytes)
+    {
+        auto record = reinterpret_cast<const pldm_fru_record_data_format*>(
+            table.data() + offset);
+        FRURecordIndex recordIndex{le16toh(record->record_set_id),
+                                   record->record_type, record->encoding_type,
+                                   static_cast<uint32_t>(fields.size()),
+                                   record->num_fru_fields};
+        if (recordIndex.fieldCount < 1)
+        {
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                "Number of FRU fields cannot be 0.",
+                phosphor::logging::entry("TID=%d", tid));
+            return false;
+        }
+        offset += recordHdrSize;
+
+        for (uint32_t field = 0; field < recordIndex.fieldCount; field++)
+        {
+            if (table.size() - offset < tlvHdrSize)
+            {
+                phosphor::logging::log<phosphor::logging::level::ERR>(
+                    "FRU field exceeds FRU Record Table",
+                    phosphor::logging::entry("TID=%d", tid));
+                return false;
+            }
+            auto tlv = reinterpret_cast<const pldm_fru_record_tlv*>(
+                table.data() + offset);
+            offset += tlvHdrSize;
+            if (table.size() - offset < tlv->length)
+            {
+                phosphor::logging::log<phosphor::logging::level::ERR>(
+                    "FRU field exceeds FRU Record Table",
+                    phosphor::logging::entry("TID=%d", tid));
+                return false;
+            }
+            fields.push_back(
+                {static_cast<uint32_t>(offset), tlv->type, tlv->length});
+            offset += tlv->length;
+        }
+
+        phosphor::logging::log<phosphor::logging::level::INFO>(
+            "FRU Record", phosphor::logging::entry("TID=%d", tid),
+            phosphor::logging::entry("REC_SET_ID=%d", recordIndex.recordSetID),
+            phosphor::logging::entry("REC_TYPE=%d", recordIndex.recordType),
+            phosphor::logging::entry("FRU_FIELD_NUM=%d",
+                                     recordIndex.fieldCount),
+            phosphor::logging::entry("FRU_ENCODE_TYPE=%d",
+                                     recordIndex.encodingType));
+        records.push_back(recordIndex);
+    }
+    return true;
+}
+
+std::vector<FRURecordSetID> PLDMFRUTable::getRecordSetIDs() const
+{
+    std::vector<FRURecordSetID> recordSetIDs;
+    for (const FRURecordIndex& record : records)
+    {
+        if (record.recordType == PLDM_FRU_RECORD_TYPE_GENERAL &&
+            std::find(recordSetIDs.begin(), recordSetIDs.end(),
+                      record.recordSetID) == recordSetIDs.end())
+        {
+            recordSetIDs.push_back(record.recordSetID);
+        }
+    }
+    return recordSetIDs;
+}
+
+std::optional<FRURecordSetID> PLDMFRUTable::getPrimaryRecordSetID() const
+{
+    auto it = std::find_if(records.begin(), records.end(),
+                           [](const FRURecordIndex& record) {
+                               return record.recordType ==
+                                      PLDM_FRU_RECORD_TYPE_GENERAL;
+                           });
+    if (it == records.end())
+    {
+        return std::nullopt;
+    }
+    return it->recordSetID;
+}
+
+std::optional<FRUFieldView>
+    PLDMFRUTable::findField(const FRURecordSetID recordSetID,
+                            const uint8_t fieldType,
+                            const uint8_t recordType) const
+{
+    // A field repeated within the record set overrides the earlier ones
+    std::optional<FRUFieldView> view;
+    for (const FRURecordIndex& record : records)
+    {
+        if (record.recordSetID != recordSetID ||
+            record.recordType != recordType)
+        {
+            continue;
+        }
+        for (uint32_t field = record.firstField;
+             field < record.firstField + record.fieldCount; field++)
+        {
+            if (fields[field].type == fieldType)
+            {
+                view.emplace(table.data() + fields[field].offset,
+                             fields[field].length);
+            }
+        }
+    }
+    return view;
+}
+
+std::optional<FRUVariantType>
+    PLDMFRUTable::getProperty(const FRURecordSetID recordSetID,
+                              const std::string& name) const
+{
+    uint8_t recordType = PLDM_FRU_RECORD_TYPE_GENERAL;
+    const FieldType* fieldType = findFieldType(generalFields, name);
+    if (!fieldType)
+    {
+        recordType = PLDM_FRU_RECORD_TYPE_OEM;
+        fieldType = findFieldType(oemFields, name);
+    }
+    if (!fieldType)
+    {
+        return std::nullopt;
+    }
+    std::optional<FRUFieldView> view =
+        findField(recordSetID, fieldType->type, recordType);
+    if (!view)
+    {
+        return std::nullopt;
+    }
+    return decodeField(*view, fieldType->format);
+}
+
+FRUProperties
+    PLDMFRUTable::getProperties(const FRURecordSetID recordSetID) const
+{
+    FRUProperties fruProperties;
+    for (const FRURecordIndex& record : records)
+    {
+        if (record.recordSetID != recordSetID ||
+            record.recordType != PLDM_FRU_RECORD_TYPE_GENERAL)
+        {
+            continue;
+        }
+        for (uint32_t field = record.firstField;
+             field < record.firstField + record.fieldCount; field++)
+        {
+            const FRUFieldIndex& fieldIndex = fields[field];
+            const FieldType* generalField =
+                findFieldType(generalFields, fieldIndex.type);
+            if (!generalField)
+            {
+                phosphor::logging::log<phosphor::logging::level::WARNING>(
+                    "fruFieldTypes key not available in map",
+                    phosphor::logging::entry("TID=%d", tid));
+                continue;
+            }
+            FRUFieldView view(table.data() + fieldIndex.offset,
+                              fieldIndex.length);
+            if (auto value = decodeField(view, generalField->format))
+            {
+                fruProperties[generalField->name] = std::move(*value);
+            }
+        }
+    }
+    return fruProperties;
+}
+
+} // namespace fru
+} // namespace pldm
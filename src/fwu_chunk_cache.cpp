@@ -0,0 +1,130 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "fwu_chunk_cache.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <phosphor-logging/log.hpp>
+
+namespace pldm
+{
+namespace fwu
+{
+
+FWUChunkCache::FWUChunkCache(const PLDMImg& img, const uint32_t windowSizeVal,
+                             const size_t maxRecentWindowsVal) :
+    pldmImg(img),
+    windowSize(windowSizeVal), maxRecentWindows(maxRecentWindowsVal)
+{
+}
+
+FWUChunk FWUChunkCache::getWindow(const FWUComponentRange& component,
+                                  const uint32_t windowOffset)
+{
+    auto key = std::make_pair(component.index, windowOffset);
+    auto it = windows.find(key);
+    if (it != windows.end())
+    {
+        if (FWUChunk window = it->second.lock())
+        {
+            hits++;
+            return window;
+        }
+    }
+    misses++;
+
+    uint32_t length = std::min(windowSize, component.size - windowOffset);
+    const uint8_t* src =
+        pldmImg.getData(component.location + windowOffset, length);
+    if (!src)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Component window is out of the package",
+            phosphor::logging::entry("COMPONENT=%d", component.index),
+            phosphor::logging::entry("OFFSET=%u", windowOffset));
+        return nullptr;
+    }
+    auto window = std::make_shared<FWUChunkData>();
+    window->offset = windowOffset;
+    window->data.assign(src, src + length);
+    // Sessions read sequentially, get the next window on its way
+    pldmImg.prefetchData(component.location + windowOffset + length,
+                         windowSize);
+
+    // Drop the windows no session refers to any more
+    for (auto entry = windows.begin(); entry != windows.end();)
+    {
+        entry = entry->second.expired() ? windows.erase(entry) : ++entry;
+    }
+    windows[key] = window;
+    recentWindows.push_back(window);
+    if (recentWindows.size() > maxRecentWindows)
+    {
+        recentWindows.pop_front();
+    }
+    return window;
+}
+
+const uint8_t* FWUChunkCache::getData(const FWUComponentRange& component,
+                                      const uint32_t offset,
+                                      const uint32_t length, FWUChunk& window,
+                                      std::vector<uint8_t>& scratch)
+{
+    if (offset > component.size || length > component.size - offset)
+    {
+        return nullptr;
+    }
+    uint32_t windowOffset = offset - offset % windowSize;
+    if (!window || window->offset != windowOffset)
+    {
+        window = getWindow(component, windowOffset);
+        if (!window)
+        {
+            return nullptr;
+        }
+    }
+    uint32_t windowPos = offset - windowOffset;
+    if (windowPos + length <= window->data.size())
+    {
+        return window->data.data() + windowPos;
+    }
+
+    // Data spans windows, assemble it
+    scratch.resize(length);
+    uint32_t copied = 0;
+    while (copied < length)
+    {
+        uint32_t chunkLen = std::min(
+            length - copied,
+            static_cast<uint32_t>(window->data.size()) - windowPos);
+        std::memcpy(scratch.data() + copied, window->data.data() + windowPos,
+                    chunkLen);
+        copied += chunkLen;
+        if (copied < length)
+        {
+            window = getWindow(component, window->offset + windowSize);
+            if (!window)
+            {
+                return nullptr;
+            }
+            windowPos = 0;
+        }
+    }
+    return scratch.data();
+}
+
+} // namespace fwu
+} // namespace pldm
@@ -536,5 +536,135 @@ std::optional<FDProperties>
         std::make_tuple(fwuProperties, descriptors, compPropertiesMap);
     return fdProperties;
 }
+
+/** @brief Version string as exposed on D-Bus, non printable characters
+ * replaced
+ */
+static std::string getPrintableString(const FWUProperties& properties,
+                                      const std::string& name)
+{
+    auto it = properties.find(name);
+    if (it == properties.end())
+    {
+        return {};
+    }
+    std::string str = std::get<std::string>(it->second);
+    std::replace_if(
+        str.begin(), str.end(), [](const char& c) { return !isprint(c); },
+        ' ');
+    return str;
+}
+
+template <typename T>
+static T getProperty(const FWUProperties& properties, const std::string& name)
+{
+    auto it = properties.find(name);
+    return it == properties.end() ? T{} : std::get<T>(it->second);
+}
+
+template <typename T>
+bool FWInventoryInfo::updateChangedProperty(
+    std::vector<std::unique_ptr<sdbusplus::asio::dbus_interface>>& interfaces,
+    const std::string& objPath, const std::string& interfaceName,
+    const std::string& propertyName, const T& oldValue, const T& newValue)
+{
+    if (oldValue == newValue)
+    {
+        return false;
+    }
+    for (auto& iface : interfaces)
+    {
+        if (iface && iface->get_object_path() == objPath &&
+            iface->get_interface_name() == interfaceName)
+        {
+            return iface->set_property(propertyName, newValue);
+        }
+    }
+    return false;
+}
+
+bool FWInventoryInfo::refreshFirmwareParameters(
+    boost::asio::yield_context yield, const std::string& inventoryPathVal,
+    std::vector<std::unique_ptr<sdbusplus::asio::dbus_interface>>& interfaces,
+    FDProperties& fdProperties)
+{
+    if (runGetFirmwareParameters(yield) != PLDM_SUCCESS)
+    {
+        return false;
+    }
+    const FWUProperties& oldProperties = std::get<0>(fdProperties);
+    const CompPropertiesMap& oldCompProperties = std::get<2>(fdProperties);
+    size_t changed = 0;
+
+    const std::string compImgSetPath = "/xyz/openbmc_project/pldm/fwu/" +
+                                       std::to_string(tid) +
+                                       "/componentImageSetInfo";
+    std::string oldActiveStr =
+        getProperty<std::string>(oldProperties, "ActiveCompImgSetVerStr");
+    changed += updateChangedProperty(
+        interfaces, compImgSetPath,
+        "xyz.openbmc_project.PLDM.FWU.ActiveComponentImageSetInfo",
+        "ActiveComponentImageSetVersionString", oldActiveStr,
+        activeCompImgSetVerStr);
+    changed += updateChangedProperty(
+        interfaces, compImgSetPath,
+        "xyz.openbmc_project.PLDM.FWU.PendingComponentImageSetInfo",
+        "PendingComponentImageSetVersionString",
+        getProperty<std::string>(oldProperties, "PendingCompImgSetVerStr"),
+        pendingCompImgSetVerStr);
+    changed += updateChangedProperty(
+        interfaces, inventoryPathVal, "xyz.openbmc_project.Software.Version",
+        "Version", oldActiveStr, activeCompImgSetVerStr);
+
+    for (const auto& itr : compPropertiesMap)
+    {
+        auto oldComp = oldCompProperties.find(itr.first);
+        if (oldComp == oldCompProperties.end())
+        {
+            // Components reported now only appear on rediscovery
+            continue;
+        }
+        const FWUProperties& oldProps = oldComp->second;
+        const FWUProperties& newProps = itr.second;
+        const std::string compPath = compImgSetPath + "/component_" +
+                                     std::to_string(itr.first);
+        for (const char* prefix : {"Active", "Pending"})
+        {
+            std::string intfName =
+                std::string("xyz.openbmc_project.PLDM.FWU.") + prefix +
+                "ComponentInfo";
+            std::string stamp =
+                std::string(prefix) + "ComponentComparisonStamp";
+            std::string date = std::string(prefix) + "ComponentReleaseDate";
+            std::string verStr = std::string(prefix) + "ComponentVersionString";
+            changed += updateChangedProperty(
+                interfaces, compPath, intfName, stamp,
+                getProperty<uint32_t>(oldProps, stamp),
+                getProperty<uint32_t>(newProps, stamp));
+            changed += updateChangedProperty(
+                interfaces, compPath, intfName, date,
+                getProperty<uint64_t>(oldProps, date),
+                getProperty<uint64_t>(newProps, date));
+            changed += updateChangedProperty(
+                interfaces, compPath, intfName, verStr,
+                getPrintableString(oldProps, verStr),
+                getPrintableString(newProps, verStr));
+        }
+    }
+    if (compPropertiesMap.size() != oldCompProperties.size())
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "Component count changed, rediscovery needed to expose it",
+            phosphor::logging::entry("TID=%d", tid));
+    }
+
+    std::get<0>(fdProperties) = fwuProperties;
+    std::get<2>(fdProperties) = compPropertiesMap;
+    phosphor::logging::log<phosphor::logging::level::INFO>(
+        ("Firmware inventory refreshed for TID: " + std::to_string(tid) +
+         ". Properties changed: " + std::to_string(changed))
+            .c_str());
+    return true;
+}
 } // namespace fwu
 } // namespace pldm
@@ -0,0 +1,231 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "fwu_package_stager.hpp"
+
+#include "pldm.hpp"
+#include "pldm_fwu_image.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <boost/asio/post.hpp>
+#include <cstring>
+#include <phosphor-logging/log.hpp>
+
+namespace pldm
+{
+namespace fwu
+{
+
+// Bytes of the stream copied at a time
+constexpr size_t stageChunkSize = 64 * 1024;
+
+FWUPackageStager::FWUPackageStager(const int fd,
+                                   const std::string& stagingFilePathVal,
+                                   const uintmax_t maxPackageSizeVal) :
+    stream(*getIoContext()),
+    stagingFilePath(stagingFilePathVal), maxPackageSize(maxPackageSizeVal),
+    chunk(stageChunkSize)
+{
+    // Regular files can not be polled, read those directly
+    struct stat fdStat;
+    if (fstat(fd, &fdStat) == 0 && S_ISREG(fdStat.st_mode))
+    {
+        sourceFd = fd;
+        return;
+    }
+
+    boost::system::error_code ec;
+    stream.assign(fd, ec);
+    if (ec)
+    {
+        sourceFd = fd;
+    }
+}
+
+FWUPackageStager::~FWUPackageStager()
+{
+    if (sourceFd >= 0)
+    {
+        close(sourceFd);
+    }
+    if (stagingFd >= 0)
+    {
+        close(stagingFd);
+    }
+}
+
+ssize_t FWUPackageStager::readChunk(boost::asio::yield_context yield)
+{
+    if (sourceFd < 0)
+    {
+        boost::system::error_code ec;
+        size_t bytesRead =
+            stream.async_read_some(boost::asio::buffer(chunk), yield[ec]);
+        if (ec == boost::asio::error::eof)
+        {
+            return 0;
+        }
+        return ec ? -1 : static_cast<ssize_t>(bytesRead);
+    }
+
+    ssize_t bytesRead;
+    do
+    {
+        bytesRead = ::read(sourceFd, chunk.data(), chunk.size());
+    } while (bytesRead < 0 && errno == EINTR);
+    // Let the other handlers run before the next chunk
+    boost::asio::post(*getIoContext(), yield);
+    return bytesRead;
+}
+
+bool FWUPackageStager::checkHeader(const uint8_t* data, const size_t size)
+{
+    size_t pos = 0;
+    while (!headerChecked && pos < size)
+    {
+        // The fixed part first, it tells the size of the whole header
+        size_t target = headerLen ? headerLen : sizeof(PLDMPkgHeaderInfo);
+        size_t length = std::min(target - header.size(), size - pos);
+        header.insert(header.end(), data + pos, data + pos + length);
+        pos += length;
+        if (header.size() < target)
+        {
+            return true;
+        }
+
+        if (!headerLen)
+        {
+            PLDMPkgHeaderInfo headerInfo;
+            std::memcpy(&headerInfo, header.data(), sizeof(headerInfo));
+            if (!PLDMImg::matchPkgHdrIdentifier(
+                    headerInfo.packageHeaderIdentifier))
+            {
+                phosphor::logging::log<phosphor::logging::level::ERR>(
+                    "Stream is not a PLDM firmware update package");
+                return false;
+            }
+            headerLen = le16toh(headerInfo.pkgHeaderSize);
+            if (headerLen <= sizeof(PLDMPkgHeaderInfo))
+            {
+                phosphor::logging::log<phosphor::logging::level::ERR>(
+                    "Invalid package header length",
+                    phosphor::logging::entry("HDR_LEN=%d", headerLen));
+                return false;
+            }
+            continue;
+        }
+
+        if (!PLDMImg::verifyPkgHdrChecksum(header.data(), headerLen))
+        {
+            return false;
+        }
+        headerChecked = true;
+        header.clear();
+        header.shrink_to_fit();
+    }
+    return true;
+}
+
+bool FWUPackageStager::writeChunk(const uint8_t* data, const size_t size)
+{
+    size_t offset = 0;
+    while (offset < size)
+    {
+        ssize_t written = ::write(stagingFd, data + offset, size - offset);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                "Failed to write staged firmware package",
+                phosphor::logging::entry("ERRNO=%d", errno));
+            return false;
+        }
+        offset += static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool FWUPackageStager::stage(boost::asio::yield_context yield)
+{
+    stagingFd = open(stagingFilePath.c_str(),
+                     O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (stagingFd < 0)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Unable to create staging file",
+            phosphor::logging::entry("PATH=%s", stagingFilePath.c_str()),
+            phosphor::logging::entry("ERRNO=%d", errno));
+        return false;
+    }
+
+    bool staged = false;
+    while (true)
+    {
+        ssize_t bytesRead = readChunk(yield);
+        if (bytesRead < 0)
+        {
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                "Failed to read firmware package stream");
+            break;
+        }
+        if (bytesRead == 0)
+        {
+            if (!headerChecked)
+            {
+                phosphor::logging::log<phosphor::logging::level::ERR>(
+                    "Firmware package stream ended within the header");
+            }
+            staged = headerChecked;
+            break;
+        }
+        size_t size = static_cast<size_t>(bytesRead);
+        if (size > maxPackageSize - stagedBytes)
+        {
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                "Firmware package exceeds the staging limit",
+                phosphor::logging::entry("LIMIT=%ju", maxPackageSize));
+            break;
+        }
+        if (!checkHeader(chunk.data(), size) ||
+            !writeChunk(chunk.data(), size))
+        {
+            break;
+        }
+        stagedBytes += size;
+    }
+
+    close(stagingFd);
+    stagingFd = -1;
+    if (!staged)
+    {
+        unlink(stagingFilePath.c_str());
+        return false;
+    }
+    phosphor::logging::log<phosphor::logging::level::INFO>(
+        "Firmware package staged",
+        phosphor::logging::entry("PATH=%s", stagingFilePath.c_str()),
+        phosphor::logging::entry("SIZE=%ju", stagedBytes));
+    return true;
+}
+
+} // namespace fwu
+} // namespace pldm
@@ -0,0 +1,127 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "fwu_package_validator.hpp"
+
+#include "pldm.hpp"
+#include "utils.hpp"
+
+#include <algorithm>
+#include <boost/asio/post.hpp>
+#include <phosphor-logging/log.hpp>
+
+namespace pldm
+{
+namespace fwu
+{
+
+// Bytes hashed before letting the other handlers run
+constexpr uint32_t validateChunkSize = 64 * 1024;
+
+FWUPackageValidator::FWUPackageValidator(
+    const PLDMImg& img, std::vector<FWUComponentRange> componentsVal,
+    FWUComponentDigests expectedDigestsVal) :
+    pldmImg(img),
+    components(std::move(componentsVal)),
+    expectedDigests(std::move(expectedDigestsVal)),
+    doneTimer(*getIoContext(), boost::asio::steady_timer::time_point::max())
+{
+}
+
+void FWUPackageValidator::start()
+{
+    boost::asio::spawn(*getIoContext(),
+                       [this](boost::asio::yield_context yield) {
+                           status = validateComponents(yield) ? Status::passed
+                                                              : Status::failed;
+                           doneTimer.cancel();
+                       });
+}
+
+bool FWUPackageValidator::validateComponents(
+    const boost::asio::yield_context yield)
+{
+    for (const FWUComponentRange& component : components)
+    {
+        if (!validateComponent(yield, component))
+        {
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                "Package validation failed",
+                phosphor::logging::entry("COMPONENT=%d", component.index));
+            return false;
+        }
+    }
+    phosphor::logging::log<phosphor::logging::level::INFO>(
+        ("Package validation passed. Components checked: " +
+         std::to_string(digests.size()))
+            .c_str());
+    return true;
+}
+
+bool FWUPackageValidator::validateComponent(
+    const boost::asio::yield_context yield, const FWUComponentRange& component)
+{
+    utils::Crc32 crc;
+    for (uint32_t offset = 0; offset < component.size;
+         offset += validateChunkSize)
+    {
+        uint32_t length = std::min(validateChunkSize, component.size - offset);
+        const uint8_t* data =
+            pldmImg.getData(component.location + offset, length);
+        if (!data)
+        {
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                "Component exceeds the package",
+                phosphor::logging::entry("COMPONENT=%d", component.index));
+            return false;
+        }
+        pldmImg.prefetchData(component.location + offset + length,
+                             validateChunkSize);
+        crc.update(data, length);
+        // Let the update sessions run in between
+        boost::asio::post(*getIoContext(), yield);
+    }
+    uint32_t digest = crc.value();
+    digests[component.index] = digest;
+
+    auto expected = expectedDigests.find(component.index);
+    if (expected != expectedDigests.end() && expected->second != digest)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Component digest mismatch",
+            phosphor::logging::entry("COMPONENT=%d", component.index),
+            phosphor::logging::entry("EXPECTED=0x%08X", expected->second),
+            phosphor::logging::entry("DIGEST=0x%08X", digest));
+        return false;
+    }
+    phosphor::logging::log<phosphor::logging::level::DEBUG>(
+        "Component digest", phosphor::logging::entry("COMPONENT=%d",
+                                                     component.index),
+        phosphor::logging::entry("DIGEST=0x%08X", digest));
+    return true;
+}
+
+bool FWUPackageValidator::wait(const boost::asio::yield_context yield)
+{
+    while (status == Status::pending)
+    {
+        boost::system::error_code ec;
+        doneTimer.async_wait(yield[ec]);
+    }
+    return status == Status::passed;
+}
+
+} // namespace fwu
+} // namespace pldm
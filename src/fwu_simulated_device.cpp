@@ -0,0 +1,415 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "fwu_simulated_device.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <phosphor-logging/log.hpp>
+
+namespace pldm
+{
+namespace fwu
+{
+
+// Time the device waits for a response of the UA before asking again
+constexpr std::chrono::milliseconds fdResponseTimeout{1000};
+
+// Attempts at a request before the device gives up on the UA
+constexpr size_t maxRequestAttempts = 10;
+
+// ComponentResponseCode of a component the device does not have
+constexpr uint8_t componentNotSupported = 0x06;
+
+static std::vector<uint8_t> createMessage(const bool request,
+                                          const uint8_t instance,
+                                          const uint8_t command)
+{
+    std::vector<uint8_t> message(hdrSize);
+    struct pldm_header_info header = {};
+    header.msg_type = request ? PLDM_REQUEST : PLDM_RESPONSE;
+    header.instance = instance;
+    header.pldm_type = PLDM_FWUP;
+    header.command = command;
+    pack_pldm_header(&header, reinterpret_cast<pldm_msg_hdr*>(message.data()));
+    return message;
+}
+
+/** @brief Append a field to a message, little endian*/
+template <typename T>
+static void appendField(std::vector<uint8_t>& message, const T value)
+{
+    for (size_t byte = 0; byte < sizeof(T); byte++)
+    {
+        message.push_back(static_cast<uint8_t>(value >> (byte * 8)));
+    }
+}
+
+/** @brief Read a little endian field of a payload*/
+template <typename T>
+static T readField(const uint8_t* payload, const size_t offset)
+{
+    T value = 0;
+    for (size_t byte = 0; byte < sizeof(T); byte++)
+    {
+        value = static_cast<T>(value | (static_cast<T>(payload[offset + byte])
+                                        << (byte * 8)));
+    }
+    return value;
+}
+
+static void delay(boost::asio::yield_context yield,
+                  const std::chrono::milliseconds duration)
+{
+    if (duration.count() == 0)
+    {
+        return;
+    }
+    boost::asio::steady_timer timer(*getIoContext(), duration);
+    boost::system::error_code ec;
+    timer.async_wait(yield[ec]);
+}
+
+FWUSimulatedDevice::FWUSimulatedDevice(const pldm_tid_t tidVal,
+                                       DescriptorsMap descriptorsVal,
+                                       std::set<ComponentKey> componentsVal,
+                                       const FWUSimulationConfig& configVal) :
+    tid(tidVal),
+    descriptors(std::move(descriptorsVal)),
+    components(std::move(componentsVal)), config(configVal),
+    responseTimer(*getIoContext())
+{
+}
+
+FDProperties FWUSimulatedDevice::getProperties() const
+{
+    return FDProperties{FWUProperties{}, descriptors, CompPropertiesMap{}};
+}
+
+void FWUSimulatedDevice::stop()
+{
+    stopped = true;
+    downloadGeneration++;
+    responseTimer.cancel();
+}
+
+void FWUSimulatedDevice::setState(const uint8_t nextState)
+{
+    previousState = state;
+    state = nextState;
+}
+
+bool FWUSimulatedDevice::isLost()
+{
+    messageCount++;
+    return config.errorInterval != 0 &&
+           messageCount % config.errorInterval == 0;
+}
+
+bool FWUSimulatedDevice::isCurrent(const uint64_t generation) const
+{
+    return !stopped && generation == downloadGeneration;
+}
+
+bool FWUSimulatedDevice::handleRequest(boost::asio::yield_context yield,
+                                       const uint16_t timeout,
+                                       const std::vector<uint8_t>& pldmReq,
+                                       std::vector<uint8_t>& pldmResp)
+{
+    if (stopped || pldmReq.size() < hdrSize)
+    {
+        return false;
+    }
+    std::chrono::milliseconds responseTimeout(timeout);
+    if (isLost() || config.latency > responseTimeout)
+    {
+        delay(yield, responseTimeout);
+        return false;
+    }
+    delay(yield, config.latency);
+
+    const struct pldm_msg_hdr* msgHdr =
+        reinterpret_cast<const pldm_msg_hdr*>(pldmReq.data());
+    pldmResp = createMessage(false, msgHdr->instance_id, msgHdr->command);
+    handleUpdateCommand(msgHdr->command, pldmReq.data() + hdrSize,
+                        pldmReq.size() - hdrSize, pldmResp);
+    return true;
+}
+
+void FWUSimulatedDevice::handleUpdateCommand(const uint8_t command,
+                                             const uint8_t* payload,
+                                             const size_t payloadLen,
+                                             std::vector<uint8_t>& pldmResp)
+{
+    switch (command)
+    {
+        case PLDM_REQUEST_UPDATE:
+            if (state != FD_IDLE)
+            {
+                pldmResp.push_back(ALREADY_IN_UPDATE_MODE);
+                return;
+            }
+            if (payloadLen < sizeof(uint32_t))
+            {
+                break;
+            }
+            // Request as much as the UA allows, like a device with large
+            // buffers
+            transferSize = std::max<uint32_t>(readField<uint32_t>(payload, 0),
+                                              PLDM_FWU_BASELINE_TRANSFER_SIZE);
+            setState(FD_LEARN_COMPONENTS);
+            pldmResp.push_back(PLDM_SUCCESS);
+            // No meta data and no package data to get
+            appendField<uint16_t>(pldmResp, 0);
+            pldmResp.push_back(0);
+            return;
+        case PLDM_PASS_COMPONENT_TABLE:
+        {
+            if (state != FD_LEARN_COMPONENTS)
+            {
+                pldmResp.push_back(COMMAND_NOT_EXPECTED);
+                return;
+            }
+            if (payloadLen < 5)
+            {
+                break;
+            }
+            uint8_t transferFlag = payload[0];
+            bool supported = components.count(
+                {readField<uint16_t>(payload, 1),
+                 readField<uint16_t>(payload, 3)}) != 0;
+            if (transferFlag & PLDM_END)
+            {
+                setState(FD_READY_XFER);
+            }
+            pldmResp.push_back(PLDM_SUCCESS);
+            pldmResp.push_back(supported ? 0 : 1);
+            pldmResp.push_back(supported ? 0 : componentNotSupported);
+            return;
+        }
+        case PLDM_UPDATE_COMPONENT:
+        {
+            if (state != FD_READY_XFER)
+            {
+                pldmResp.push_back(COMMAND_NOT_EXPECTED);
+                return;
+            }
+            if (payloadLen < 13)
+            {
+                break;
+            }
+            bool supported = components.count(
+                {readField<uint16_t>(payload, 0),
+                 readField<uint16_t>(payload, 2)}) != 0;
+            pldmResp.push_back(PLDM_SUCCESS);
+            pldmResp.push_back(supported ? COMPONENT_CAN_BE_UPDATED : 1);
+            pldmResp.push_back(supported ? 0 : componentNotSupported);
+            appendField<uint32_t>(pldmResp, 0);
+            appendField<uint16_t>(pldmResp, 0);
+            if (!supported)
+            {
+                return;
+            }
+            componentSize = readField<uint32_t>(payload, 9);
+            setState(FD_DOWNLOAD);
+            // Requests go out once the response is delivered
+            boost::asio::spawn(
+                *getIoContext(),
+                [self = shared_from_this(), generation = ++downloadGeneration](
+                    boost::asio::yield_context yield) {
+                    self->runComponentUpdate(yield, generation);
+                });
+            return;
+        }
+        case PLDM_ACTIVATE_FIRMWARE:
+            if (state != FD_READY_XFER)
+            {
+                pldmResp.push_back(COMMAND_NOT_EXPECTED);
+                return;
+            }
+            activated = true;
+            setState(FD_IDLE);
+            pldmResp.push_back(PLDM_SUCCESS);
+            appendField<uint16_t>(pldmResp, 0);
+            return;
+        case PLDM_GET_STATUS:
+            pldmResp.push_back(PLDM_SUCCESS);
+            pldmResp.push_back(state);
+            pldmResp.push_back(previousState);
+            // Aux state and its status, progress and reason code
+            pldmResp.insert(pldmResp.end(), 4, 0);
+            appendField<uint32_t>(pldmResp, 0);
+            return;
+        case PLDM_CANCEL_UPDATE_COMPONENT:
+            if (state != FD_DOWNLOAD && state != FD_VERIFY &&
+                state != FD_APPLY)
+            {
+                pldmResp.push_back(COMMAND_NOT_EXPECTED);
+                return;
+            }
+            downloadGeneration++;
+            setState(FD_READY_XFER);
+            pldmResp.push_back(PLDM_SUCCESS);
+            return;
+        case PLDM_CANCEL_UPDATE:
+            if (state == FD_IDLE)
+            {
+                pldmResp.push_back(NOT_IN_UPDATE_MODE);
+                return;
+            }
+            downloadGeneration++;
+            setState(FD_IDLE);
+            pldmResp.push_back(PLDM_SUCCESS);
+            // Components stay functional
+            pldmResp.push_back(0);
+            appendField<uint64_t>(pldmResp, 0);
+            return;
+        default:
+            pldmResp.push_back(PLDM_ERROR_UNSUPPORTED_PLDM_CMD);
+            return;
+    }
+    pldmResp.push_back(PLDM_ERROR_INVALID_LENGTH);
+}
+
+void FWUSimulatedDevice::handleMessage(const uint8_t /*msgTag*/,
+                                       const bool tagOwner,
+                                       const std::vector<uint8_t>& payload)
+{
+    if (tagOwner || !responsePending || payload.size() < hdrSize)
+    {
+        return;
+    }
+    const struct pldm_msg_hdr* msgHdr =
+        reinterpret_cast<const pldm_msg_hdr*>(payload.data());
+    if (msgHdr->instance_id != pendingInstanceId || isLost())
+    {
+        return;
+    }
+    pendingResp = payload;
+    // The UA goes on as soon as it responded, so does the device
+    if (pendingState)
+    {
+        setState(*pendingState);
+    }
+    responseTimer.cancel();
+}
+
+bool FWUSimulatedDevice::sendRequest(boost::asio::yield_context yield,
+                                     const uint64_t generation,
+                                     std::vector<uint8_t>& pldmReq,
+                                     std::vector<uint8_t>& pldmResp,
+                                     const std::optional<uint8_t> nextState)
+{
+    for (size_t attempt = 0; attempt < maxRequestAttempts; attempt++)
+    {
+        if (!isCurrent(generation))
+        {
+            return false;
+        }
+        instanceId = static_cast<uint8_t>((instanceId + 1) &
+                                          PLDM_INSTANCE_ID_MASK);
+        reinterpret_cast<pldm_msg_hdr*>(pldmReq.data())->instance_id =
+            instanceId & PLDM_INSTANCE_ID_MASK;
+        pendingInstanceId = instanceId;
+        pendingState = nextState;
+        pendingResp.clear();
+        responsePending = true;
+        if (!isLost())
+        {
+            // The UA takes the request as sent by a discovered terminus
+            std::vector<uint8_t> request = pldmReq;
+            uint8_t msgTag = static_cast<uint8_t>(instanceId & 0x07);
+            pldmMsgRecvFwUpdCallback(tid, msgTag, true, request);
+        }
+        if (pendingResp.empty())
+        {
+            boost::system::error_code ec;
+            responseTimer.expires_after(fdResponseTimeout);
+            responseTimer.async_wait(yield[ec]);
+        }
+        responsePending = false;
+        if (pendingResp.size() > hdrSize)
+        {
+            pldmResp = std::move(pendingResp);
+            return true;
+        }
+    }
+    phosphor::logging::log<phosphor::logging::level::WARNING>(
+        "Simulated FD got no response from the UA",
+        phosphor::logging::entry("TID=%d", tid));
+    return false;
+}
+
+void FWUSimulatedDevice::runComponentUpdate(boost::asio::yield_context yield,
+                                            const uint64_t generation)
+{
+    std::vector<uint8_t> pldmResp;
+    uint32_t offset = 0;
+    while (offset < componentSize)
+    {
+        delay(yield, config.latency);
+        std::vector<uint8_t> pldmReq =
+            createMessage(true, 0, PLDM_REQUEST_FIRMWARE_DATA);
+        appendField<uint32_t>(pldmReq, offset);
+        appendField<uint32_t>(pldmReq, transferSize);
+        if (!sendRequest(yield, generation, pldmReq, pldmResp))
+        {
+            // The UA resumes or cancels the component
+            return;
+        }
+        uint8_t completionCode = pldmResp[hdrSize];
+        if (completionCode == RETRY_REQUEST_FW_DATA)
+        {
+            continue;
+        }
+        if (completionCode != PLDM_SUCCESS)
+        {
+            phosphor::logging::log<phosphor::logging::level::WARNING>(
+                "Simulated FD firmware data refused",
+                phosphor::logging::entry("TID=%d", tid),
+                phosphor::logging::entry("CC=%d", completionCode));
+            return;
+        }
+        receivedBytes += std::min(transferSize, componentSize - offset);
+        offset += transferSize;
+    }
+
+    // Each completion is reported with success, the next phase starts once
+    // the UA acknowledged it
+    std::vector<uint8_t> pldmReq =
+        createMessage(true, 0, PLDM_TRANSFER_COMPLETE);
+    pldmReq.push_back(PLDM_FWU_TRASFER_SUCCESS);
+    if (!sendRequest(yield, generation, pldmReq, pldmResp, FD_VERIFY))
+    {
+        return;
+    }
+
+    delay(yield, config.latency);
+    pldmReq = createMessage(true, 0, PLDM_VERIFY_COMPLETE);
+    pldmReq.push_back(PLDM_FWU_VERIFY_SUCCESS);
+    if (!sendRequest(yield, generation, pldmReq, pldmResp, FD_APPLY))
+    {
+        return;
+    }
+
+    delay(yield, config.latency);
+    pldmReq = createMessage(true, 0, PLDM_APPLY_COMPLETE);
+    pldmReq.push_back(PLDM_FWU_APPLY_SUCCESS);
+    appendField<uint16_t>(pldmReq, 0);
+    sendRequest(yield, generation, pldmReq, pldmResp, FD_READY_XFER);
+}
+
+} // namespace fwu
+} // namespace pldm
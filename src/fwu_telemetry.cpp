@@ -0,0 +1,213 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "fwu_telemetry.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <string>
+
+namespace pldm
+{
+namespace fwu
+{
+
+static constexpr std::array<const char*, static_cast<size_t>(FWUPhase::count)>
+    phaseNames{"Idle",     "RequestUpdate", "PassComponentTable",
+               "Download", "Verify",        "Apply",
+               "Activate", "Complete",      "Failed"};
+
+// Download time below which the transfer rate is not trusted
+constexpr std::chrono::seconds minMeasuredDownloadTime{1};
+
+// Interval in between the D-Bus updates of the counters
+constexpr std::chrono::seconds publishInterval{1};
+
+// Transfer rate measured by the last update session of each FD
+static std::map<pldm_tid_t, double> observedThroughput;
+
+FWUTelemetry::FWUTelemetry(const pldm_tid_t tidVal) :
+    tid(tidVal), phaseStart(std::chrono::steady_clock::now())
+{
+    const std::string objPath =
+        "/xyz/openbmc_project/pldm/fwu/" + std::to_string(tid);
+    statsInterface = addUniqueInterface(
+        objPath, "xyz.openbmc_project.PLDM.FWU.UpdateStatistics");
+    statsInterface->register_property(
+        "Phase", std::string(phaseNames[static_cast<size_t>(phase)]));
+    statsInterface->register_property("PhaseDurations",
+                                      std::map<std::string, uint64_t>{});
+    statsInterface->register_property("TotalBytes", totalBytes);
+    statsInterface->register_property("TransferredBytes", transferredBytes);
+    statsInterface->register_property(
+        "BytesPerSecond", std::numeric_limits<double>::quiet_NaN());
+    statsInterface->register_property(
+        "EstimatedSecondsRemaining", std::numeric_limits<double>::quiet_NaN());
+    statsInterface->register_property("FirmwareDataRequests", requestCount);
+    statsInterface->register_property("FirmwareDataRetries", retryCount);
+    statsInterface->register_property("FirmwareDataTimeouts", timeoutCount);
+    statsInterface->initialize();
+}
+
+FWUTelemetry::~FWUTelemetry()
+{
+    getObjServer()->remove_interface(std::move(statsInterface));
+}
+
+void FWUTelemetry::setTotalBytes(const uint64_t bytes)
+{
+    totalBytes = bytes;
+    publish(true);
+}
+
+void FWUTelemetry::startPhase(const FWUPhase nextPhase)
+{
+    auto now = std::chrono::steady_clock::now();
+    phaseDurations[static_cast<size_t>(phase)] += now - phaseStart;
+    phase = nextPhase;
+    phaseStart = now;
+
+    if (phase == FWUPhase::complete || phase == FWUPhase::failed)
+    {
+        if (std::optional<double> bytesPerSec = getBytesPerSecond())
+        {
+            observedThroughput[tid] = *bytesPerSec;
+        }
+    }
+    publish(true);
+}
+
+void FWUTelemetry::startComponent()
+{
+    componentHighWater = 0;
+}
+
+void FWUTelemetry::recordFirmwareData(const uint32_t offset,
+                                      const uint32_t length,
+                                      const uint32_t componentSize)
+{
+    requestCount++;
+    if (offset < componentHighWater)
+    {
+        retryCount++;
+    }
+    // Padding requested past the end of the component is not transferred
+    uint32_t end = offset + std::min(length, componentSize - offset);
+    if (end > componentHighWater)
+    {
+        transferredBytes += end - std::max(offset, componentHighWater);
+        componentHighWater = end;
+    }
+    publish(false);
+}
+
+void FWUTelemetry::recordTimeout()
+{
+    timeoutCount++;
+    publish(true);
+}
+
+std::chrono::steady_clock::duration FWUTelemetry::getDownloadTime() const
+{
+    auto downloadTime =
+        phaseDurations[static_cast<size_t>(FWUPhase::download)];
+    if (phase == FWUPhase::download)
+    {
+        downloadTime += std::chrono::steady_clock::now() - phaseStart;
+    }
+    return downloadTime;
+}
+
+std::optional<double> FWUTelemetry::getBytesPerSecond() const
+{
+    auto downloadTime = getDownloadTime();
+    if (downloadTime < minMeasuredDownloadTime || transferredBytes == 0)
+    {
+        return std::nullopt;
+    }
+    return static_cast<double>(transferredBytes) /
+           std::chrono::duration<double>(downloadTime).count();
+}
+
+uint64_t FWUTelemetry::getRemainingBytes() const
+{
+    return totalBytes > transferredBytes ? totalBytes - transferredBytes : 0;
+}
+
+std::optional<double> FWUTelemetry::getObservedThroughput(const pldm_tid_t tid)
+{
+    auto it = observedThroughput.find(tid);
+    if (it == observedThroughput.end())
+    {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void FWUTelemetry::forgetObservedThroughput(const pldm_tid_t tid)
+{
+    observedThroughput.erase(tid);
+}
+
+void FWUTelemetry::publish(const bool force)
+{
+    auto now = std::chrono::steady_clock::now();
+    if (!force && now - lastPublished < publishInterval)
+    {
+        return;
+    }
+    lastPublished = now;
+
+    std::map<std::string, uint64_t> durations;
+    for (size_t index = 0; index < phaseDurations.size(); index++)
+    {
+        auto duration = phaseDurations[index];
+        if (index == static_cast<size_t>(phase))
+        {
+            duration += now - phaseStart;
+        }
+        if (duration.count() != 0)
+        {
+            durations[phaseNames[index]] = static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(duration)
+                    .count());
+        }
+    }
+
+    double bytesPerSec = std::numeric_limits<double>::quiet_NaN();
+    double secondsRemaining = std::numeric_limits<double>::quiet_NaN();
+    if (std::optional<double> measured = getBytesPerSecond())
+    {
+        bytesPerSec = *measured;
+        secondsRemaining =
+            static_cast<double>(getRemainingBytes()) / bytesPerSec;
+    }
+
+    statsInterface->set_property(
+        "Phase", std::string(phaseNames[static_cast<size_t>(phase)]));
+    statsInterface->set_property("PhaseDurations", durations);
+    statsInterface->set_property("TotalBytes", totalBytes);
+    statsInterface->set_property("TransferredBytes", transferredBytes);
+    statsInterface->set_property("BytesPerSecond", bytesPerSec);
+    statsInterface->set_property("EstimatedSecondsRemaining",
+                                 secondsRemaining);
+    statsInterface->set_property("FirmwareDataRequests", requestCount);
+    statsInterface->set_property("FirmwareDataRetries", retryCount);
+    statsInterface->set_property("FirmwareDataTimeouts", timeoutCount);
+}
+
+} // namespace fwu
+} // namespace pldm
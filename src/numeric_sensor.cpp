@@ -16,6 +16,8 @@
 
 #include "numeric_sensor.hpp"
 
+#include "utils.hpp"
+
 #include <limits>
 #include <phosphor-logging/log.hpp>
 #include <regex>
@@ -24,6 +26,8 @@ constexpr const char* availableInterfaceName =
     "xyz.openbmc_project.State.Decorator.Availability";
 constexpr const char* operationalInterfaceName =
     "xyz.openbmc_project.State.Decorator.OperationalStatus";
+constexpr const char* timestampInterfaceName =
+    "xyz.openbmc_project.PLDM.SensorTimestamp";
 constexpr const size_t errorThreshold = 3;
 
 NumericSensor::NumericSensor(const std::string& sensorName,
@@ -223,6 +227,21 @@ void NumericSensor::setInitialProperties(bool sensorDisabled)
         conn, sensorInterface->get_object_path(), operationalInterfaceName);
     operationalInterface->register_property("Functional", !sensorDisabled);
     operationalInterface->initialize();
+
+    // LastUpdated is computed on read to avoid a PropertiesChanged signal on
+    // every sensor poll
+    timestampInterface = std::make_shared<sdbusplus::asio::dbus_interface>(
+        conn, sensorInterface->get_object_path(), timestampInterfaceName);
+    timestampInterface->register_property(
+        "LastUpdated", static_cast<uint64_t>(0),
+        [](const uint64_t&, uint64_t&) -> int {
+            throw sdbusplus::exception::SdBusError(-EPERM,
+                                                   "LastUpdated is read only");
+        },
+        [this](const uint64_t&) {
+            return utils::toEpochMicroseconds(lastUpdated);
+        });
+    timestampInterface->initialize();
 }
 
 void NumericSensor::markFunctional(bool isFunctional)
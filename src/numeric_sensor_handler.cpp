@@ -44,6 +44,33 @@ bool NumericSensorHandler::sensorErrorCheck()
     return false;
 }
 
+void NumericSensorHandler::resetErrorCount()
+{
+    if (_sensor)
+    {
+        _sensor->errCount = 0;
+    }
+}
+
+std::chrono::steady_clock::time_point
+    NumericSensorHandler::getLastUpdated() const
+{
+    if (_sensor)
+    {
+        return _sensor->lastUpdated;
+    }
+    return {};
+}
+
+double NumericSensorHandler::getValue() const
+{
+    if (_sensor)
+    {
+        return _sensor->value;
+    }
+    return std::numeric_limits<double>::quiet_NaN();
+}
+
 bool NumericSensorHandler::setNumericSensorEnable(
     boost::asio::yield_context yield)
 {
@@ -338,7 +365,8 @@ bool NumericSensorHandler::handleSensorReading(
     return true;
 }
 
-bool NumericSensorHandler::getSensorReading(boost::asio::yield_context yield)
+bool NumericSensorHandler::getSensorReading(
+    boost::asio::yield_context yield, const MessagePriority priority)
 {
     int rc;
     std::vector<uint8_t> req(pldmMsgHdrSize +
@@ -356,7 +384,7 @@ bool NumericSensorHandler::getSensorReading(boost::asio::yield_context yield)
 
     std::vector<uint8_t> resp;
     if (!sendReceivePldmMessage(yield, _tid, commandTimeout, commandRetryCount,
-                                req, resp))
+                                req, resp, std::nullopt, priority))
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "Failed to send or receive GetSensorReading request",
@@ -389,7 +417,8 @@ bool NumericSensorHandler::getSensorReading(boost::asio::yield_context yield)
                                presentReading);
 }
 
-bool NumericSensorHandler::populateSensorValue(boost::asio::yield_context yield)
+bool NumericSensorHandler::populateSensorValue(
+    boost::asio::yield_context yield, const MessagePriority priority)
 {
     // No need to read the sensor if it is disabled
     if (_pdr->sensor_init == PLDM_SENSOR_DISABLE)
@@ -400,11 +429,12 @@ bool NumericSensorHandler::populateSensorValue(boost::asio::yield_context yield)
     {
         return false;
     }
-    if (!getSensorReading(yield))
+    if (!getSensorReading(yield, priority))
     {
         _sensor->incrementError();
         return false;
     }
+    _sensor->lastUpdated = std::chrono::steady_clock::now();
     return true;
 }
 
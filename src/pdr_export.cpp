@@ -0,0 +1,424 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "pdr_export.hpp"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <boost/asio/posix/stream_descriptor.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/write.hpp>
+#include <cerrno>
+#include <fstream>
+#include <iterator>
+#include <phosphor-logging/log.hpp>
+
+#include "platform.h"
+
+namespace pldm
+{
+namespace platform
+{
+
+constexpr std::array<uint8_t, 4> exportMagic = {'P', 'D', 'R', 'X'};
+constexpr uint8_t exportVersion = 0x01;
+// Magic, version, TID, 2 reserved bytes and record count
+constexpr size_t exportHeaderSize = 12;
+constexpr size_t exportChunkSize = 4096;
+
+/** @brief Leading fields shared by sensor and effecter PDRs*/
+struct SensorEffecterPDRPrefix
+{
+    pldm_pdr_hdr hdr;
+    uint16_t terminusHandle;
+    uint16_t id;
+    uint16_t entityType;
+    uint16_t entityInstanceNum;
+    uint16_t containerID;
+} __attribute__((packed));
+
+std::optional<PDRExportFormat> toPDRExportFormat(const std::string& format)
+{
+    if (format == "binary")
+    {
+        return PDRExportFormat::binary;
+    }
+    if (format == "json")
+    {
+        return PDRExportFormat::json;
+    }
+    return std::nullopt;
+}
+
+static void appendLE32(std::vector<uint8_t>& buffer, const uint32_t value)
+{
+    for (size_t byte = 0; byte < sizeof(value); byte++)
+    {
+        buffer.push_back(static_cast<uint8_t>(value >> (byte * 8)));
+    }
+}
+
+static uint32_t readLE32(const uint8_t* data)
+{
+    return static_cast<uint32_t>(data[0]) |
+           (static_cast<uint32_t>(data[1]) << 8) |
+           (static_cast<uint32_t>(data[2]) << 16) |
+           (static_cast<uint32_t>(data[3]) << 24);
+}
+
+static void appendString(std::vector<uint8_t>& buffer, const std::string& str)
+{
+    buffer.insert(buffer.end(), str.begin(), str.end());
+}
+
+static void appendJSONField(std::vector<uint8_t>& buffer,
+                            const std::string& name, const uint32_t value)
+{
+    appendString(buffer, "\"" + name + "\":" + std::to_string(value) + ",");
+}
+
+static void appendBinaryRecord(std::vector<uint8_t>& buffer,
+                               const uint8_t* pdrData, const uint32_t pdrSize)
+{
+    appendLE32(buffer, pdrSize);
+    buffer.insert(buffer.end(), pdrData, pdrData + pdrSize);
+}
+
+static void appendJSONRecord(std::vector<uint8_t>& buffer,
+                             const uint8_t* pdrData, const uint32_t pdrSize,
+                             const bool firstRecord)
+{
+    static constexpr std::array<char, 16> hexDigits = {
+        '0', '1', '2', '3', '4', '5', '6', '7',
+        '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
+
+    appendString(buffer, firstRecord ? "\n{" : ",\n{");
+    if (pdrSize >= sizeof(pldm_pdr_hdr))
+    {
+        const pldm_pdr_hdr* pdrHdr =
+            reinterpret_cast<const pldm_pdr_hdr*>(pdrData);
+        appendJSONField(buffer, "RecordHandle", le32toh(pdrHdr->record_handle));
+        appendJSONField(buffer, "Version", pdrHdr->version);
+        appendJSONField(buffer, "Type", pdrHdr->type);
+        appendJSONField(buffer, "RecordChangeNumber",
+                        le16toh(pdrHdr->record_change_num));
+
+        bool sensorPDR = pdrHdr->type == PLDM_NUMERIC_SENSOR_PDR ||
+                         pdrHdr->type == PLDM_STATE_SENSOR_PDR;
+        bool effecterPDR = pdrHdr->type == PLDM_NUMERIC_EFFECTER_PDR ||
+                           pdrHdr->type == PLDM_STATE_EFFECTER_PDR;
+        if ((sensorPDR || effecterPDR) &&
+            pdrSize >= sizeof(SensorEffecterPDRPrefix))
+        {
+            const SensorEffecterPDRPrefix* prefix =
+                reinterpret_cast<const SensorEffecterPDRPrefix*>(pdrData);
+            appendJSONField(buffer, sensorPDR ? "SensorID" : "EffecterID",
+                            le16toh(prefix->id));
+            appendJSONField(buffer, "EntityType", le16toh(prefix->entityType));
+            appendJSONField(buffer, "EntityInstanceNumber",
+                            le16toh(prefix->entityInstanceNum));
+            appendJSONField(buffer, "ContainerID",
+                            le16toh(prefix->containerID));
+        }
+    }
+    appendJSONField(buffer, "Length", pdrSize);
+
+    appendString(buffer, "\"Data\":\"");
+    for (const uint8_t* byte = pdrData; byte != pdrData + pdrSize; byte++)
+    {
+        buffer.push_back(static_cast<uint8_t>(hexDigits[*byte >> 4]));
+        buffer.push_back(static_cast<uint8_t>(hexDigits[*byte & 0x0F]));
+    }
+    appendString(buffer, "\"}");
+}
+
+/** @brief Write the whole buffer to a blocking fd*/
+static bool writeAll(const int fd, const std::vector<uint8_t>& chunk)
+{
+    size_t offset = 0;
+    while (offset < chunk.size())
+    {
+        ssize_t written =
+            ::write(fd, chunk.data() + offset, chunk.size() - offset);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        offset += static_cast<size_t>(written);
+    }
+    return true;
+}
+
+/** @brief Writes the export chunks to the destination fd*/
+class ExportWriter
+{
+  public:
+    ExportWriter(const int fd) : stream(*getIoContext())
+    {
+        // Regular files can not be polled, write those directly
+        struct stat fdStat;
+        if (fstat(fd, &fdStat) == 0 && S_ISREG(fdStat.st_mode))
+        {
+            fileFd = fd;
+            return;
+        }
+
+        boost::system::error_code ec;
+        stream.assign(fd, ec);
+        if (ec)
+        {
+            fileFd = fd;
+        }
+    }
+
+    ~ExportWriter()
+    {
+        if (fileFd >= 0)
+        {
+            close(fileFd);
+        }
+    }
+
+    ExportWriter(const ExportWriter&) = delete;
+    ExportWriter& operator=(const ExportWriter&) = delete;
+
+    bool write(boost::asio::yield_context yield,
+               const std::vector<uint8_t>& chunk)
+    {
+        if (fileFd < 0)
+        {
+            boost::system::error_code ec;
+            boost::asio::async_write(stream, boost::asio::buffer(chunk),
+                                     yield[ec]);
+            return !ec;
+        }
+
+        // Disk writes may block, keep those off the io_context thread. The
+        // chunk outlives the write since the coroutine waits for it.
+        static boost::asio::thread_pool fileWriter(1);
+        auto writeDone = std::make_shared<boost::asio::steady_timer>(
+            *getIoContext(), boost::asio::steady_timer::time_point::max());
+        auto success = std::make_shared<bool>(false);
+        boost::asio::post(fileWriter, [fd = fileFd, &chunk, writeDone,
+                                       success]() {
+            *success = writeAll(fd, chunk);
+            boost::asio::post(writeDone->get_executor(),
+                              [writeDone]() { writeDone->cancel(); });
+        });
+        boost::system::error_code ec;
+        writeDone->async_wait(yield[ec]);
+        return *success;
+    }
+
+  private:
+    boost::asio::posix::stream_descriptor stream;
+    int fileFd = -1;
+};
+
+bool exportPDRs(boost::asio::yield_context yield, const pldm_tid_t tid,
+                const std::shared_ptr<pldm_pdr>& repo, const int fd,
+                const PDRExportFormat format)
+{
+    ExportWriter writer(fd);
+    uint32_t recordCount = pldm_pdr_get_record_count(repo.get());
+
+    std::vector<uint8_t> chunk;
+    chunk.reserve(exportChunkSize);
+    if (format == PDRExportFormat::binary)
+    {
+        chunk.insert(chunk.end(), exportMagic.begin(), exportMagic.end());
+        chunk.push_back(exportVersion);
+        chunk.push_back(tid);
+        chunk.push_back(0x00);
+        chunk.push_back(0x00);
+        appendLE32(chunk, recordCount);
+    }
+    else
+    {
+        appendString(chunk, "{\"TID\":" + std::to_string(tid) +
+                                ",\"RecordCount\":" +
+                                std::to_string(recordCount) + ",\"Records\":[");
+    }
+
+    uint8_t* pdrData = nullptr;
+    uint32_t pdrSize{};
+    uint32_t nextRecordHandle{};
+    uint32_t exportedCount = 0;
+    // Record handle 0 fetches the first record in the repo
+    auto record = pldm_pdr_find_record(repo.get(), 0, &pdrData, &pdrSize,
+                                       &nextRecordHandle);
+    while (record)
+    {
+        if (format == PDRExportFormat::binary)
+        {
+            appendBinaryRecord(chunk, pdrData, pdrSize);
+        }
+        else
+        {
+            appendJSONRecord(chunk, pdrData, pdrSize, exportedCount == 0);
+        }
+        ++exportedCount;
+
+        if (chunk.size() >= exportChunkSize)
+        {
+            if (!writer.write(yield, chunk))
+            {
+                phosphor::logging::log<phosphor::logging::level::ERR>(
+                    "Failed to write PDR export",
+                    phosphor::logging::entry("TID=%d", tid));
+                return false;
+            }
+            chunk.clear();
+        }
+
+        pdrData = nullptr;
+        pdrSize = 0;
+        record = pldm_pdr_get_next_record(repo.get(), record, &pdrData,
+                                          &pdrSize, &nextRecordHandle);
+    }
+
+    if (format == PDRExportFormat::json)
+    {
+        appendString(chunk, "\n]}\n");
+    }
+    if (!chunk.empty() && !writer.write(yield, chunk))
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Failed to write PDR export",
+            phosphor::logging::entry("TID=%d", tid));
+        return false;
+    }
+
+    phosphor::logging::log<phosphor::logging::level::INFO>(
+        "PDR export complete", phosphor::logging::entry("TID=%d", tid),
+        phosphor::logging::entry("RECORD_COUNT=%d", exportedCount));
+    return true;
+}
+
+std::optional<std::unordered_map<uint32_t, std::vector<uint8_t>>>
+    loadPDRExport(const std::string& fileName)
+{
+    std::ifstream exportFile(fileName, std::ios::binary);
+    if (!exportFile)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Unable to open PDR export",
+            phosphor::logging::entry("FILE=%s", fileName.c_str()));
+        return std::nullopt;
+    }
+    std::vector<uint8_t> content((std::istreambuf_iterator<char>(exportFile)),
+                                 std::istreambuf_iterator<char>());
+
+    if (content.size() < exportHeaderSize ||
+        !std::equal(exportMagic.begin(), exportMagic.end(), content.begin()) ||
+        content[exportMagic.size()] != exportVersion)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Invalid PDR export header",
+            phosphor::logging::entry("FILE=%s", fileName.c_str()));
+        return std::nullopt;
+    }
+    uint32_t recordCount = readLE32(content.data() + 8);
+
+    std::unordered_map<uint32_t, std::vector<uint8_t>> records;
+    size_t offset = exportHeaderSize;
+    while (offset < content.size())
+    {
+        if (content.size() - offset < sizeof(uint32_t))
+        {
+            break;
+        }
+        uint32_t pdrSize = readLE32(content.data() + offset);
+        offset += sizeof(uint32_t);
+        if (pdrSize < sizeof(pldm_pdr_hdr) || content.size() - offset < pdrSize)
+        {
+            break;
+        }
+
+        const pldm_pdr_hdr* pdrHdr =
+            reinterpret_cast<const pldm_pdr_hdr*>(content.data() + offset);
+        if (sizeof(pldm_pdr_hdr) + le16toh(pdrHdr->length) != pdrSize)
+        {
+            break;
+        }
+        auto pdrBegin = content.begin() + static_cast<std::ptrdiff_t>(offset);
+        if (!records
+                 .try_emplace(le32toh(pdrHdr->record_handle), pdrBegin,
+                              pdrBegin + pdrSize)
+                 .second)
+        {
+            // Duplicate record handle
+            break;
+        }
+        offset += pdrSize;
+    }
+
+    if (offset != content.size() || records.size() != recordCount)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Invalid PDR export records",
+            phosphor::logging::entry("FILE=%s", fileName.c_str()));
+        return std::nullopt;
+    }
+    return records;
+}
+
+bool matchesPDRRepo(
+    const std::shared_ptr<pldm_pdr>& repo,
+    const std::unordered_map<uint32_t, std::vector<uint8_t>>& records)
+{
+    if (pldm_pdr_get_record_count(repo.get()) != records.size())
+    {
+        return false;
+    }
+
+    uint8_t* pdrData = nullptr;
+    uint32_t pdrSize{};
+    uint32_t nextRecordHandle{};
+    auto record = pldm_pdr_find_record(repo.get(), 0, &pdrData, &pdrSize,
+                                       &nextRecordHandle);
+    while (record)
+    {
+        if (pdrSize < sizeof(pldm_pdr_hdr))
+        {
+            return false;
+        }
+        const pldm_pdr_hdr* pdrHdr = reinterpret_cast<pldm_pdr_hdr*>(pdrData);
+        auto it = records.find(le32toh(pdrHdr->record_handle));
+        if (it == records.end() ||
+            !std::equal(it->second.begin(), it->second.end(), pdrData,
+                        pdrData + pdrSize))
+        {
+            return false;
+        }
+
+        pdrData = nullptr;
+        pdrSize = 0;
+        record = pldm_pdr_get_next_record(repo.get(), record, &pdrData,
+                                          &pdrSize, &nextRecordHandle);
+    }
+    return true;
+}
+
+} // namespace platform
+} // namespace pldm
@@ -21,10 +21,11 @@
 #include "pldm.hpp"
 #include "utils.hpp"
 
+#include <fcntl.h>
+
 #include <codecvt>
-#include <fstream>
+#include <cstring>
 #include <phosphor-logging/log.hpp>
-#include <queue>
 #include <regex>
 
 #include "utils.h"
@@ -515,7 +516,7 @@ static std::optional<std::string> getAuxName(const uint8_t nameStrCount,
     return std::nullopt;
 }
 
-void PDRManager::parseEntityAuxNamesPDR(std::vector<uint8_t>& pdrData)
+void PDRManager::parseEntityAuxNamesPDR(const PDRView& pdr)
 {
     constexpr size_t sharedNameCountSize = 1;
     constexpr size_t nameStringCountSize = 1;
@@ -523,15 +524,16 @@ void PDRManager::parseEntityAuxNamesPDR(std::vector<uint8_t>& pdrData)
         sizeof(pldm_pdr_hdr) + sizeof(pldm_entity) + sharedNameCountSize +
         nameStringCountSize;
 
-    if (pdrData.size() >= minEntityAuxNamesPDRLen)
+    if (pdr.size >= minEntityAuxNamesPDRLen)
     {
-        pldm_pdr_entity_auxiliary_names* namePDR =
-            reinterpret_cast<pldm_pdr_entity_auxiliary_names*>(pdrData.data());
-        LE16TOH(namePDR->entity.entity_type);
-        LE16TOH(namePDR->entity.entity_instance_num);
-        LE16TOH(namePDR->entity.entity_container_id);
+        const pldm_pdr_entity_auxiliary_names* namePDR =
+            reinterpret_cast<const pldm_pdr_entity_auxiliary_names*>(pdr.data);
+        pldm_entity entity = {
+            le16toh(namePDR->entity.entity_type),
+            le16toh(namePDR->entity.entity_instance_num),
+            le16toh(namePDR->entity.entity_container_id)};
 
-        size_t auxNamesLen = pdrData.size() - minEntityAuxNamesPDRLen;
+        size_t auxNamesLen = pdr.size - minEntityAuxNamesPDRLen;
 
         auto name = getAuxName(namePDR->name_string_count, auxNamesLen,
                                namePDR->entity_auxiliary_names);
@@ -546,7 +548,7 @@ void PDRManager::parseEntityAuxNamesPDR(std::vector<uint8_t>& pdrData)
         if (namePDR->shared_name_count <= 0)
         {
             // Cache the Entity Auxiliary Names
-            _entityAuxNames.emplace(namePDR->entity, *name);
+            _entityAuxNames.emplace(entity, *name);
 
             phosphor::logging::log<phosphor::logging::level::DEBUG>(
                 ("Entity Auxiliary Name: " + *name).c_str());
@@ -554,18 +556,18 @@ void PDRManager::parseEntityAuxNamesPDR(std::vector<uint8_t>& pdrData)
         }
 
         // entity_instance_num gives starting value of the range
-        uint16_t instanceNumber = namePDR->entity.entity_instance_num;
+        uint16_t instanceNumber = entity.entity_instance_num;
         uint16_t count = 0;
         // e.g. sharedNameCount = 2 & entity_instance_num = 100, actually means
         // entity_instance range {100,101,102}
-        while (instanceNumber <= (namePDR->entity.entity_instance_num +
-                                  namePDR->shared_name_count))
+        while (instanceNumber <=
+               (entity.entity_instance_num + namePDR->shared_name_count))
         {
 
             std::string auxName = *name;
             auxName.append("_").append(std::to_string(count));
 
-            _entityAuxNames.emplace(namePDR->entity, auxName);
+            _entityAuxNames.emplace(entity, auxName);
 
             phosphor::logging::log<phosphor::logging::level::DEBUG>(
                 ("Entity Auxiliary Name: " + *name).c_str());
@@ -575,252 +577,40 @@ void PDRManager::parseEntityAuxNamesPDR(std::vector<uint8_t>& pdrData)
     }
 }
 
-// Create Entity Association node from parsed Entity Association PDR
-static bool getEntityAssociation(const std::shared_ptr<pldm_entity[]>& entities,
-                                 const size_t numEntities,
-                                 EntityNode::NodePtr& entityAssociation)
-{
-    if (!(0 < numEntities) || !entities)
-    {
-        phosphor::logging::log<phosphor::logging::level::WARNING>(
-            "No entities in Entity Association PDR");
-        return false;
-    }
-    entityAssociation = std::make_shared<EntityNode>();
-    entityAssociation->containerEntity = entities[0];
-
-    for (size_t count = 1; count < numEntities; count++)
-    {
-        EntityNode::NodePtr containedPtr = std::make_shared<EntityNode>();
-        containedPtr->containerEntity = entities[count];
-
-        entityAssociation->containedEntities.emplace_back(
-            std::move(containedPtr));
-    }
-    return true;
-}
-
-// Get the matching node from Entity Association Tree
-static EntityNode::NodePtr
-    getContainedNode(const EntityNode::NodePtr& rootNode,
-                     const EntityNode::NodePtr& inputNode)
-{
-    if (!rootNode || !inputNode)
-    {
-        phosphor::logging::log<phosphor::logging::level::ERR>(
-            "Invalid node input");
-        return nullptr;
-    }
-
-    std::queue<EntityNode::NodePtr> containedEntityQueue;
-    containedEntityQueue.push(rootNode); // Enqueue root
-    // Search for EntityNode with matching entity info
-    while (!containedEntityQueue.empty())
-    {
-        EntityNode::NodePtr node = containedEntityQueue.front();
-        if (node->containerEntity.entity_type ==
-                inputNode->containerEntity.entity_type &&
-            node->containerEntity.entity_instance_num ==
-                inputNode->containerEntity.entity_instance_num &&
-            node->containerEntity.entity_container_id ==
-                inputNode->containerEntity.entity_container_id)
-        {
-            return node;
-        }
-
-        containedEntityQueue.pop();
-
-        // Enqueue all child node of the dequeued entity
-        for (EntityNode::NodePtr& entityNode : node->containedEntities)
-        {
-            containedEntityQueue.push(entityNode);
-        }
-    }
-    phosphor::logging::log<phosphor::logging::level::DEBUG>(
-        "No matching contained Node found");
-    return nullptr;
-}
-
-static void insertToAssociationTree(EntityNode::NodePtr& parentNode,
-                                    EntityNode::NodePtr& entityAssociation)
-{
-    if (!parentNode || !entityAssociation)
-    {
-        phosphor::logging::log<phosphor::logging::level::WARNING>(
-            "Invalid NodePtr");
-        return;
-    }
-
-    auto checkCyclicEntityAssociation =
-        [&parentNode](const EntityNode::NodePtr& containedEntity) {
-            if (getContainedNode(parentNode, containedEntity) == nullptr)
-            {
-                return true;
-            }
-            else
-            {
-                phosphor::logging::log<phosphor::logging::level::WARNING>(
-                    "Discarding cyclic entity association");
-                return false;
-            }
-        };
-
-    std::back_insert_iterator<EntityNode::ContainedEntities>
-        containedEntityBackItr(parentNode->containedEntities);
-
-    std::copy_if(entityAssociation->containedEntities.begin(),
-                 entityAssociation->containedEntities.end(),
-                 containedEntityBackItr, checkCyclicEntityAssociation);
-}
-
-// Extract root node from the list of Entity Associations parsed by matching
-// container ID. Remove the same from list once it is found. Note:- Merge the
-// Entity Association PDRs if there is more than one with same root node
-// container ID
-static EntityNode::NodePtr
-    extractRootNode(std::vector<EntityNode::NodePtr>& entityAssociations,
-                    ContainerID containerID)
-{
-    EntityNode::NodePtr rootNode = nullptr;
-
-    entityAssociations.erase(
-        std::remove_if(
-            entityAssociations.begin(), entityAssociations.end(),
-            [&rootNode, &containerID](EntityNode::NodePtr& entityAssociation) {
-                if (entityAssociation->containerEntity.entity_container_id !=
-                    containerID)
-                {
-                    return false;
-                }
-
-                if (!rootNode)
-                {
-                    rootNode = std::make_shared<EntityNode>();
-                    rootNode->containerEntity =
-                        entityAssociation->containerEntity;
-                }
-
-                insertToAssociationTree(rootNode, entityAssociation);
-                return true;
-            }),
-        entityAssociations.end());
-
-    return rootNode;
-}
-
 void PDRManager::createEntityAssociationTree(
-    std::vector<EntityNode::NodePtr>& entityAssociations)
+    std::vector<EntityAssociation>& associations)
 {
-    // Get parent entity association
-    EntityNode::NodePtr rootNode =
-        extractRootNode(entityAssociations, _containerID);
-
-    if (!rootNode)
+    if (!_entityAssociationTree.build(associations, _containerID))
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "Unable to find root node ");
         return;
     }
-    _entityAssociationTree = rootNode;
-
-    while (!entityAssociations.empty())
-    {
-        size_t associationPDRCount = entityAssociations.size();
-
-        entityAssociations.erase(
-            std::remove_if(entityAssociations.begin(), entityAssociations.end(),
-                           [&rootNode](EntityNode::NodePtr& entityAssociation) {
-                               EntityNode::NodePtr node = getContainedNode(
-                                   rootNode, entityAssociation);
-
-                               if (node)
-                               {
-                                   insertToAssociationTree(node,
-                                                           entityAssociation);
-                                   return true;
-                               }
-                               return false;
-                           }),
-            entityAssociations.end());
-
-        // Safe check in case there is an invalid PDR
-        if (!(entityAssociations.size() < associationPDRCount))
-        {
-            phosphor::logging::log<phosphor::logging::level::WARNING>(
-                "Invalid Entity Association PDRs found");
-            break;
-        }
-    }
     phosphor::logging::log<phosphor::logging::level::DEBUG>(
         "Successfully created Entity Associaton Tree");
 }
 
-static bool mergeContainedEntities(EntityNode::NodePtr& node,
-                                   EntityNode::NodePtr& entityAssociation)
-{
-    if (node->containerEntity.entity_type ==
-            entityAssociation->containerEntity.entity_type &&
-        node->containerEntity.entity_instance_num ==
-            entityAssociation->containerEntity.entity_instance_num &&
-        node->containerEntity.entity_container_id ==
-            entityAssociation->containerEntity.entity_container_id)
-    {
-        std::move(entityAssociation->containedEntities.begin(),
-                  entityAssociation->containedEntities.end(),
-                  std::back_inserter(node->containedEntities));
-
-        phosphor::logging::log<phosphor::logging::level::INFO>(
-            "Successfully moved Entity Association");
-        return true;
-    }
-
-    return false;
-}
-
-void PDRManager::parseEntityAssociationPDR(std::vector<uint8_t>& pdrData)
+void PDRManager::parseEntityAssociationPDR(const PDRView& pdr)
 {
     size_t numEntities{};
     pldm_entity* entitiesPtr = nullptr;
-    pldm_entity_association_pdr_extract(pdrData.data(),
-                                        static_cast<uint16_t>(pdrData.size()),
+    pldm_entity_association_pdr_extract(pdr.data,
+                                        static_cast<uint16_t>(pdr.size),
                                         &numEntities, &entitiesPtr);
-    std::shared_ptr<pldm_entity[]> entities(entitiesPtr, free);
-
-    EntityNode::NodePtr entityAssociation = nullptr;
-    if (getEntityAssociation(entities, numEntities, entityAssociation))
-    {
-        for (auto& iter : entityAssociationNodes)
-        {
-            if (mergeContainedEntities(iter, entityAssociation))
-                return;
-        }
-        entityAssociationNodes.emplace_back(std::move(entityAssociation));
-    }
-}
+    std::unique_ptr<pldm_entity, decltype(&free)> entities(entitiesPtr, free);
 
-void PDRManager::getEntityAssociationPaths(EntityNode::NodePtr& node,
-                                           EntityAssociationPath path)
-{
-    if (node == nullptr)
+    if (!(0 < numEntities) || !entities)
     {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "No entities in Entity Association PDR");
         return;
     }
 
-    // Append node to the path
-    path.emplace_back(node->containerEntity);
-
-    // If it is a leaf add to paths
-    if (node->containedEntities.empty())
-    {
-        _entityObjectPaths.emplace_back(path);
-    }
-    else
-    {
-        for (EntityNode::NodePtr& child : node->containedEntities)
-        {
-            getEntityAssociationPaths(child, path);
-        }
-    }
+    // First entity is the container. Associations with the same container are
+    // merged while building the tree
+    entityAssociations.push_back(
+        {entitiesPtr[0], std::vector<pldm_entity>(entitiesPtr + 1,
+                                                  entitiesPtr + numEntities)});
 }
 
 static void populateEntity(DBusInterfacePtr& entityIntf,
@@ -846,48 +636,50 @@ void PDRManager::populateSystemHierarchy()
     std::string pldmDevObj =
         "/xyz/openbmc_project/system/" + std::to_string(_tid);
 
-    for (const EntityAssociationPath& path : _entityObjectPaths)
-    {
-        std::string pathName;
-        for (const pldm_entity& entity : path)
+    // Parents precede their contained entities in the tree, thus the object
+    // path of an entity is built by appending its name to the parent path
+    const std::vector<EntityNode>& nodes = _entityAssociationTree.getNodes();
+    std::vector<DBusObjectPath> objPaths;
+    objPaths.reserve(nodes.size());
+    for (const EntityNode& node : nodes)
+    {
+        const pldm_entity& entity = node.entity;
+        std::string entityAuxName;
+        auto itr = _entityAuxNames.find(entity);
+        if (itr != _entityAuxNames.end())
         {
+            entityAuxName = itr->second;
+        }
+        else
+        {
+            // Dummy name if no Auxilary Name found
+            entityAuxName = std::to_string(entity.entity_type) + "_" +
+                            std::to_string(entity.entity_instance_num) + "_" +
+                            std::to_string(entity.entity_container_id);
+        }
 
-            std::string entityAuxName;
-            auto itr = _entityAuxNames.find(entity);
-            if (itr != _entityAuxNames.end())
-            {
-                entityAuxName = itr->second;
-            }
-            else
-            {
-                // Dummy name if no Auxilary Name found
-                entityAuxName = std::to_string(entity.entity_type) + "_" +
-                                std::to_string(entity.entity_instance_num) +
-                                "_" +
-                                std::to_string(entity.entity_container_id);
-            }
-
-            // Append entity names for multilevel entity associations
-            pathName += "/" + entityAuxName;
-            DBusObjectPath objPath = pldmDevObj + pathName;
+        // Append entity names for multilevel entity associations
+        DBusObjectPath objPath =
+            (node.parent == invalidEntityNode ? pldmDevObj
+                                              : objPaths[node.parent]) +
+            "/" + entityAuxName;
 
-            DBusInterfacePtr entityIntf;
-            populateEntity(entityIntf, objPath, entity);
-            _systemHierarchyIntf.emplace(entity,
-                                         std::make_pair(entityIntf, objPath));
-        }
+        DBusInterfacePtr entityIntf;
+        populateEntity(entityIntf, objPath, entity);
+        _systemHierarchyIntf.emplace(entity,
+                                     std::make_pair(entityIntf, objPath));
+        objPaths.emplace_back(std::move(objPath));
     }
-    // Clear after usage
-    _entityObjectPaths.clear();
 }
 
-void PDRManager::extractDeviceAuxName(EntityNode::NodePtr& rootNode)
+void PDRManager::extractDeviceAuxName()
 {
     std::optional<std::string> deviceName;
     std::optional<std::string> deviceLocation;
-    if (rootNode != nullptr)
+    if (!_entityAssociationTree.empty())
     {
-        auto iter = _entityAuxNames.find(rootNode->containerEntity);
+        auto iter =
+            _entityAuxNames.find(_entityAssociationTree.getNodes()[0].entity);
         if (iter != _entityAuxNames.end())
         {
             deviceName = iter->second;
@@ -924,65 +716,60 @@ void PDRManager::initializeInventoryIntf()
 }
 #endif
 
-void PDRManager::parseSensorAuxNamesPDR(std::vector<uint8_t>& pdrData)
+void PDRManager::parseSensorAuxNamesPDR(const PDRView& pdr)
 {
-    if (pdrData.size() < sizeof(pldm_sensor_auxiliary_names_pdr))
+    if (pdr.size < sizeof(pldm_sensor_auxiliary_names_pdr))
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             "Sensor Auxiliary Names PDR empty");
         return;
     }
-    pldm_sensor_auxiliary_names_pdr* namePDR =
-        reinterpret_cast<pldm_sensor_auxiliary_names_pdr*>(pdrData.data());
-    LE16TOH(namePDR->terminus_handle);
-    LE16TOH(namePDR->sensor_id);
+    const pldm_sensor_auxiliary_names_pdr* namePDR =
+        reinterpret_cast<const pldm_sensor_auxiliary_names_pdr*>(pdr.data);
+    SensorID sensorID = le16toh(namePDR->sensor_id);
 
     // TODO: Handle Composite sensor names
     size_t auxNamesLen =
-        pdrData.size() - (sizeof(pldm_sensor_auxiliary_names_pdr) -
-                          sizeof(namePDR->sensor_auxiliary_names));
+        pdr.size - (sizeof(pldm_sensor_auxiliary_names_pdr) -
+                    sizeof(namePDR->sensor_auxiliary_names));
     if (auto name = getAuxName(namePDR->name_string_count, auxNamesLen,
                                namePDR->sensor_auxiliary_names))
     {
         // Cache the Sensor Auxiliary Names
-        _sensorAuxNames[namePDR->sensor_id] = _deviceAuxName + "_" + *name;
+        _sensorAuxNames[sensorID] = _deviceAuxName + "_" + *name;
 
         phosphor::logging::log<phosphor::logging::level::DEBUG>(
-            ("SensorID:" +
-             std::to_string(static_cast<int>(namePDR->sensor_id)) +
-             " Sensor Auxiliary Name: " + _sensorAuxNames[namePDR->sensor_id])
+            ("SensorID:" + std::to_string(static_cast<int>(sensorID)) +
+             " Sensor Auxiliary Name: " + _sensorAuxNames[sensorID])
                 .c_str());
     }
 }
 
-void PDRManager::parseEffecterAuxNamesPDR(std::vector<uint8_t>& pdrData)
+void PDRManager::parseEffecterAuxNamesPDR(const PDRView& pdr)
 {
-    if (pdrData.size() < sizeof(pldm_effecter_auxiliary_names_pdr))
+    if (pdr.size < sizeof(pldm_effecter_auxiliary_names_pdr))
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             "Effecter Auxiliary Names PDR empty");
         return;
     }
-    pldm_effecter_auxiliary_names_pdr* namePDR =
-        reinterpret_cast<pldm_effecter_auxiliary_names_pdr*>(pdrData.data());
-    LE16TOH(namePDR->terminus_handle);
-    LE16TOH(namePDR->effecter_id);
+    const pldm_effecter_auxiliary_names_pdr* namePDR =
+        reinterpret_cast<const pldm_effecter_auxiliary_names_pdr*>(pdr.data);
+    EffecterID effecterID = le16toh(namePDR->effecter_id);
 
     // TODO: Handle Composite effecter names
     size_t auxNamesLen =
-        pdrData.size() - (sizeof(pldm_effecter_auxiliary_names_pdr) -
-                          sizeof(namePDR->effecter_auxiliary_names));
+        pdr.size - (sizeof(pldm_effecter_auxiliary_names_pdr) -
+                    sizeof(namePDR->effecter_auxiliary_names));
     if (auto name = getAuxName(namePDR->name_string_count, auxNamesLen,
                                namePDR->effecter_auxiliary_names))
     {
         // Cache the Effecter Auxiliary Names
-        _effecterAuxNames[namePDR->effecter_id] = _deviceAuxName + "_" + *name;
+        _effecterAuxNames[effecterID] = _deviceAuxName + "_" + *name;
 
         phosphor::logging::log<phosphor::logging::level::DEBUG>(
-            ("EffecterID:" +
-             std::to_string(static_cast<int>(namePDR->effecter_id)) +
-             " Effecter Auxiliary Name: " +
-             _effecterAuxNames[namePDR->effecter_id])
+            ("EffecterID:" + std::to_string(static_cast<int>(effecterID)) +
+             " Effecter Auxiliary Name: " + _effecterAuxNames[effecterID])
                 .c_str());
     }
 }
@@ -1076,27 +863,23 @@ std::optional<DBusObjectPath>
     return entityPath + "/" + sensorName;
 }
 
-void PDRManager::parseNumericSensorPDR(std ::vector<uint8_t>& pdrData)
+void PDRManager::parseNumericSensorPDR(const PDRView& pdr)
 {
-    std::vector<uint8_t> pdrOut(sizeof(pldm_numeric_sensor_value_pdr), 0);
+    // Decode straight into the cached PDR
+    std::shared_ptr<pldm_numeric_sensor_value_pdr> sensorPDR =
+        std::make_shared<pldm_numeric_sensor_value_pdr>();
 
-    if (!pldm_numeric_sensor_pdr_parse(pdrData.data(),
-                                       static_cast<uint16_t>(pdrData.size()),
-                                       pdrOut.data()))
+    if (!pldm_numeric_sensor_pdr_parse(
+            pdr.data, static_cast<uint16_t>(pdr.size), sensorPDR.get()))
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             "Numeric Sensor PDR parsing failed",
             phosphor::logging::entry("TID=%d", _tid));
         return;
     }
-    pldm_numeric_sensor_value_pdr* sensorPDR =
-        reinterpret_cast<pldm_numeric_sensor_value_pdr*>(pdrOut.data());
     uint16_t sensorID = sensorPDR->sensor_id;
 
-    std::shared_ptr<pldm_numeric_sensor_value_pdr> numericSensorPDR =
-        std::make_shared<pldm_numeric_sensor_value_pdr>(*sensorPDR);
-
-    _numericSensorPDR.emplace(sensorID, std::move(numericSensorPDR));
+    _numericSensorPDR.emplace(sensorID, sensorPDR);
 
     pldm_entity entity = {sensorPDR->entity_type,
                           sensorPDR->entity_instance_num,
@@ -1125,25 +908,95 @@ static void populateStateSensor(DBusInterfacePtr& sensorIntf,
     sensorIntf->initialize();
 }
 
-void PDRManager::parseStateSensorPDR(std::vector<uint8_t>& pdrData)
+// Composite sensor and effecter count range as per spec DSP0248 Table 81 and
+// Table 89
+constexpr uint8_t maxCompositeCount = 0x08;
+
+/** @brief Parse the possible states of every composite sensor or effecter
+ * instance. The possible states records are variable length and are laid out
+ * back to back after the fixed fields of the PDR.
+ */
+template <typename PossibleStatesRecord>
+static bool parseCompositePossibleStates(
+    const pldm_tid_t tid, const uint8_t* possibleStatesData,
+    const size_t dataLen,
+    const uint8_t compositeCount, std::vector<PossibleStates>& possibleStates)
+{
+    // PossibleStatesRecord holds a `bitfield8_t states[1]` which points to
+    // the possible states bitfields. Subtract its size while calculating the
+    // record size.
+    constexpr size_t possibleStatesHdrSize =
+        sizeof(PossibleStatesRecord) - sizeof(bitfield8_t);
+    // Max possibleStateSize as per spec DSP0248 Table 81
+    constexpr uint8_t maxPossibleStatesSize = 0x20;
+
+    size_t offset = 0;
+    for (uint8_t instance = 0; instance < compositeCount; instance++)
+    {
+        if (dataLen < offset + possibleStatesHdrSize)
+        {
+            phosphor::logging::log<phosphor::logging::level::WARNING>(
+                "Possible states record truncated",
+                phosphor::logging::entry("TID=%d", tid),
+                phosphor::logging::entry("INSTANCE=%d", instance));
+            return false;
+        }
+        const PossibleStatesRecord* possibleState =
+            reinterpret_cast<const PossibleStatesRecord*>(possibleStatesData +
+                                                          offset);
+        if (dataLen <
+            offset + possibleStatesHdrSize + possibleState->possible_states_size)
+        {
+            phosphor::logging::log<phosphor::logging::level::WARNING>(
+                "Possible states length invalid",
+                phosphor::logging::entry("TID=%d", tid),
+                phosphor::logging::entry("INSTANCE=%d", instance));
+            return false;
+        }
+        PossibleStates states;
+        states.stateSetID = le16toh(possibleState->state_set_id);
+        int position = 0;
+        for (uint8_t count = 0; count < possibleState->possible_states_size &&
+                                count < maxPossibleStatesSize;
+             count++)
+        {
+            for (uint8_t bits = 0; bits < 8; bits++)
+            {
+                if (possibleState->states[count].byte & (0x01 << bits))
+                {
+                    states.possibleStateSetValues.emplace(position);
+                }
+                position++;
+            }
+        }
+        possibleStates.emplace_back(std::move(states));
+        offset += possibleStatesHdrSize + possibleState->possible_states_size;
+    }
+    return true;
+}
+
+void PDRManager::parseStateSensorPDR(const PDRView& pdr)
 {
-    // Without composite sensor support there is only one instance of sensor
-    // possible states.
     // pldm_state_sensor_pdr holds a `uint8 possible_states[1]` which points to
-    // state_sensor_possible_states. Subtract its size(1 byte) while calculating
-    // total size.
-    if (pdrData.size() < sizeof(pldm_state_sensor_pdr) - sizeof(uint8_t) +
-                             sizeof(state_sensor_possible_states))
+    // the first state_sensor_possible_states. Subtract its size(1 byte) while
+    // calculating total size.
+    constexpr size_t stateSensorPDRHdrSize =
+        sizeof(pldm_state_sensor_pdr) - sizeof(uint8_t);
+    if (pdr.size <
+        stateSensorPDRHdrSize + sizeof(state_sensor_possible_states))
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             "State Sensor PDR length invalid or sensor disabled",
             phosphor::logging::entry("TID=%d", _tid),
-            phosphor::logging::entry("PDR_SIZE=%d", pdrData.size()));
+            phosphor::logging::entry("PDR_SIZE=%d", pdr.size));
         return;
     }
 
-    pldm_state_sensor_pdr* sensorPDR =
-        reinterpret_cast<pldm_state_sensor_pdr*>(pdrData.data());
+    // Copy the fixed fields since the PDR in repo is kept in wire format
+    std::shared_ptr<StateSensorPDR> stateSensorPDR =
+        std::make_shared<StateSensorPDR>();
+    pldm_state_sensor_pdr* sensorPDR = &stateSensorPDR->stateSensorData;
+    std::memcpy(sensorPDR, pdr.data, sizeof(pldm_state_sensor_pdr));
     LE16TOH(sensorPDR->sensor_id);
     LE16TOH(sensorPDR->entity_type);
     LE16TOH(sensorPDR->entity_instance);
@@ -1151,58 +1004,33 @@ void PDRManager::parseStateSensorPDR(std::vector<uint8_t>& pdrData)
 
     uint16_t sensorID = sensorPDR->sensor_id;
 
-    // TODO: Composite sensor support
-    if (sensorPDR->composite_sensor_count > 0x01)
+    if (sensorPDR->composite_sensor_count < 0x01 ||
+        sensorPDR->composite_sensor_count > maxCompositeCount)
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
-            "Composite state sensor not supported",
+            "Invalid composite sensor count",
             phosphor::logging::entry("TID=%d", _tid),
             phosphor::logging::entry("SENSOR_ID=0x%x", sensorID),
             phosphor::logging::entry("COMPOSITE_SENSOR_COUNT=%d",
                                      sensorPDR->composite_sensor_count));
+        return;
     }
 
-    state_sensor_possible_states* possibleState =
-        reinterpret_cast<state_sensor_possible_states*>(
-            sensorPDR->possible_states);
-    LE16TOH(possibleState->state_set_id);
-
-    if (pdrData.size() < sizeof(pldm_state_sensor_pdr) - sizeof(uint8_t) +
-                             sizeof(state_sensor_possible_states) -
-                             sizeof(uint8_t) +
-                             possibleState->possible_states_size)
+    std::vector<PossibleStates> possibleStates;
+    if (!parseCompositePossibleStates<state_sensor_possible_states>(
+            _tid, pdr.data + stateSensorPDRHdrSize,
+            pdr.size - stateSensorPDRHdrSize,
+            sensorPDR->composite_sensor_count, possibleStates))
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             "Invalid State Sensor PDR length",
-            phosphor::logging::entry("TID=%d", _tid));
+            phosphor::logging::entry("TID=%d", _tid),
+            phosphor::logging::entry("SENSOR_ID=0x%x", sensorID));
         return;
     }
 
-    PossibleStates possibleStates;
-    possibleStates.stateSetID = possibleState->state_set_id;
-    // Max possibleStateSize as per spec DSP0248 Table 81
-    constexpr uint8_t maxPossibleStatesSize = 0x20;
-    int position = 0;
-    for (uint8_t count = 0; count < possibleState->possible_states_size &&
-                            count < maxPossibleStatesSize;
-         count++)
-    {
-        for (uint8_t bits = 0; bits < 8; bits++)
-        {
-            if (possibleState->states[count].byte & (0x01 << bits))
-            {
-                possibleStates.possibleStateSetValues.emplace(position);
-            }
-            position++;
-        }
-    }
-
     // Cache PDR for later use
-    std::shared_ptr<StateSensorPDR> stateSensorPDR =
-        std::make_shared<StateSensorPDR>();
-    stateSensorPDR->stateSensorData = *sensorPDR;
-    // TODO: Multiple state sets in case of composite state sensor
-    stateSensorPDR->possibleStates.emplace_back(std::move(possibleStates));
+    stateSensorPDR->possibleStates = std::move(possibleStates);
     _stateSensorPDR.emplace(sensorID, std::move(stateSensorPDR));
 
     pldm_entity entity = {sensorPDR->entity_type, sensorPDR->entity_instance,
@@ -1290,21 +1118,20 @@ std::optional<DBusObjectPath>
     return *entityPath + "/" + *effecterName;
 }
 
-void PDRManager::parseNumericEffecterPDR(std::vector<uint8_t>& pdrData)
+void PDRManager::parseNumericEffecterPDR(const PDRView& pdr)
 {
-    std::vector<uint8_t> pdrOut(sizeof(pldm_numeric_effecter_value_pdr), 0);
+    // Decode straight into the cached PDR
+    std::shared_ptr<pldm_numeric_effecter_value_pdr> effecterPDR =
+        std::make_shared<pldm_numeric_effecter_value_pdr>();
 
-    if (!pldm_numeric_effecter_pdr_parse(pdrData.data(),
-                                         static_cast<uint16_t>(pdrData.size()),
-                                         pdrOut.data()))
+    if (!pldm_numeric_effecter_pdr_parse(
+            pdr.data, static_cast<uint16_t>(pdr.size), effecterPDR.get()))
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             "Numeric effecter PDR parsing failed",
             phosphor::logging::entry("TID=%d", _tid));
         return;
     }
-    pldm_numeric_effecter_value_pdr* effecterPDR =
-        reinterpret_cast<pldm_numeric_effecter_value_pdr*>(pdrOut.data());
 
     uint16_t effecterID = effecterPDR->effecter_id;
     pldm_entity entity = {effecterPDR->entity_type,
@@ -1322,10 +1149,7 @@ void PDRManager::parseNumericEffecterPDR(std::vector<uint8_t>& pdrData)
     _effecterIntf.emplace(effecterID,
                           std::make_pair(effecterIntf, *effecterPath));
 
-    std::shared_ptr<pldm_numeric_effecter_value_pdr> numericEffectorPDR =
-        std::make_shared<pldm_numeric_effecter_value_pdr>(*effecterPDR);
-
-    _numericEffecterPDR.emplace(effecterID, std::move(numericEffectorPDR));
+    _numericEffecterPDR.emplace(effecterID, std::move(effecterPDR));
 }
 
 static void populateStateEffecter(DBusInterfacePtr& effecterIntf,
@@ -1341,15 +1165,15 @@ static void populateStateEffecter(DBusInterfacePtr& effecterIntf,
     effecterIntf->initialize();
 }
 
-void PDRManager::parseStateEffecterPDR(std::vector<uint8_t>& pdrData)
+void PDRManager::parseStateEffecterPDR(const PDRView& pdr)
 {
-    // Without composite effecter support there is only one instance of
-    // effecter possible states
     // pldm_state_effecter_pdr holds a `uint8 possible_states[1]` which points
-    // to state_effecter_possible_states. Subtract its size(1 byte) while
-    // calculating total size.
-    if (pdrData.size() < sizeof(pldm_state_effecter_pdr) - sizeof(uint8_t) +
-                             sizeof(state_effecter_possible_states))
+    // to the first state_effecter_possible_states. Subtract its size(1 byte)
+    // while calculating total size.
+    constexpr size_t stateEffecterPDRHdrSize =
+        sizeof(pldm_state_effecter_pdr) - sizeof(uint8_t);
+    if (pdr.size <
+        stateEffecterPDRHdrSize + sizeof(state_effecter_possible_states))
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             "State effecter PDR length invalid or effecter disabled",
@@ -1357,8 +1181,11 @@ void PDRManager::parseStateEffecterPDR(std::vector<uint8_t>& pdrData)
         return;
     }
 
-    pldm_state_effecter_pdr* effecterPDR =
-        reinterpret_cast<pldm_state_effecter_pdr*>(pdrData.data());
+    // Copy the fixed fields since the PDR in repo is kept in wire format
+    std::shared_ptr<StateEffecterPDR> stateEffecterPDR =
+        std::make_shared<StateEffecterPDR>();
+    pldm_state_effecter_pdr* effecterPDR = &stateEffecterPDR->stateEffecterData;
+    std::memcpy(effecterPDR, pdr.data, sizeof(pldm_state_effecter_pdr));
     LE16TOH(effecterPDR->effecter_id);
     LE16TOH(effecterPDR->entity_type);
     LE16TOH(effecterPDR->entity_instance);
@@ -1366,56 +1193,33 @@ void PDRManager::parseStateEffecterPDR(std::vector<uint8_t>& pdrData)
 
     uint16_t effecterID = effecterPDR->effecter_id;
 
-    // TODO: Composite effecter support
-    constexpr uint8_t supportedEffecterCount = 0x01;
-    if (effecterPDR->composite_effecter_count > supportedEffecterCount)
+    if (effecterPDR->composite_effecter_count < 0x01 ||
+        effecterPDR->composite_effecter_count > maxCompositeCount)
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
-            "Composite state effecter not supported",
+            "Invalid composite effecter count",
             phosphor::logging::entry("TID=%d", _tid),
-            phosphor::logging::entry("EFFECTER_ID=0x%x", effecterID));
+            phosphor::logging::entry("EFFECTER_ID=0x%x", effecterID),
+            phosphor::logging::entry("COMPOSITE_EFFECTER_COUNT=%d",
+                                     effecterPDR->composite_effecter_count));
+        return;
     }
 
-    state_effecter_possible_states* possibleState =
-        reinterpret_cast<state_effecter_possible_states*>(
-            effecterPDR->possible_states);
-    LE16TOH(possibleState->state_set_id);
-
-    if (pdrData.size() < sizeof(pldm_state_effecter_pdr) - sizeof(uint8_t) +
-                             sizeof(state_effecter_possible_states) -
-                             sizeof(uint8_t) +
-                             possibleState->possible_states_size)
+    std::vector<PossibleStates> possibleStates;
+    if (!parseCompositePossibleStates<state_effecter_possible_states>(
+            _tid, pdr.data + stateEffecterPDRHdrSize,
+            pdr.size - stateEffecterPDRHdrSize,
+            effecterPDR->composite_effecter_count, possibleStates))
     {
         phosphor::logging::log<phosphor::logging::level::WARNING>(
             "State Effecter PDR length invalid",
-            phosphor::logging::entry("TID=%d", _tid));
+            phosphor::logging::entry("TID=%d", _tid),
+            phosphor::logging::entry("EFFECTER_ID=0x%x", effecterID));
         return;
     }
 
-    PossibleStates possibleStates;
-    possibleStates.stateSetID = possibleState->state_set_id;
-    constexpr uint8_t maxPossibleStatesSize = 0x20;
-    int position = 0;
-    for (uint8_t count = 0; count < possibleState->possible_states_size &&
-                            count < maxPossibleStatesSize;
-         count++)
-    {
-        for (size_t bits = 0; bits < 8; bits++)
-        {
-            if (possibleState->states[count].byte & (0x01 << bits))
-            {
-                possibleStates.possibleStateSetValues.emplace(position);
-            }
-            position++;
-        }
-    }
-
     // Cache PDR for later use
-    std::shared_ptr<StateEffecterPDR> stateEffecterPDR =
-        std::make_shared<StateEffecterPDR>();
-    stateEffecterPDR->stateEffecterData = *effecterPDR;
-    // TODO: Multiple state sets in case of composite state effecter
-    stateEffecterPDR->possibleStates.emplace_back(std::move(possibleStates));
+    stateEffecterPDR->possibleStates = std::move(possibleStates);
     _stateEffecterPDR.emplace(effecterID, std::move(stateEffecterPDR));
 
     pldm_entity entity = {effecterPDR->entity_type,
@@ -1449,9 +1253,9 @@ static void populateFRURecordSet(DBusInterfacePtr& fruRSIntf,
     fruRSIntf->initialize();
 }
 
-void PDRManager::parseFRURecordSetPDR(std::vector<uint8_t>& pdrData)
+void PDRManager::parseFRURecordSetPDR(const PDRView& pdr)
 {
-    if (pdrData.size() != sizeof(pldm_fru_record_set_pdr))
+    if (pdr.size != sizeof(pldm_fru_record_set_pdr))
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "FRU Record Set PDR length invalid",
@@ -1459,17 +1263,14 @@ void PDRManager::parseFRURecordSetPDR(std::vector<uint8_t>& pdrData)
         return;
     }
 
-    pldm_fru_record_set_pdr* fruRecordSetPDR =
-        reinterpret_cast<pldm_fru_record_set_pdr*>(pdrData.data());
-    LE16TOH(fruRecordSetPDR->fru_record_set.entity_type);
-    LE16TOH(fruRecordSetPDR->fru_record_set.entity_instance_num);
-    LE16TOH(fruRecordSetPDR->fru_record_set.container_id);
-    LE16TOH(fruRecordSetPDR->fru_record_set.fru_rsi);
+    const pldm_fru_record_set_pdr* fruRecordSetPDR =
+        reinterpret_cast<const pldm_fru_record_set_pdr*>(pdr.data);
+    const auto& fruRecordSet = fruRecordSetPDR->fru_record_set;
 
-    pldm_entity entity = {fruRecordSetPDR->fru_record_set.entity_type,
-                          fruRecordSetPDR->fru_record_set.entity_instance_num,
-                          fruRecordSetPDR->fru_record_set.container_id};
-    FRURecordSetIdentifier fruRSI = fruRecordSetPDR->fru_record_set.fru_rsi;
+    pldm_entity entity = {le16toh(fruRecordSet.entity_type),
+                          le16toh(fruRecordSet.entity_instance_num),
+                          le16toh(fruRecordSet.container_id)};
+    FRURecordSetIdentifier fruRSI = le16toh(fruRecordSet.fru_rsi);
 
     std::optional<DBusObjectPath> fruRSPath = getEntityObjectPath(entity);
     if (!fruRSPath)
@@ -1488,79 +1289,86 @@ void PDRManager::parseFRURecordSetPDR(std::vector<uint8_t>& pdrData)
     _fruRecordSetIntf.emplace(fruRSI, std::make_pair(fruRSIntf, *fruRSPath));
 }
 
-template <pldm_pdr_types pdrType>
-void PDRManager::parsePDR()
+PDRTypeIndex PDRManager::indexPDRs()
 {
-    size_t count = 0;
+    PDRTypeIndex pdrIndex;
     uint8_t* pdrData = nullptr;
     uint32_t pdrSize{};
-    auto record = pldm_pdr_find_record_by_type(_pdrRepo.get(), pdrType, NULL,
-                                               &pdrData, &pdrSize);
+    uint32_t nextRecordHandle{};
+    // Record handle 0 fetches the first record in the repo
+    auto record = pldm_pdr_find_record(_pdrRepo.get(), 0, &pdrData, &pdrSize,
+                                       &nextRecordHandle);
     while (record)
     {
-        std::vector<uint8_t> pdrVec(pdrData, pdrData + pdrSize);
-        // TODO: Move Entity Auxiliary Name PDR and Entity Association PDR
-        // parsing here
-        if constexpr (pdrType == PLDM_SENSOR_AUXILIARY_NAMES_PDR)
-        {
-            parseSensorAuxNamesPDR(pdrVec);
-        }
-        else if constexpr (pdrType == PLDM_EFFECTER_AUXILIARY_NAMES_PDR)
-        {
-            parseEffecterAuxNamesPDR(pdrVec);
-        }
-        else if constexpr (pdrType == PLDM_NUMERIC_SENSOR_PDR)
-        {
-            parseNumericSensorPDR(pdrVec);
-        }
-        else if constexpr (pdrType == PLDM_STATE_SENSOR_PDR)
+        if (pdrSize >= sizeof(pldm_pdr_hdr))
         {
-            parseStateSensorPDR(pdrVec);
+            const pldm_pdr_hdr* pdrHdr =
+                reinterpret_cast<const pldm_pdr_hdr*>(pdrData);
+            pdrIndex[pdrHdr->type].push_back({pdrData, pdrSize});
         }
-        else if constexpr (pdrType == PLDM_NUMERIC_EFFECTER_PDR)
-        {
-            parseNumericEffecterPDR(pdrVec);
-        }
-        else if constexpr (pdrType == PLDM_STATE_EFFECTER_PDR)
-        {
-            parseStateEffecterPDR(pdrVec);
-        }
-        else if constexpr (pdrType == PLDM_PDR_FRU_RECORD_SET)
-        {
-            parseFRURecordSetPDR(pdrVec);
-        }
-        else if constexpr (pdrType == PLDM_ENTITY_AUXILIARY_NAMES_PDR)
-        {
-            parseEntityAuxNamesPDR(pdrVec);
-        }
-        else if constexpr (pdrType == PLDM_PDR_ENTITY_ASSOCIATION)
-        {
-            parseEntityAssociationPDR(pdrVec);
-        }
-        else
-        {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                "Not supported. Unknown PDR type");
-            return;
-        }
-
-        count++;
         pdrData = nullptr;
         pdrSize = 0;
-        record = pldm_pdr_find_record_by_type(_pdrRepo.get(), pdrType, record,
-                                              &pdrData, &pdrSize);
+        record = pldm_pdr_get_next_record(_pdrRepo.get(), record, &pdrData,
+                                          &pdrSize, &nextRecordHandle);
     }
+    return pdrIndex;
+}
 
-    if constexpr (pdrType == PLDM_PDR_ENTITY_ASSOCIATION)
+void PDRManager::parsePDR(const uint8_t pdrType, const PDRView& pdr)
+{
+    switch (pdrType)
     {
-        if (entityAssociationNodes.size())
-        {
-            createEntityAssociationTree(entityAssociationNodes);
-        }
+        case PLDM_ENTITY_AUXILIARY_NAMES_PDR:
+            parseEntityAuxNamesPDR(pdr);
+            break;
+        case PLDM_PDR_ENTITY_ASSOCIATION:
+            parseEntityAssociationPDR(pdr);
+            break;
+        case PLDM_SENSOR_AUXILIARY_NAMES_PDR:
+            parseSensorAuxNamesPDR(pdr);
+            break;
+        case PLDM_EFFECTER_AUXILIARY_NAMES_PDR:
+            parseEffecterAuxNamesPDR(pdr);
+            break;
+        case PLDM_NUMERIC_SENSOR_PDR:
+            parseNumericSensorPDR(pdr);
+            break;
+        case PLDM_STATE_SENSOR_PDR:
+            parseStateSensorPDR(pdr);
+            break;
+        case PLDM_NUMERIC_EFFECTER_PDR:
+            parseNumericEffecterPDR(pdr);
+            break;
+        case PLDM_STATE_EFFECTER_PDR:
+            parseStateEffecterPDR(pdr);
+            break;
+        case PLDM_PDR_FRU_RECORD_SET:
+            parseFRURecordSetPDR(pdr);
+            break;
+        default:
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                "Not supported. Unknown PDR type",
+                phosphor::logging::entry("PDR_TYPE=%d", pdrType));
+            break;
+    }
+}
+
+void PDRManager::parsePDRs(const PDRTypeIndex& pdrIndex,
+                           const pldm_pdr_types pdrType)
+{
+    auto records = pdrIndex.find(static_cast<uint8_t>(pdrType));
+    if (records == pdrIndex.end())
+    {
+        return;
+    }
+
+    for (const PDRView& pdr : records->second)
+    {
+        parsePDR(static_cast<uint8_t>(pdrType), pdr);
     }
     phosphor::logging::log<phosphor::logging::level::DEBUG>(
         ("Number of type " + std::to_string(pdrType) +
-         " PDR parsed: " + std::to_string(count))
+         " PDR parsed: " + std::to_string(records->second.size()))
             .c_str());
 }
 
@@ -1629,49 +1437,42 @@ bool PDRManager::pdrManagerInit(boost::asio::yield_context yield)
 
     initializePDRDumpIntf();
 
-    parsePDR<PLDM_ENTITY_AUXILIARY_NAMES_PDR>();
-    parsePDR<PLDM_PDR_ENTITY_ASSOCIATION>();
-    getEntityAssociationPaths(_entityAssociationTree, {});
+    // PDRs are indexed in one pass. Types are parsed in dependency order:
+    // auxiliary names and entity associations are needed to name and place
+    // the sensors, effecters and FRU record sets on D-Bus.
+    PDRTypeIndex pdrIndex = indexPDRs();
+    parsePDRs(pdrIndex, PLDM_ENTITY_AUXILIARY_NAMES_PDR);
+    parsePDRs(pdrIndex, PLDM_PDR_ENTITY_ASSOCIATION);
+    if (entityAssociations.size())
+    {
+        createEntityAssociationTree(entityAssociations);
+        // Associations are not needed once the tree is built
+        std::vector<EntityAssociation>().swap(entityAssociations);
+    }
     populateSystemHierarchy();
-    extractDeviceAuxName(_entityAssociationTree);
+    extractDeviceAuxName();
 #ifdef EXPOSE_CHASSIS
     initializeInventoryIntf();
 #endif
-    parsePDR<PLDM_SENSOR_AUXILIARY_NAMES_PDR>();
-    parsePDR<PLDM_EFFECTER_AUXILIARY_NAMES_PDR>();
-    parsePDR<PLDM_NUMERIC_SENSOR_PDR>();
-    parsePDR<PLDM_STATE_SENSOR_PDR>();
-    parsePDR<PLDM_NUMERIC_EFFECTER_PDR>();
-    parsePDR<PLDM_STATE_EFFECTER_PDR>();
-    parsePDR<PLDM_PDR_FRU_RECORD_SET>();
+    parsePDRs(pdrIndex, PLDM_SENSOR_AUXILIARY_NAMES_PDR);
+    parsePDRs(pdrIndex, PLDM_EFFECTER_AUXILIARY_NAMES_PDR);
+    parsePDRs(pdrIndex, PLDM_NUMERIC_SENSOR_PDR);
+    parsePDRs(pdrIndex, PLDM_STATE_SENSOR_PDR);
+    parsePDRs(pdrIndex, PLDM_NUMERIC_EFFECTER_PDR);
+    parsePDRs(pdrIndex, PLDM_STATE_EFFECTER_PDR);
+    parsePDRs(pdrIndex, PLDM_PDR_FRU_RECORD_SET);
 
     return true;
 }
 
-struct PDRDump
+void PDRManager::spawnPDRExport(const int fd, const PDRExportFormat format)
 {
-    PDRDump(const std::string& fileName) : pdrFile(fileName)
-    {
-    }
-    void dumpPDRData(const std::vector<uint8_t>& pdr)
-    {
-        std::stringstream ss;
-        const pldm_pdr_hdr* pdrHdr =
-            reinterpret_cast<const pldm_pdr_hdr*>(pdr.data());
-        ss << "PDR Type: " << static_cast<int>(pdrHdr->type) << std::endl;
-        ss << "Length: " << pdr.size() << std::endl;
-        ss << "Data: ";
-        for (auto re : pdr)
-        {
-            ss << " 0x" << std::hex << std::setfill('0') << std::setw(2)
-               << static_cast<int>(re);
-        }
-        pdrFile << ss.rdbuf() << std::endl;
-    }
-
-  private:
-    std::ofstream pdrFile;
-};
+    boost::asio::spawn(*getIoContext(),
+                       [tid = _tid, repo = _pdrRepo, fd,
+                        format](boost::asio::yield_context yield) {
+                           exportPDRs(yield, tid, repo, fd, format);
+                       });
+}
 
 void PDRManager::initializePDRDumpIntf()
 {
@@ -1681,41 +1482,47 @@ void PDRManager::initializePDRDumpIntf()
     pdrDumpInterface =
         objServer->add_interface(pldmDevObj, "xyz.openbmc_project.PLDM.PDR");
     pdrDumpInterface->register_method("DumpPDR", [this](void) {
-        uint32_t noOfRecords = pldm_pdr_get_record_count(_pdrRepo.get());
-        if (!noOfRecords)
+        std::string fileName =
+            "/tmp/pldm_pdr_dump_" + std::to_string(_tid) + ".json";
+        int fd = open(fileName.c_str(),
+                      O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
         {
-            phosphor::logging::log<phosphor::logging::level::INFO>(
-                "PDR repo empty!");
-            return;
+            throw sdbusplus::exception::SdBusError(
+                -errno, "Unable to create PDR dump file");
         }
-
-        std::unique_ptr<PDRDump> pdrDump = std::make_unique<PDRDump>(
-            "/tmp/pldm_pdr_dump_" + std::to_string(_tid) + ".txt");
-
-        for (uint8_t pdrType = PLDM_TERMINUS_LOCATOR_PDR;
-             pdrType != PLDM_OEM_PDR; pdrType++)
-        {
-
-            uint8_t* pdrData = nullptr;
-            uint32_t pdrSize{};
-            auto record = pldm_pdr_find_record_by_type(
-                _pdrRepo.get(), pdrType, NULL, &pdrData, &pdrSize);
-            while (record)
+        spawnPDRExport(fd, PDRExportFormat::json);
+    });
+    pdrDumpInterface->register_method(
+        "ExportPDR",
+        [this](const sdbusplus::message::unix_fd& fd,
+               const std::string& format) {
+            std::optional<PDRExportFormat> exportFormat =
+                toPDRExportFormat(format);
+            if (!exportFormat)
             {
-                std::vector<uint8_t> pdrVec(pdrData, pdrData + pdrSize);
-                pdrDump->dumpPDRData(pdrVec);
-
-                if (!(--noOfRecords))
-                {
-                    return;
-                }
-                pdrData = nullptr;
-                pdrSize = 0;
-                record = pldm_pdr_find_record_by_type(
-                    _pdrRepo.get(), pdrType, record, &pdrData, &pdrSize);
+                throw sdbusplus::exception::SdBusError(
+                    -EINVAL, "Unsupported PDR export format");
             }
-        }
-    });
+            // The fd received is closed once the method returns
+            int exportFd = fcntl(fd.fd, F_DUPFD_CLOEXEC, 0);
+            if (exportFd < 0)
+            {
+                throw sdbusplus::exception::SdBusError(
+                    -errno, "Unable to duplicate PDR export fd");
+            }
+            spawnPDRExport(exportFd, *exportFormat);
+        });
+    pdrDumpInterface->register_method(
+        "VerifyPDRExport", [this](const std::string& fileName) {
+            auto records = loadPDRExport(fileName);
+            if (!records)
+            {
+                throw sdbusplus::exception::SdBusError(
+                    -EINVAL, "Invalid PDR export");
+            }
+            return matchesPDRRepo(_pdrRepo, *records);
+        });
     pdrDumpInterface->initialize();
 }
 } // namespace platform
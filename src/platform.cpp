@@ -15,14 +15,15 @@
  */
 #include "platform.hpp"
 
+#include "terminus_health.hpp"
+#include "utils.hpp"
+
 #include <phosphor-logging/log.hpp>
 
 namespace pldm
 {
 namespace platform
 {
-// TODO: Optimize poll interval
-static constexpr const int pollIntervalMillisec = 500;
 static constexpr const int pauseIntervalMillisec = 1;
 static Platform platform;
 
@@ -58,55 +59,85 @@ bool Platform::induceAsyncDelay(boost::asio::yield_context yield, int delay)
 void Platform::doPoll(boost::asio::yield_context yield)
 {
     isSensorPollRunning = false;
+    auto pollCycleStart = std::chrono::steady_clock::now();
+    std::vector<PollProfiler::SensorKey> polledSensors;
+
+    auto pollSensor = [this, &yield, &polledSensors](const pldm_tid_t tid,
+                                                     const SensorID sensorID,
+                                                     auto& sensorHandler) {
+        const PollProfiler::SensorKey key(tid, sensorID);
+        // Rest of the cycle is skipped once polling is paused
+        if (stopSensorPoll)
+        {
+            pollProfiler.recordSkip(key, SkipReason::paused);
+            return;
+        }
+        if (sensorHandler->isSensorDisabled())
+        {
+            pollProfiler.recordSkip(key, SkipReason::disabled);
+            return;
+        }
+        if (!sensorHandler->sensorErrorCheck())
+        {
+            pollProfiler.recordSkip(key, SkipReason::errorThreshold);
+            return;
+        }
+        isSensorPollRunning = true;
+        // Terminus is probed by the transport till it recovers
+        if (!isTerminusAvailable(tid))
+        {
+            pollProfiler.recordSkip(key, SkipReason::terminusUnavailable);
+            return;
+        }
+        // Reads would fail and count as sensor errors
+        if (isBandwidthReserved(tid, PLDM_PLATFORM))
+        {
+            pollProfiler.recordSkip(key, SkipReason::reservation);
+            return;
+        }
+
+        auto readStart = std::chrono::steady_clock::now();
+        std::optional<bool> success = readSensor(
+            yield, tid, sensorID, *sensorHandler, MessagePriority::normal);
+        if (!success)
+        {
+            // Sensor was just read by Refresh
+            return;
+        }
+        auto readLatency = std::chrono::steady_clock::now() - readStart;
+        pollProfiler.recordRead(key, readLatency, *success);
+        polledSensors.emplace_back(key);
+    };
+
     for (auto [tid, platformTerminus] : platforms)
     {
         for (auto const& [sensorID, numericSensorHandler] :
              platformTerminus->numericSensors)
         {
-            if (numericSensorHandler->isSensorDisabled())
-            {
-                continue;
-            }
-            if (!numericSensorHandler->sensorErrorCheck())
-            {
-                continue;
-            }
-            isSensorPollRunning = true;
-
-            numericSensorHandler->populateSensorValue(yield);
-            if (!induceAsyncDelay(yield, pollIntervalMillisec))
-            {
-                return;
-            }
-            if (stopSensorPoll)
-            {
-                return;
-            }
+            pollSensor(tid, sensorID, numericSensorHandler);
         }
         for (auto const& [sensorID, stateSensorHandler] :
              platformTerminus->stateSensors)
         {
-            if (stateSensorHandler->isSensorDisabled())
-            {
-                continue;
-            }
-            if (!stateSensorHandler->sensorErrorCheck())
-            {
-                continue;
-            }
-            isSensorPollRunning = true;
-
-            stateSensorHandler->populateSensorValue(yield);
-            if (!induceAsyncDelay(yield, pollIntervalMillisec))
-            {
-                return;
-            }
-            if (stopSensorPoll)
-            {
-                return;
-            }
+            pollSensor(tid, sensorID, stateSensorHandler);
         }
     }
+    if (stopSensorPoll)
+    {
+        return;
+    }
+    auto pollCycleDuration = std::chrono::steady_clock::now() - pollCycleStart;
+    pollProfiler.recordCycle(polledSensors, pollCycleDuration);
+    pollProfiler.logSummary();
+
+    if (isSensorPollRunning && pollCycleDuration < minPollCycle)
+    {
+        induceAsyncDelay(
+            yield, static_cast<int>(
+                       std::chrono::duration_cast<std::chrono::milliseconds>(
+                           minPollCycle - pollCycleDuration)
+                           .count()));
+    }
 }
 
 // Sensor polling co-routine can have transactions in-flight when
@@ -247,17 +278,38 @@ void Platform::initializeSensorPollIntf()
     const char* objPath = "/xyz/openbmc_project/sensors";
     pausePollInterface =
         addUniqueInterface(objPath, "xyz.openbmc_project.PLDM.SensorPoll");
-    pausePollInterface->register_method("PauseSensorPoll",
-                                        [](const bool pause) {
-                                            if (pause)
-                                            {
-                                                pauseSensorPolling();
-                                            }
-                                            else
-                                            {
-                                                resumeSensorPolling();
-                                            }
-                                        });
+    pausePollInterface->register_method(
+        "Refresh",
+        [this](boost::asio::yield_context yield, const pldm_tid_t tid,
+               const SensorID sensorID, const uint64_t maxAgeMillisec) {
+            auto reading = refreshSensor(
+                yield, tid, sensorID,
+                std::chrono::milliseconds(maxAgeMillisec));
+            if (!reading)
+            {
+                throw sdbusplus::exception::SdBusError(
+                    -EINVAL, "Invalid TID or sensor ID");
+            }
+            return *reading;
+        });
+    pausePollInterface->register_method(
+        "GetPollProfile", [this]() { return pollProfiler.getProfile(); });
+    pausePollInterface->register_method("ResetPollProfile",
+                                        [this]() { pollProfiler.reset(); });
+    if (debug)
+    {
+        pausePollInterface->register_method("PauseSensorPoll",
+                                            [](const bool pause) {
+                                                if (pause)
+                                                {
+                                                    pauseSensorPolling();
+                                                }
+                                                else
+                                                {
+                                                    resumeSensorPolling();
+                                                }
+                                            });
+    }
     pausePollInterface->initialize();
 }
 
@@ -311,9 +363,9 @@ bool Platform::initTerminus(
     deleteMnCTerminus(tid);
     tidsUnderInitialization.emplace(tid);
 
+    initializeSensorPollIntf();
     if (debug)
     {
-        initializeSensorPollIntf();
         initializePlatformIntf();
     }
 
@@ -363,6 +415,7 @@ bool Platform::deleteTerminus(const pldm_tid_t tid)
     }
     pauseSensorPolling();
     platforms.erase(entry);
+    pollProfiler.removeTerminus(tid);
     phosphor::logging::log<phosphor::logging::level::INFO>(
         ("Platform Monitoring and Control resources deleted for TID " +
          std::to_string(tid))
@@ -372,6 +425,134 @@ bool Platform::deleteTerminus(const pldm_tid_t tid)
     return true;
 }
 
+void Platform::resumeTerminus(const pldm_tid_t tid)
+{
+    auto entry = platforms.find(tid);
+    if (entry == platforms.end())
+    {
+        return;
+    }
+
+    auto& platformTerminus = entry->second;
+    for (auto const& [sensorID, numericSensorHandler] :
+         platformTerminus->numericSensors)
+    {
+        numericSensorHandler->resetErrorCount();
+    }
+    for (auto const& [sensorID, stateSensorHandler] :
+         platformTerminus->stateSensors)
+    {
+        stateSensorHandler->resetErrorCount();
+    }
+
+    // Polling loop exits if there are no sensors to poll. Restart it unless
+    // polling is paused by the user.
+    if (startSensorPoll && !sensorTimer)
+    {
+        startSensorPolling();
+    }
+}
+
+template <typename SensorHandler>
+std::optional<bool> Platform::readSensor(boost::asio::yield_context yield,
+                                         const pldm_tid_t tid,
+                                         const SensorID sensorID,
+                                         SensorHandler& sensorHandler,
+                                         const MessagePriority priority)
+{
+    const auto key = std::make_pair(tid, sensorID);
+    if (auto inFlight = readsInFlight.find(key);
+        inFlight != readsInFlight.end())
+    {
+        // Keep the timer alive till this waiter wakes up
+        std::shared_ptr<boost::asio::steady_timer> readDone = inFlight->second;
+        boost::system::error_code ec;
+        readDone->async_wait(yield[ec]);
+        return std::nullopt;
+    }
+
+    auto readDone = std::make_shared<boost::asio::steady_timer>(
+        *getIoContext(), boost::asio::steady_timer::time_point::max());
+    readsInFlight.emplace(key, readDone);
+    bool success = sensorHandler.populateSensorValue(yield, priority);
+    readsInFlight.erase(key);
+    readDone->cancel();
+    return success;
+}
+
+// Sensor is read from the caller's coroutine without waiting for the polling
+// loop to reach it, ahead of the polling traffic on the bus. Readings older
+// than maxAge are refreshed unless polling is paused or the terminus is not
+// responding, in which case the cached reading is returned and the timestamp
+// tells its age. While the bus is reserved, e.g. by a firmware update, the
+// read fails right away.
+template <typename SensorHandler>
+void Platform::refreshSensorReading(boost::asio::yield_context yield,
+                                    const pldm_tid_t tid,
+                                    const SensorID sensorID,
+                                    SensorHandler& sensorHandler,
+                                    const std::chrono::milliseconds maxAge)
+{
+    if (std::chrono::steady_clock::now() - sensorHandler.getLastUpdated() <=
+        maxAge)
+    {
+        return;
+    }
+    if (!startSensorPoll || !isTerminusAvailable(tid) ||
+        sensorHandler.isSensorDisabled() || !sensorHandler.sensorErrorCheck())
+    {
+        return;
+    }
+    if (isBandwidthReserved(tid, PLDM_PLATFORM))
+    {
+        throw sdbusplus::exception::SdBusError(-EBUSY,
+                                               "Bandwidth is reserved");
+    }
+    auto readStart = std::chrono::steady_clock::now();
+    std::optional<bool> success =
+        readSensor(yield, tid, sensorID, sensorHandler, MessagePriority::high);
+    if (success)
+    {
+        pollProfiler.recordOnDemandRead(
+            std::make_pair(tid, sensorID),
+            std::chrono::steady_clock::now() - readStart, *success);
+    }
+}
+
+std::optional<TimestampedReading>
+    Platform::refreshSensor(boost::asio::yield_context yield,
+                            const pldm_tid_t tid, const SensorID sensorID,
+                            const std::chrono::milliseconds maxAge)
+{
+    auto entry = platforms.find(tid);
+    if (entry == platforms.end())
+    {
+        return std::nullopt;
+    }
+    // Terminus can be removed while the sensor is read
+    std::shared_ptr<PlatformTerminus> platformTerminus = entry->second;
+
+    if (auto it = platformTerminus->numericSensors.find(sensorID);
+        it != platformTerminus->numericSensors.end())
+    {
+        NumericSensorHandler& sensorHandler = *it->second;
+        refreshSensorReading(yield, tid, sensorID, sensorHandler, maxAge);
+        return std::make_tuple(
+            SensorReading(sensorHandler.getValue()),
+            utils::toEpochMicroseconds(sensorHandler.getLastUpdated()));
+    }
+    if (auto it = platformTerminus->stateSensors.find(sensorID);
+        it != platformTerminus->stateSensors.end())
+    {
+        StateSensorHandler& sensorHandler = *it->second;
+        refreshSensorReading(yield, tid, sensorID, sensorHandler, maxAge);
+        return std::make_tuple(
+            SensorReading(sensorHandler.getCurrentStates()),
+            utils::toEpochMicroseconds(sensorHandler.getLastUpdated()));
+    }
+    return std::nullopt;
+}
+
 void pauseSensorPolling()
 {
     platform.stopSensorPolling();
@@ -393,5 +574,10 @@ bool deleteMnCTerminus(const pldm_tid_t tid)
     return platform.deleteTerminus(tid);
 }
 
+void resumeTerminusMonitoring(const pldm_tid_t tid)
+{
+    platform.resumeTerminus(tid);
+}
+
 } // namespace platform
 } // namespace pldm
@@ -38,8 +38,7 @@ PlatformTerminus::PlatformTerminus(boost::asio::yield_context yield,
 
 void PlatformTerminus::initSensors(boost::asio::yield_context yield)
 {
-    std::unordered_map<SensorID, std::string> sensorList =
-        pdrManager->getSensors();
+    const auto& sensorList = pdrManager->getSensors();
 
     for (auto const& [sensorID, sensorName] : sensorList)
     {
@@ -93,8 +92,7 @@ void PlatformTerminus::initSensors(boost::asio::yield_context yield)
 
 void PlatformTerminus::initEffecters(boost::asio::yield_context yield)
 {
-    std::unordered_map<EffecterID, std::string> effecterList =
-        pdrManager->getEffecters();
+    const auto& effecterList = pdrManager->getEffecters();
 
     for (auto const& [effecterID, effecterName] : effecterList)
     {
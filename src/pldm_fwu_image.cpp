@@ -18,8 +18,15 @@
 #include "fwu_inventory.hpp"
 #include "platform.hpp"
 
-#include <filesystem>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
 #include <phosphor-logging/log.hpp>
+#include <system_error>
 
 namespace pldm
 {
@@ -32,77 +39,108 @@ extern std::map<pldm_tid_t, FDProperties> terminusFwuProperties;
 
 PLDMImg::PLDMImg(const std::string& pldmImgPath)
 {
-    std::error_code ec;
-    pldmImg.open(pldmImgPath, std::ios::in | std::ios::binary | std::ios::ate);
-    if (!pldmImg.is_open())
+    int fd = open(pldmImgPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
     {
-        ec = std::make_error_code(std::errc::no_such_file_or_directory);
+        int err = errno;
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Unable to open pldm image");
+        throw std::system_error(err, std::generic_category(), "open");
     }
 
-    std::uintmax_t imageSize = 0;
-    if (!ec)
+    struct stat imgStat = {};
+    if (fstat(fd, &imgStat) < 0 || imgStat.st_size <= 0)
     {
-        std::filesystem::path path(pldmImgPath);
-        imageSize = std::filesystem::file_size(path, ec);
+        int err = imgStat.st_size <= 0 ? EINVAL : errno;
+        close(fd);
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Unable to get pldm image size");
+        throw std::system_error(err, std::generic_category(), "fstat");
     }
+    size_t imageSize = static_cast<size_t>(imgStat.st_size);
 
-    if (ec)
+    // The mapping keeps the file referenced, the fd is not needed past this
+    void* addr = mmap(nullptr, imageSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    int err = errno;
+    close(fd);
+    if (addr == MAP_FAILED)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
-            "Unable to open pldm image");
-        throw ec;
+            "Unable to map pldm image");
+        throw std::system_error(err, std::generic_category(), "mmap");
+    }
+    // Components are requested front to back. Read ahead aggressively and let
+    // the kernel drop the pages already sent.
+    if (madvise(addr, imageSize, MADV_SEQUENTIAL) < 0)
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "madvise failed on pldm image");
     }
 
+    pldmImg = static_cast<const uint8_t*>(addr);
     pldmImgSize = imageSize;
     imagePath = pldmImgPath;
 }
 
-bool PLDMImg::readData(const size_t startAddr, std::vector<uint8_t>& data,
-                       const size_t dataLen)
+PLDMImg::~PLDMImg()
 {
-    if (startAddr + dataLen > pldmImgSize + PLDM_FWU_BASELINE_TRANSFER_SIZE)
+    munmap(const_cast<uint8_t*>(pldmImg), pldmImgSize);
+}
+
+const uint8_t* PLDMImg::getData(const size_t startAddr,
+                                const size_t dataLen) const
+{
+    if (startAddr > pldmImgSize || dataLen > pldmImgSize - startAddr)
     {
-        phosphor::logging::log<phosphor::logging::level::ERR>(
-            "readData: invalid start address or bytes to read is out of range");
-        return false;
+        return nullptr;
     }
-    pldmImg.seekg(startAddr, pldmImg.beg);
-    if (!pldmImg.good())
+    return pldmImg + startAddr;
+}
+
+void PLDMImg::prefetchData(const size_t startAddr, const size_t dataLen) const
+{
+    if (startAddr >= pldmImgSize)
     {
-        phosphor::logging::log<phosphor::logging::level::ERR>(
-            "readData: Failed to seek on pldm image.");
-        return false;
+        return;
     }
+    static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    // madvise needs a page aligned address
+    size_t alignedAddr = startAddr - (startAddr % pageSize);
+    size_t len = std::min(dataLen, pldmImgSize - startAddr) +
+                 (startAddr - alignedAddr);
+    if (madvise(const_cast<uint8_t*>(pldmImg + alignedAddr), len,
+                MADV_WILLNEED) < 0)
+    {
+        phosphor::logging::log<phosphor::logging::level::DEBUG>(
+            "prefetchData: madvise failed on pldm image");
+    }
+}
 
-    pldmImg.read(reinterpret_cast<char*>(&data[0]), dataLen);
-    if (!pldmImg.good())
+bool PLDMImg::readData(const size_t startAddr, std::vector<uint8_t>& data,
+                       const size_t dataLen)
+{
+    const uint8_t* src = getData(startAddr, dataLen);
+    if (!src || data.size() < dataLen)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
-            "readData: Failed to read on pldm image.");
+            "readData: invalid start address or bytes to read is out of range");
         return false;
     }
-
+    std::memcpy(data.data(), src, dataLen);
     return true;
 }
 
 uint16_t PLDMImg::getHdrLen()
 {
     constexpr size_t pkgHdroffSet = 17;
-    pldmImg.seekg(pkgHdroffSet, pldmImg.beg);
-    if (!pldmImg.good())
-    {
-        phosphor::logging::log<phosphor::logging::level::ERR>(
-            "getHdrLen: Failed to seek on pldm image.");
-
-        return 0;
-    }
-    pldmImg.read(reinterpret_cast<char*>(&pkgHdrLen), sizeof(pkgHdrLen));
-    if (!pldmImg.good())
+    const uint8_t* hdrLen = getData(pkgHdroffSet, sizeof(pkgHdrLen));
+    if (!hdrLen)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "getHdrLen: Failed to read on pldm image.");
         return 0;
     }
+    std::memcpy(&pkgHdrLen, hdrLen, sizeof(pkgHdrLen));
     return (pkgHdrLen);
 }
 
@@ -122,40 +160,54 @@ bool PLDMImg::matchPkgHdrIdentifier(const uint8_t* packageHeaderIdentifier)
     return true;
 }
 
-bool PLDMImg::advanceHdrItr(const size_t dataSize, const size_t nextDataSize)
+/** @brief Bounds checked reader of the package header*/
+struct PkgHdrCursor
 {
-    std::advance(hdrItr, dataSize);
-    size_t bytesLeft = std::distance(hdrItr, std::end(hdrData));
-    return validateHdrDataLen(bytesLeft, nextDataSize);
-}
+    const uint8_t* pos;
+    const uint8_t* end;
+
+    /** @brief Take the next bytes of the header
+     *
+     * @return nullptr if fewer bytes are left
+     */
+    const uint8_t* take(const size_t length)
+    {
+        if (static_cast<size_t>(end - pos) < length)
+        {
+            return nullptr;
+        }
+        const uint8_t* data = pos;
+        pos += length;
+        return data;
+    }
 
-void PLDMImg::copyPkgHdrInfoToMap(const struct PLDMPkgHeaderInfo* headerInfo,
-                                  const std::string& pkgVersionString)
-{
-    pkgFWUProperties["PkgHeaderFormatRevision"] =
-        headerInfo->pkgHeaderFormatRevision;
-    pkgFWUProperties["PkgHeaderSize"] = (headerInfo->pkgHeaderSize);
-    compBitmapBitLength = htole16(headerInfo->compBitmapBitLength);
-    pkgFWUProperties["CompBitmapBitLength"] = compBitmapBitLength;
-    pkgFWUProperties["PkgVersionStringType"] = headerInfo->pkgVersionStringType;
-    pkgFWUProperties["PkgVersionStringLen"] = headerInfo->pkgVersionStringLen;
-    pkgFWUProperties["PkgVersionString"] = pkgVersionString;
-}
+    /** @brief Take a packed structure from the header*/
+    template <typename T>
+    const T* take()
+    {
+        return reinterpret_cast<const T*>(take(sizeof(T)));
+    }
 
-bool PLDMImg::processPkgHdrInfo()
-{
-    hdrItr = std::begin(hdrData);
-    if (hdrItr == std::end(hdrData))
+    /** @brief Take a string of the header, viewed in place*/
+    bool takeString(const size_t length, std::string_view& str)
     {
-        return false;
+        const uint8_t* data = take(length);
+        if (!data)
+        {
+            return false;
+        }
+        str = std::string_view(reinterpret_cast<const char*>(data), length);
+        return true;
     }
-    size_t bytesLeft = std::distance(hdrItr, std::end(hdrData));
-    if (bytesLeft < sizeof(PLDMPkgHeaderInfo))
+};
+
+bool PLDMImg::processPkgHdrInfo(PkgHdrCursor& cursor)
+{
+    const PLDMPkgHeaderInfo* headerInfo = cursor.take<PLDMPkgHeaderInfo>();
+    if (!headerInfo)
     {
         return false;
     }
-    PLDMPkgHeaderInfo* headerInfo =
-        reinterpret_cast<PLDMPkgHeaderInfo*>(&*hdrItr);
 
     if (!matchPkgHdrIdentifier(headerInfo->packageHeaderIdentifier))
     {
@@ -164,34 +216,29 @@ bool PLDMImg::processPkgHdrInfo()
         return false;
     }
 
-    if (!advanceHdrItr(sizeof(PLDMPkgHeaderInfo),
-                       static_cast<size_t>(headerInfo->pkgVersionStringLen)))
-    {
-        return false;
-    }
-    pkgVersionStringLen = headerInfo->pkgVersionStringLen;
-    std::string pkgVersionString(hdrItr,
-                                 hdrItr + headerInfo->pkgVersionStringLen);
-    copyPkgHdrInfoToMap(headerInfo, pkgVersionString);
-    return true;
+    pkgHeader.formatRevision = headerInfo->pkgHeaderFormatRevision;
+    pkgHeader.compBitmapBitLength = le16toh(headerInfo->compBitmapBitLength);
+    pkgHeader.versionStringType = headerInfo->pkgVersionStringType;
+    return cursor.takeString(headerInfo->pkgVersionStringLen,
+                             pkgHeader.versionString);
 }
 
-bool PLDMImg::verifyPkgHdrChecksum()
+bool PLDMImg::verifyPkgHdrChecksum(const uint8_t* hdrData,
+                                   const uint16_t hdrLen)
 {
     constexpr size_t pkgHdrChecksumSize = 4;
     uint32_t pkgHdrChecksum = 0;
-    std::vector<uint8_t> checksum(pkgHdrChecksumSize);
-
-    if (!readData(pkgHdrLen - pkgHdrChecksumSize, checksum, pkgHdrChecksumSize))
+    if (hdrLen < pkgHdrChecksumSize)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "failed to read pkgHdrChecksum");
         return false;
     }
-    pkgHdrChecksum = *reinterpret_cast<uint32_t*>(checksum.data());
+    std::memcpy(&pkgHdrChecksum, hdrData + hdrLen - pkgHdrChecksumSize,
+                pkgHdrChecksumSize);
 
-    if (pkgHdrChecksum !=
-        crc32(hdrData.data(), hdrData.size() - pkgHdrChecksumSize))
+    if (le32toh(pkgHdrChecksum) !=
+        crc32(hdrData, hdrLen - pkgHdrChecksumSize))
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "verifyPkgHdrChecksum: checksum not macthed");
@@ -201,40 +248,53 @@ bool PLDMImg::verifyPkgHdrChecksum()
 }
 
 bool PLDMImg::processPkgHdr()
+{
+    return parsePkgHdr() && matchTermini(terminusFwuProperties);
+}
+
+bool PLDMImg::parsePkgHdr()
 {
     constexpr size_t minPkgHeaderLen =
         sizeof(PLDMPkgHeaderInfo) + sizeof(FWDevIdRecord) + sizeof(CompImgInfo);
     pkgHdrLen = getHdrLen();
-    assert(pkgHdrLen != minPkgHeaderLen);
-    hdrData.resize(pkgHdrLen);
-
-    if (!readData(0, hdrData, pkgHdrLen))
+    // Header records refer to the strings in place. Keep a private copy so
+    // that those stay valid even if the package file changes.
+    const uint8_t* hdrData = getData(0, pkgHdrLen);
+    if (hdrData)
+    {
+        pkgHdrData.assign(hdrData, hdrData + pkgHdrLen);
+        hdrData = pkgHdrData.data();
+    }
+    if (pkgHdrLen < minPkgHeaderLen || !hdrData)
     {
-        phosphor::logging::log<phosphor::logging::level::ERR>("read failed ");
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Invalid package header length",
+            phosphor::logging::entry("HDR_LEN=%d", pkgHdrLen));
         return false;
     }
 
-    if (!verifyPkgHdrChecksum())
+    if (!verifyPkgHdrChecksum(hdrData, pkgHdrLen))
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "verifyPkgHdrChecksum: Failed");
         return false;
     }
 
-    if (!processPkgHdrInfo())
+    PkgHdrCursor cursor{hdrData, hdrData + pkgHdrLen};
+    if (!processPkgHdrInfo(cursor))
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "processPkgHdrInfo: Failed");
         return false;
     }
 
-    if (!processDevIdentificationInfo())
+    if (!processDevIdentificationInfo(cursor))
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "processDevIdentificationInfo: Failed");
         return false;
     }
-    if (!processCompImgInfo())
+    if (!processCompImgInfo(cursor))
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "processCompImgInfo: Failed");
@@ -243,46 +303,70 @@ bool PLDMImg::processPkgHdr()
     return true;
 }
 
-bool PLDMImg::processCompImgInfo()
+bool PLDMImg::processCompImgInfo(PkgHdrCursor& cursor)
 {
-    uint16_t found = 0;
-
-    if (!advanceHdrItr(0, sizeof(totalCompCount)))
+    uint16_t totalCompCount = 0;
+    const uint8_t* compCount = cursor.take(sizeof(totalCompCount));
+    if (!compCount)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
-            "no bytes left for deviceIDRecordCount");
+            "no bytes left for ComponentImageCount");
+        return false;
+    }
+    std::memcpy(&totalCompCount, compCount, sizeof(totalCompCount));
+    totalCompCount = le16toh(totalCompCount);
+    if (totalCompCount > maxPkgComponents)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Too many components in the package",
+            phosphor::logging::entry("COMP_COUNT=%d", totalCompCount));
         return false;
     }
-    totalCompCount = *reinterpret_cast<const uint16_t*>(&*hdrItr);
-    std::advance(hdrItr, sizeof(totalCompCount));
 
-    while (hdrItr < std::end(hdrData) && found != totalCompCount)
+    components.clear();
+    components.reserve(totalCompCount);
+    while (components.size() != totalCompCount)
     {
-        size_t bytesLeft = std::distance(hdrItr, std::end(hdrData));
-        if (bytesLeft <= sizeof(CompImgInfo))
+        const CompImgInfo* compInfo = cursor.take<CompImgInfo>();
+        if (!compInfo)
         {
             phosphor::logging::log<phosphor::logging::level::ERR>(
                 "no bytes left for CompImgInfo");
             break;
         }
-        const auto compInfo = reinterpret_cast<const CompImgInfo*>(&*hdrItr);
-
-        if (!advanceHdrItr(sizeof(CompImgInfo), compInfo->compVerStrLen))
+        PkgComponent component{};
+        component.classification = le16toh(compInfo->compClassification);
+        component.identifier = le16toh(compInfo->compIdentifier);
+        component.comparisonStamp = le32toh(compInfo->compComparisonStamp);
+        component.options = le16toh(compInfo->compOptions);
+        component.requestedActivationMethod =
+            le16toh(compInfo->requestedCompActivationMethod);
+        component.locationOffset = le32toh(compInfo->compLocationOffset);
+        component.size = le32toh(compInfo->compSize);
+        component.versionStringType = compInfo->compVerStrType;
+        if (!cursor.takeString(compInfo->compVerStrLen,
+                               component.versionString))
         {
             phosphor::logging::log<phosphor::logging::level::ERR>(
                 "no bytes left for compVerStr");
             break;
         }
-        std::string compVerStr(hdrItr, hdrItr + compInfo->compVerStrLen);
-        std::advance(hdrItr, compInfo->compVerStrLen);
-        copyCompImgInfoToMap(found, compInfo, compVerStr);
-        found++;
+        if (component.locationOffset > pldmImgSize ||
+            component.size > pldmImgSize - component.locationOffset)
+        {
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                "Component exceeds the package",
+                phosphor::logging::entry("COMPONENT=%zu", components.size()));
+            return false;
+        }
+        components.push_back(component);
     }
-    if (found != totalCompCount)
+    if (components.size() != totalCompCount)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "Component count not matched",
-            phosphor::logging::entry("ACTUAL_COMP_COUNT=%d", found),
+            phosphor::logging::entry("ACTUAL_COMP_COUNT=%zu",
+                                     components.size()),
             phosphor::logging::entry("EXPECTED_COMP_COUNT=%d", totalCompCount));
         return false;
     }
@@ -290,195 +374,143 @@ bool PLDMImg::processCompImgInfo()
     return true;
 }
 
-bool PLDMImg::findMatchedTerminus(const uint8_t devIdRecord,
-                                  const DescriptorsMap& pkgDescriptors)
+bool PLDMImg::matchTermini(const std::map<pldm_tid_t, FDProperties>& termini)
 {
-    for (auto const& it : terminusFwuProperties)
+    matchedTermini.clear();
+    for (size_t index = 0; index < devIDRecords.size(); index++)
     {
-        DescriptorsMap fdDescriptors;
-        try
+        uint8_t devIdRecord = static_cast<uint8_t>(index);
+        const DescriptorsMap& pkgDescriptors = devIDRecords[index].descriptors;
+        bool matched = false;
+        for (auto const& it : termini)
         {
-            fdDescriptors = std::get<DescriptorsMap>(it.second);
+            const DescriptorsMap& fdDescriptors =
+                std::get<DescriptorsMap>(it.second);
+            if (pkgDescriptors.size() == fdDescriptors.size() &&
+                pkgDescriptors == fdDescriptors)
+            {
+                matchedTermini.emplace_back(
+                    std::make_pair(devIdRecord, it.first));
+                matched = true;
+            }
         }
-        catch (const std::exception& e)
+        if (!matched)
         {
-            phosphor::logging::log<phosphor::logging::level::ERR>(
-                ("findMatchedTerminus: Failed to get DescriptorsMap for "
-                 "devIdRecord: " +
-                 std::to_string(devIdRecord))
-                    .c_str());
-            return false;
-        }
-        if (pkgDescriptors.size() == fdDescriptors.size() &&
-            pkgDescriptors == fdDescriptors)
-        {
-            matchedTermini.emplace_back(std::make_pair(devIdRecord, it.first));
+            phosphor::logging::log<phosphor::logging::level::INFO>(
+                "matchTermini: descriptors not matched",
+                phosphor::logging::entry("DESCRIPTOR=%d", devIdRecord));
         }
     }
-    return !matchedTermini.empty();
+    if (!matchedTermini.size())
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Descriptors not matched with descriptors in device ID records");
+        return false;
+    }
+    return true;
 }
 
-bool PLDMImg::processDevIdentificationInfo()
+bool PLDMImg::processDevIdentificationInfo(PkgHdrCursor& cursor)
 {
-
-    if (!advanceHdrItr(pkgVersionStringLen, sizeof(deviceIDRecordCount)))
+    const uint8_t* recordCount = cursor.take(sizeof(uint8_t));
+    if (!recordCount)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "no bytes left for deviceIDRecordCount");
         return false;
     }
 
-    deviceIDRecordCount = *hdrItr;
-    uint8_t foundDescriptorCount = 0;
+    uint8_t deviceIDRecordCount = *recordCount;
     constexpr size_t compBitmapBitLengthMultiplier = 8;
-    std::advance(hdrItr, sizeof(deviceIDRecordCount));
+    size_t applicableComponentsLen =
+        pkgHeader.compBitmapBitLength / compBitmapBitLengthMultiplier;
 
-    while (hdrItr < std::end(hdrData) &&
-           foundDescriptorCount < deviceIDRecordCount)
+    devIDRecords.clear();
+    devIDRecords.reserve(deviceIDRecordCount);
+    while (devIDRecords.size() < deviceIDRecordCount)
     {
-        ssize_t bytesLeft = std::distance(hdrItr, std::end(hdrData));
-        if (bytesLeft < static_cast<ssize_t>(sizeof(FWDevIdRecord)))
+        const FWDevIdRecord* devIdentificationInfo =
+            cursor.take<FWDevIdRecord>();
+        if (!devIdentificationInfo)
         {
             phosphor::logging::log<phosphor::logging::level::ERR>(
                 "no bytes left for FWDevIdRecord");
             break;
         }
-        FWDevIdRecord* devIdentificationInfo =
-            reinterpret_cast<FWDevIdRecord*>(&*hdrItr);
-        size_t applicableComponentsLen =
-            compBitmapBitLength / compBitmapBitLengthMultiplier;
-        if (!advanceHdrItr(sizeof(FWDevIdRecord), applicableComponentsLen))
+        PkgDeviceIDRecord record{};
+        record.deviceUpdateOptionFlags =
+            le32toh(devIdentificationInfo->deviceUpdateOptionFlags);
+        record.compImgSetVerStrType =
+            devIdentificationInfo->comImgSetVerStrType;
+
+        const uint8_t* applicableComponents =
+            cursor.take(applicableComponentsLen);
+        if (!applicableComponents)
         {
             phosphor::logging::log<phosphor::logging::level::ERR>(
                 "no bytes left for applicableComponentsLen");
             break;
         }
+        size_t bitCount = std::min(applicableComponentsLen * 8,
+                                   record.applicableComponents.size());
+        for (size_t bit = 0; bit < bitCount; bit++)
+        {
+            record.applicableComponents[bit] =
+                (applicableComponents[bit / 8] >> (bit % 8)) & 1;
+        }
 
-        std::vector<uint8_t> applicableComponents(
-            hdrItr, hdrItr + applicableComponentsLen);
-
-        if (!advanceHdrItr(applicableComponentsLen,
-                           devIdentificationInfo->comImgSetVerStrLen))
+        if (!cursor.takeString(devIdentificationInfo->comImgSetVerStrLen,
+                               record.compImgSetVerStr))
         {
             phosphor::logging::log<phosphor::logging::level::ERR>(
                 "no bytes left for comImgSetVerStr");
             break;
         }
-        std::string compImgSetVerStr(
-            hdrItr, hdrItr + devIdentificationInfo->comImgSetVerStrLen);
-        size_t descriptorDataLen = getDescriptorDataLen(
-            *devIdentificationInfo, applicableComponentsLen);
 
-        if (!advanceHdrItr(compImgSetVerStr.size(), descriptorDataLen))
+        uint16_t fwDevPkgDataLen =
+            le16toh(devIdentificationInfo->fwDevPkgDataLen);
+        size_t fixedLen = sizeof(FWDevIdRecord) + applicableComponentsLen +
+                          devIdentificationInfo->comImgSetVerStrLen +
+                          fwDevPkgDataLen;
+        uint16_t recordLength = le16toh(devIdentificationInfo->recordLength);
+        const uint8_t* descriptors =
+            recordLength < fixedLen ? nullptr
+                                    : cursor.take(recordLength - fixedLen);
+        if (!descriptors)
         {
             phosphor::logging::log<phosphor::logging::level::ERR>(
                 "no bytes left for descriptorData");
             break;
         }
-        std::vector<uint8_t> descriptorData(hdrItr, hdrItr + descriptorDataLen);
+        std::vector<uint8_t> descriptorData(
+            descriptors, descriptors + (recordLength - fixedLen));
         uint16_t initialDescriptorType;
-        DescriptorsMap pkgDescriptorRecords;
         unpackDescriptors(devIdentificationInfo->descriptorCount,
                           descriptorData, initialDescriptorType,
-                          pkgDescriptorRecords);
-        if (!findMatchedTerminus(foundDescriptorCount, pkgDescriptorRecords))
-        {
-            phosphor::logging::log<phosphor::logging::level::INFO>(
-                "processDevIdentificationInfo: descriptors not matched",
-                phosphor::logging::entry("DESCRIPTOR=%d",
-                                         foundDescriptorCount));
-        }
-        fwDevPkgDataLen = htole16(devIdentificationInfo->fwDevPkgDataLen);
+                          record.descriptors);
 
-        if (!advanceHdrItr(descriptorData.size(), fwDevPkgDataLen))
+        record.fwDevPkgData.ptr = cursor.take(fwDevPkgDataLen);
+        record.fwDevPkgData.length = fwDevPkgDataLen;
+        if (!record.fwDevPkgData.ptr)
         {
             phosphor::logging::log<phosphor::logging::level::ERR>(
                 "no bytes left for fwDevPkgData");
             break;
         }
-        std::vector<uint8_t> fwDevPkgData(hdrItr, hdrItr + fwDevPkgDataLen);
-        std::advance(hdrItr, fwDevPkgDataLen);
-        copyDevIdentificationInfoToMap(
-            foundDescriptorCount, initialDescriptorType, devIdentificationInfo,
-            applicableComponents, compImgSetVerStr, fwDevPkgData,
-            pkgDescriptorRecords);
-        foundDescriptorCount++;
+        devIDRecords.push_back(record);
     }
 
-    if (foundDescriptorCount != deviceIDRecordCount)
+    if (devIDRecords.size() != deviceIDRecordCount)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "Descriptor count not matched",
-            phosphor::logging::entry("ACTUAL_DEV_ID_RECORD_COUNT=%d",
-                                     foundDescriptorCount),
+            phosphor::logging::entry("ACTUAL_DEV_ID_RECORD_COUNT=%zu",
+                                     devIDRecords.size()),
             phosphor::logging::entry("EXPECTED_DEV_ID_RECORD_COUNT=%d",
                                      deviceIDRecordCount));
         return false;
     }
-    if (!matchedTermini.size())
-    {
-        phosphor::logging::log<phosphor::logging::level::ERR>(
-            "Descriptors not matched with descriptors in device ID records");
-        return false;
-    }
     return true;
 }
-
-void PLDMImg::copyDevIdentificationInfoToMap(
-    const uint8_t deviceIDRecord, const uint16_t initialDescriptorType,
-    const FWDevIdRecord* devIdentificationInfo,
-    const std::vector<uint8_t>& applicableComponents,
-    const std::string& compImgSetVerStr,
-    const std::vector<uint8_t>& fwDevPkgData,
-    DescriptorsMap& pkgDescriptorRecords)
-{
-    FWUProperties devIdentificationProps;
-    devIdentificationProps["InitialDescriptorType"] = initialDescriptorType;
-    devIdentificationProps["DeviceIDRecordCount"] = deviceIDRecord;
-    devIdentificationProps["RecordLength"] =
-        htole16(devIdentificationInfo->recordLength);
-    devIdentificationProps["DescriptorCount"] =
-        devIdentificationInfo->descriptorCount;
-    devIdentificationProps["DeviceUpdateOptionFlags"] =
-        htole32(devIdentificationInfo->deviceUpdateOptionFlags);
-    devIdentificationProps["ComImgSetVerStrType"] =
-        devIdentificationInfo->comImgSetVerStrType;
-    devIdentificationProps["ComImgSetVerStrLen"] =
-        devIdentificationInfo->comImgSetVerStrLen;
-    devIdentificationProps["FWDevPkgDataLen"] =
-        htole16(devIdentificationInfo->fwDevPkgDataLen);
-    devIdentificationProps["ApplicableComponents"] = applicableComponents;
-    devIdentificationProps["CompImgSetVerStr"] = compImgSetVerStr;
-    devIdentificationProps["FirmwareDevicePackageData"] = fwDevPkgData;
-    pkgDevIDRecords[deviceIDRecord] =
-        std::make_pair(devIdentificationProps, pkgDescriptorRecords);
-}
-
-void PLDMImg::copyCompImgInfoToMap(const uint16_t count,
-                                   const CompImgInfo* compInfo,
-                                   const std::string& compVerStr)
-{
-    std::map<std::string, FWUVariantType> properties;
-    properties["CompClassification"] = htole16(compInfo->compClassification);
-    properties["CompIdentifier"] = htole16(compInfo->compIdentifier);
-    properties["CompComparisonStamp"] = htole32(compInfo->compComparisonStamp);
-    properties["CompOptions"] = htole16(compInfo->compOptions);
-    properties["RequestedCompActivationMethod"] =
-        htole16(compInfo->requestedCompActivationMethod);
-    properties["CompLocationOffset"] = htole32(compInfo->compLocationOffset);
-    properties["CompSize"] = htole32(compInfo->compSize);
-    properties["CmpVerStrType"] = compInfo->compVerStrType;
-    properties["CompVerStrLen"] = compInfo->compVerStrLen;
-    properties["CompVerStr"] = compVerStr;
-    pkgCompProperties[count] = properties;
-}
-
-size_t PLDMImg::getDescriptorDataLen(const FWDevIdRecord& data,
-                                     const size_t applicableComponentsLen)
-{
-    return (htole16(data.recordLength) - sizeof(FWDevIdRecord) -
-            applicableComponentsLen - data.comImgSetVerStrLen -
-            htole16(data.fwDevPkgDataLen));
-}
 } // namespace fwu
 } // namespace pldm
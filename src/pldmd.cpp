@@ -18,6 +18,8 @@
 #include "mctp_wrapper.hpp"
 #include "platform.hpp"
 #include "pldm.hpp"
+#include "rate_limiter.hpp"
+#include "terminus_health.hpp"
 #include "utils.hpp"
 
 #include <queue>
@@ -35,12 +37,89 @@ bool debug = false;
 namespace pldm
 {
 
-static bool rsvBWActive = false;
-static pldm_tid_t reservedTID = pldmInvalidTid;
-static uint8_t reservedPLDMType = pldmInvalidType;
+/** @brief Terminus and PLDM type holding the bandwidth of a contention
+ * domain
+ */
+struct BandwidthReservation
+{
+    pldm_tid_t tid;
+    uint8_t pldmType;
+};
+
+static std::map<ContentionDomain, BandwidthReservation> reservations;
+
+// Termini simulated in process, they are not reached through MCTP
+static std::map<pldm_tid_t, std::shared_ptr<SimulatedTerminus>>
+    simulatedTermini;
 
 TIDMapper tidMapper;
 std::unique_ptr<mctpw::MCTPWrapper> mctpWrapper;
+static RateLimiter rateLimiter;
+// Contention domain each EID is reached through
+static std::unordered_map<mctpw_eid_t, ContentionDomain> eidDomains;
+
+// TODO - Read from entity manager about the transport bindings to be
+// supported by PLDM
+constexpr mctpw::BindingType transportBinding =
+    mctpw::BindingType::mctpOverSmBus;
+
+static ContentionDomain getEIDContentionDomain(const mctpw_eid_t eid)
+{
+    auto it = eidDomains.find(eid);
+    if (it != eidDomains.end())
+    {
+        return it->second;
+    }
+    // Each physical bus is served by its own MCTP binding service
+    mctpw::MCTPWrapper::EndpointMap endpoints = mctpWrapper->getEndpointMap();
+    auto endpoint = endpoints.find(eid);
+    if (endpoint == endpoints.end())
+    {
+        // Not cached, the EID may show up once discovered
+        return {};
+    }
+    return eidDomains.emplace(eid, endpoint->second).first->second;
+}
+
+// Each simulated terminus is put on a bus of its own, which is rate limited
+// and reserved like a real one
+static ContentionDomain getSimulatedContentionDomain(const pldm_tid_t tid)
+{
+    return "simulated-" + std::to_string(tid);
+}
+
+std::optional<ContentionDomain> getContentionDomain(const pldm_tid_t tid)
+{
+    if (simulatedTermini.count(tid) != 0)
+    {
+        return getSimulatedContentionDomain(tid);
+    }
+    if (auto eidPtr = tidMapper.getMappedEID(tid))
+    {
+        return getEIDContentionDomain(*eidPtr);
+    }
+    return std::nullopt;
+}
+
+static bool waitForBusCapacity(
+    boost::asio::yield_context yield, const ContentionDomain& domain,
+    const MessagePriority priority = MessagePriority::normal)
+{
+    // Bus is reserved for the terminus which is the only sender allowed when
+    // reserve bandwidth is active. Thus there is no contention to limit.
+    if (reservations.count(domain) != 0)
+    {
+        return true;
+    }
+    return rateLimiter.acquire(yield, domain, priority);
+}
+
+static bool waitForBusCapacity(
+    boost::asio::yield_context yield, const mctpw_eid_t eid,
+    const MessagePriority priority = MessagePriority::normal)
+{
+    return waitForBusCapacity(yield, getEIDContentionDomain(eid), priority);
+}
 
 void triggerDeviceDiscovery(const pldm_tid_t tid)
 {
@@ -50,9 +129,33 @@ void triggerDeviceDiscovery(const pldm_tid_t tid)
     }
 }
 
-static bool validateReserveBW(const pldm_tid_t tid, const uint8_t pldmType)
+static const BandwidthReservation*
+    getReservation(const pldm_tid_t tid,
+                   const std::optional<mctpw_eid_t> eid = std::nullopt)
 {
-    return rsvBWActive && !(tid == reservedTID && pldmType == reservedPLDMType);
+    // EID takes precedence as the TID may not be assigned yet
+    std::optional<ContentionDomain> domain =
+        eid ? getEIDContentionDomain(*eid) : getContentionDomain(tid);
+    if (!domain)
+    {
+        return nullptr;
+    }
+    auto it = reservations.find(*domain);
+    return it == reservations.end() ? nullptr : &it->second;
+}
+
+static bool
+    validateReserveBW(const pldm_tid_t tid, const uint8_t pldmType,
+                      const std::optional<mctpw_eid_t> eid = std::nullopt)
+{
+    const BandwidthReservation* reservation = getReservation(tid, eid);
+    return reservation &&
+           !(tid == reservation->tid && pldmType == reservation->pldmType);
+}
+
+bool isBandwidthReserved(const pldm_tid_t tid, const uint8_t pldmType)
+{
+    return validateReserveBW(tid, pldmType);
 }
 
 bool reserveBandwidth(const boost::asio::yield_context yield,
@@ -61,13 +164,19 @@ bool reserveBandwidth(const boost::asio::yield_context yield,
 {
     if (validateReserveBW(tid, pldmType))
     {
+        const BandwidthReservation* reservation = getReservation(tid);
         phosphor::logging::log<phosphor::logging::level::INFO>(
             ("Reserve bandwidth is active for TID: " +
-             std::to_string(reservedTID) +
-             ". RESERVED_PLDM_TYPE: " + std::to_string(reservedPLDMType))
+             std::to_string(reservation->tid) + ". RESERVED_PLDM_TYPE: " +
+             std::to_string(reservation->pldmType))
                 .c_str());
         return false;
     }
+    if (simulatedTermini.count(tid) != 0)
+    {
+        reservations[getSimulatedContentionDomain(tid)] = {tid, pldmType};
+        return true;
+    }
     mctpw_eid_t eid = 0;
     if (auto eidPtr = tidMapper.getMappedEID(tid))
     {
@@ -81,27 +190,32 @@ bool reserveBandwidth(const boost::asio::yield_context yield,
     {
         return false;
     }
-    rsvBWActive = true;
-    reservedTID = tid;
-    reservedPLDMType = pldmType;
+    // Other contention domains are not affected by the reservation
+    reservations[getEIDContentionDomain(eid)] = {tid, pldmType};
     return true;
 }
 
 bool releaseBandwidth(const boost::asio::yield_context yield,
                       const pldm_tid_t tid, const uint8_t pldmType)
 {
-    if (!rsvBWActive)
+    const BandwidthReservation* reservation = getReservation(tid);
+    if (!reservation)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "releaseBandwidth: Reserve bandwidth is not active.");
         return false;
     }
-    if (tid != reservedTID || pldmType != reservedPLDMType)
+    if (tid != reservation->tid || pldmType != reservation->pldmType)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "releaseBandwidth: Invalid TID or pldm type");
         return false;
     }
+    if (simulatedTermini.count(tid) != 0)
+    {
+        reservations.erase(getSimulatedContentionDomain(tid));
+        return true;
+    }
     std::optional<mctpw_eid_t> eid = tidMapper.getMappedEID(tid);
     if (eid == std::nullopt)
     {
@@ -111,12 +225,22 @@ bool releaseBandwidth(const boost::asio::yield_context yield,
     {
         return false;
     }
-    rsvBWActive = false;
-    reservedTID = pldmInvalidTid;
-    reservedPLDMType = pldmInvalidType;
+    reservations.erase(getEIDContentionDomain(*eid));
     return true;
 }
 
+void addSimulatedTerminus(const pldm_tid_t tid,
+                          std::shared_ptr<SimulatedTerminus> terminus)
+{
+    simulatedTermini[tid] = std::move(terminus);
+}
+
+void removeSimulatedTerminus(const pldm_tid_t tid)
+{
+    reservations.erase(getSimulatedContentionDomain(tid));
+    simulatedTermini.erase(tid);
+}
+
 std::optional<std::string> getDeviceLocation(const pldm_tid_t tid)
 {
     std::optional<mctpw_eid_t> eid = tidMapper.getMappedEID(tid);
@@ -280,25 +404,21 @@ bool sendReceivePldmMessage(boost::asio::yield_context yield,
                             const pldm_tid_t tid, const uint16_t timeout,
                             size_t retryCount, std::vector<uint8_t> pldmReq,
                             std::vector<uint8_t>& pldmResp,
-                            std::optional<mctpw_eid_t> eid)
+                            std::optional<mctpw_eid_t> eid,
+                            const MessagePriority priority)
 {
     pldm_msg_hdr* hdr = reinterpret_cast<pldm_msg_hdr*>(pldmReq.data());
-    if (validateReserveBW(tid, hdr->type))
+    if (validateReserveBW(tid, hdr->type, eid))
     {
+        const BandwidthReservation* reservation = getReservation(tid, eid);
         phosphor::logging::log<phosphor::logging::level::INFO>(
             ("sendReceivePldmMessage is not allowed. Reserve bandwidth is "
              "active for TID: " +
-             std::to_string(reservedTID) +
-             " RESERVED_PLDM_TYPE: " + std::to_string(reservedPLDMType))
+             std::to_string(reservation->tid) + " RESERVED_PLDM_TYPE: " +
+             std::to_string(reservation->pldmType))
                 .c_str());
         return false;
     }
-    // Retry the request if
-    //  1) No response
-    //  2) payload.size() < 4
-    //  3) If response bit is not set in PLDM header
-    //  4) Invalid message type
-    //  5) Invalid instance id
 
     // Upper cap of retryCount = 5
     constexpr size_t maxRetryCount = 5;
@@ -307,6 +427,41 @@ bool sendReceivePldmMessage(boost::asio::yield_context yield,
         retryCount = maxRetryCount;
     }
 
+    if (auto it = simulatedTermini.find(tid); it != simulatedTermini.end())
+    {
+        // Hold the terminus in case it is removed while handling the request
+        std::shared_ptr<SimulatedTerminus> terminus = it->second;
+        ContentionDomain domain = getSimulatedContentionDomain(tid);
+        for (size_t retry = 0; retry < retryCount; retry++)
+        {
+            if (!waitForBusCapacity(yield, domain, priority))
+            {
+                return false;
+            }
+            if (terminus->handleRequest(yield, timeout, pldmReq, pldmResp))
+            {
+                return true;
+            }
+        }
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Retry count exceeded. No response from simulated terminus",
+            phosphor::logging::entry("TID=%d", tid));
+        return false;
+    }
+    if (!isTerminusAvailable(tid))
+    {
+        phosphor::logging::log<phosphor::logging::level::DEBUG>(
+            "sendReceivePldmMessage is not allowed. Terminus is not responding",
+            phosphor::logging::entry("TID=%d", tid));
+        return false;
+    }
+    // Retry the request if
+    //  1) No response
+    //  2) payload.size() < 4
+    //  3) If response bit is not set in PLDM header
+    //  4) Invalid message type
+    //  5) Invalid instance id
+
     for (size_t retry = 0; retry < retryCount; retry++)
     {
         mctpw_eid_t dstEid;
@@ -340,6 +495,11 @@ bool sendReceivePldmMessage(boost::asio::yield_context yield,
                            static_cast<uint8_t>(mctpw::MessageType::pldm));
         }
 
+        if (!waitForBusCapacity(yield, dstEid, priority))
+        {
+            return false;
+        }
+
         // Clear the resp vector each time before a retry
         pldmResp.clear();
         if (doSendReceievePldmMessage(yield, dstEid, timeout, pldmReq,
@@ -397,6 +557,7 @@ bool sendReceivePldmMessage(boost::asio::yield_context yield,
                 {
                     if (*reqInstanceId == *respInstanceId)
                     {
+                        recordTransportOutcome(tid, true);
                         return true;
                     }
                 }
@@ -408,6 +569,7 @@ bool sendReceivePldmMessage(boost::asio::yield_context yield,
     }
     phosphor::logging::log<phosphor::logging::level::ERR>(
         "Retry count exceeded. No response");
+    recordTransportOutcome(tid, false);
     return false;
 }
 
@@ -418,16 +580,37 @@ bool sendPldmMessage(boost::asio::yield_context yield, const pldm_tid_t tid,
 {
     constexpr size_t maxRetryCount = 5;
     pldm_msg_hdr* hdr = reinterpret_cast<pldm_msg_hdr*>(payload.data());
+    // Responses answer requests of the terminus, which waits for them. Only
+    // the traffic pldmd initiates is rate limited.
+    const bool isResponse = !hdr->request;
     if (validateReserveBW(tid, hdr->type))
     {
+        const BandwidthReservation* reservation = getReservation(tid);
         phosphor::logging::log<phosphor::logging::level::INFO>(
             ("sendPldmMessage is not allowed. Reserve bandwidth is active for "
              "TID: " +
-             std::to_string(reservedTID) +
-             " RESERVED_PLDM_TYPE: " + std::to_string(reservedPLDMType))
+             std::to_string(reservation->tid) + " RESERVED_PLDM_TYPE: " +
+             std::to_string(reservation->pldmType))
                 .c_str());
         return false;
     }
+    if (auto it = simulatedTermini.find(tid); it != simulatedTermini.end())
+    {
+        if (!isResponse &&
+            !waitForBusCapacity(yield, getSimulatedContentionDomain(tid)))
+        {
+            return false;
+        }
+        it->second->handleMessage(msgTag, tagOwner, payload);
+        return true;
+    }
+    if (!isTerminusAvailable(tid))
+    {
+        phosphor::logging::log<phosphor::logging::level::DEBUG>(
+            "sendPldmMessage is not allowed. Terminus is not responding",
+            phosphor::logging::entry("TID=%d", tid));
+        return false;
+    }
 
     mctpw_eid_t dstEid;
     if (auto eidPtr = tidMapper.getMappedEID(tid))
@@ -453,6 +636,10 @@ bool sendPldmMessage(boost::asio::yield_context yield, const pldm_tid_t tid,
 
     for (size_t retry = 0; retry < retryCount; retry++)
     {
+        if (!isResponse && !waitForBusCapacity(yield, dstEid))
+        {
+            return false;
+        }
         rc = mctpWrapper->sendYield(yield, dstEid, msgTag, tagOwner, payload);
         if (rc.first || rc.second < 0)
         {
@@ -492,6 +679,8 @@ auto msgRecvCallback = [](void*, mctpw::eid_t srcEid, bool tagOwner,
                     .c_str());
             return;
         }
+        // Any message from the terminus proves that it is reachable
+        recordTransportOutcome(*tid, true);
 
         utils::printVect("PLDM message received(MCTP payload):", payload);
         payload.erase(payload.begin());
@@ -525,6 +714,33 @@ uint8_t createInstanceId(pldm_tid_t tid)
     instanceId = (instanceId + 1) & PLDM_INSTANCE_ID_MASK;
     return instanceId;
 }
+
+/** @brief Expose the rate limits, settable per bus*/
+static void initializeRateLimitIntf()
+{
+    using BusRateLimits = std::map<std::string, std::tuple<double, double>>;
+    static std::shared_ptr<sdbusplus::asio::dbus_interface> rateLimitIntf =
+        getObjServer()->add_interface("/xyz/openbmc_project/pldm",
+                                      "xyz.openbmc_project.PLDM.RateLimit");
+    // MCTP binding service of the bus mapped to messages per second and burst
+    rateLimitIntf->register_property(
+        "BusRateLimits", BusRateLimits{},
+        [](const BusRateLimits& req, BusRateLimits& propertyValue) -> int {
+            std::map<ContentionDomain, RateLimit> limits;
+            for (const auto& [bus, limit] : req)
+            {
+                limits[bus] = {std::get<0>(limit), std::get<1>(limit)};
+            }
+            if (!rateLimiter.setDomainLimits(limits))
+            {
+                throw sdbusplus::exception::SdBusError(-EINVAL,
+                                                       "Invalid rate limit");
+            }
+            propertyValue = req;
+            return 1;
+        });
+    rateLimitIntf->initialize();
+}
 } // namespace pldm
 
 void initDevice(const mctpw_eid_t eid, boost::asio::yield_context yield)
@@ -610,6 +826,7 @@ void deleteDevice(const pldm_tid_t tid)
         pldm::platform::deleteMnCTerminus(tid);
     }
     pldm::base::deleteDeviceBaseInfo(tid);
+    pldm::deleteTerminusHealth(tid);
 }
 
 // These are expected to be used only here, so declare them here
@@ -625,12 +842,15 @@ void onDeviceUpdate(void*, const mctpw::Event& evt,
     switch (evt.type)
     {
         case mctpw::Event::EventType::deviceAdded: {
+            // The EID may now be reached through another bus
+            pldm::eidDomains.erase(evt.eid);
             pldm::platform::pauseSensorPolling();
             deviceInitEventHandler(evt.eid, yield);
             pldm::platform::resumeSensorPolling();
             break;
         }
         case mctpw::Event::EventType::deviceRemoved: {
+            pldm::eidDomains.erase(evt.eid);
             auto tid = pldm::tidMapper.getMappedTID(evt.eid);
             if (tid)
             {
@@ -696,10 +916,11 @@ int main(void)
 
     enableDebug();
 
-    // TODO - Read from entity manager about the transport bindings to be
-    // supported by PLDM
     mctpw::MCTPConfiguration config(mctpw::MessageType::pldm,
-                                    mctpw::BindingType::mctpOverSmBus);
+                                    pldm::transportBinding);
+    pldm::rateLimiter.setDefaultLimit(
+        pldm::getDefaultRateLimit(pldm::transportBinding));
+    pldm::initializeRateLimitIntf();
 
     pldm::mctpWrapper = std::make_unique<mctpw::MCTPWrapper>(
         conn, config, onDeviceUpdate, pldm::msgRecvCallback);
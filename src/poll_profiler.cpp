@@ -0,0 +1,247 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "poll_profiler.hpp"
+
+#include <algorithm>
+#include <phosphor-logging/log.hpp>
+
+namespace pldm
+{
+namespace platform
+{
+
+static constexpr std::chrono::minutes summaryInterval{10};
+static constexpr uint8_t p50 = 50;
+static constexpr uint8_t p99 = 99;
+
+static const std::array<const char*, static_cast<size_t>(SkipReason::count)>
+    skipReasonNames = {"SkippedDisabled", "SkippedErrorThreshold",
+                       "SkippedPaused", "SkippedReservation",
+                       "SkippedTerminusUnavailable"};
+
+void DurationHistogram::record(
+    const std::chrono::steady_clock::duration duration)
+{
+    auto millisec = static_cast<uint64_t>(std::max<int64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(duration)
+            .count(),
+        0));
+    size_t bucket = 0;
+    for (uint64_t value = millisec; value != 0 && bucket < bucketCount - 1;
+         value >>= 1)
+    {
+        bucket++;
+    }
+    buckets[bucket]++;
+    count++;
+    maxMillisec = std::max(maxMillisec, millisec);
+}
+
+uint64_t DurationHistogram::percentile(const uint8_t percentile) const
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    // Rank of the sample at the percentile, rounded up
+    uint64_t rank = (count * percentile + 99) / 100;
+    uint64_t cumulative = 0;
+    for (size_t bucket = 0; bucket < bucketCount; bucket++)
+    {
+        cumulative += buckets[bucket];
+        if (cumulative >= rank)
+        {
+            uint64_t upperBound = uint64_t{1} << bucket;
+            return std::min(upperBound, maxMillisec);
+        }
+    }
+    return maxMillisec;
+}
+
+PollProfiler::PollProfiler(const std::chrono::milliseconds minInterval) :
+    _minInterval(minInterval),
+    lastSummary(std::chrono::steady_clock::now())
+{
+}
+
+void PollProfiler::recordRead(const SensorKey& key,
+                              const std::chrono::steady_clock::duration latency,
+                              const bool success)
+{
+    SensorPollStats& sensorStats = stats[key];
+    sensorStats.latency.record(latency);
+    if (!success)
+    {
+        sensorStats.failures++;
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (sensorStats.lastSample != std::chrono::steady_clock::time_point{})
+    {
+        sensorStats.interval.record(now - sensorStats.lastSample);
+    }
+    sensorStats.lastSample = now;
+}
+
+void PollProfiler::recordOnDemandRead(
+    const SensorKey& key, const std::chrono::steady_clock::duration latency,
+    const bool success)
+{
+    SensorPollStats& sensorStats = stats[key];
+    sensorStats.onDemandLatency.record(latency);
+    if (!success)
+    {
+        sensorStats.onDemandFailures++;
+    }
+}
+
+void PollProfiler::recordCycle(
+    const std::vector<SensorKey>& polledSensors,
+    const std::chrono::steady_clock::duration cycleDuration)
+{
+    auto interval = std::max(
+        _minInterval,
+        std::chrono::duration_cast<std::chrono::milliseconds>(cycleDuration));
+    for (const SensorKey& key : polledSensors)
+    {
+        if (auto it = stats.find(key); it != stats.end())
+        {
+            it->second.achievedInterval = interval;
+        }
+    }
+}
+
+void PollProfiler::recordSkip(const SensorKey& key, const SkipReason reason)
+{
+    stats[key].skips[static_cast<size_t>(reason)]++;
+}
+
+void PollProfiler::logSummary()
+{
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastSummary < summaryInterval)
+    {
+        return;
+    }
+    lastSummary = now;
+
+    // One line per terminus with the sensor lagging the most
+    auto it = stats.begin();
+    while (it != stats.end())
+    {
+        pldm_tid_t tid = it->first.first;
+        SensorID worstSensor = it->first.second;
+        uint64_t worstInterval = 0;
+        uint64_t achievedInterval = 0;
+        uint64_t worstLatency = 0;
+        uint64_t failures = 0;
+        uint64_t skips = 0;
+        size_t sensorCount = 0;
+        for (; it != stats.end() && it->first.first == tid; ++it)
+        {
+            const SensorPollStats& sensorStats = it->second;
+            uint64_t interval = sensorStats.interval.percentile(p99);
+            if (interval > worstInterval)
+            {
+                worstInterval = interval;
+                achievedInterval = static_cast<uint64_t>(
+                    sensorStats.achievedInterval.count());
+                worstSensor = it->first.second;
+            }
+            worstLatency =
+                std::max(worstLatency, sensorStats.latency.percentile(p99));
+            failures += sensorStats.failures;
+            for (uint64_t skipCount : sensorStats.skips)
+            {
+                skips += skipCount;
+            }
+            sensorCount++;
+        }
+
+        phosphor::logging::log<phosphor::logging::level::INFO>(
+            "Sensor poll summary", phosphor::logging::entry("TID=%d", tid),
+            phosphor::logging::entry("SENSOR_COUNT=%zu", sensorCount),
+            phosphor::logging::entry("TARGET_INTERVAL_MS=%llu",
+                                     static_cast<unsigned long long>(
+                                         _minInterval.count())),
+            phosphor::logging::entry("ACHIEVED_INTERVAL_MS=%llu",
+                                     static_cast<unsigned long long>(
+                                         achievedInterval)),
+            phosphor::logging::entry("WORST_P99_INTERVAL_MS=%llu",
+                                     static_cast<unsigned long long>(
+                                         worstInterval)),
+            phosphor::logging::entry("WORST_SENSOR_ID=0x%0X", worstSensor),
+            phosphor::logging::entry(
+                "WORST_P99_LATENCY_MS=%llu",
+                static_cast<unsigned long long>(worstLatency)),
+            phosphor::logging::entry(
+                "FAILURES=%llu", static_cast<unsigned long long>(failures)),
+            phosphor::logging::entry("SKIPS=%llu",
+                                     static_cast<unsigned long long>(skips)));
+    }
+}
+
+std::vector<PollProfiler::SensorProfile> PollProfiler::getProfile() const
+{
+    std::vector<SensorProfile> profile;
+    profile.reserve(stats.size());
+    for (const auto& [key, sensorStats] : stats)
+    {
+        std::map<std::string, uint64_t> values = {
+            {"TargetIntervalMs", static_cast<uint64_t>(_minInterval.count())},
+            {"AchievedIntervalMs",
+             static_cast<uint64_t>(sensorStats.achievedInterval.count())},
+            {"Reads", sensorStats.latency.getCount()},
+            {"Failures", sensorStats.failures},
+            {"OnDemandReads", sensorStats.onDemandLatency.getCount()},
+            {"OnDemandFailures", sensorStats.onDemandFailures},
+            {"OnDemandLatencyP99Ms",
+             sensorStats.onDemandLatency.percentile(p99)},
+            {"IntervalP50Ms", sensorStats.interval.percentile(p50)},
+            {"IntervalP99Ms", sensorStats.interval.percentile(p99)},
+            {"IntervalMaxMs", sensorStats.interval.getMax()},
+            {"LatencyP50Ms", sensorStats.latency.percentile(p50)},
+            {"LatencyP99Ms", sensorStats.latency.percentile(p99)},
+            {"LatencyMaxMs", sensorStats.latency.getMax()}};
+        for (size_t reason = 0; reason < skipReasonNames.size(); reason++)
+        {
+            values.emplace(skipReasonNames[reason], sensorStats.skips[reason]);
+        }
+        profile.emplace_back(key.first, key.second, std::move(values));
+    }
+    return profile;
+}
+
+void PollProfiler::reset()
+{
+    stats.clear();
+}
+
+void PollProfiler::removeTerminus(const pldm_tid_t tid)
+{
+    auto first = stats.lower_bound({tid, 0});
+    auto last = first;
+    while (last != stats.end() && last->first.first == tid)
+    {
+        ++last;
+    }
+    stats.erase(first, last);
+}
+
+} // namespace platform
+} // namespace pldm
@@ -0,0 +1,191 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "rate_limiter.hpp"
+
+#include "pldm.hpp"
+
+#include <algorithm>
+#include <phosphor-logging/log.hpp>
+
+namespace pldm
+{
+
+RateLimit getDefaultRateLimit(const mctpw::BindingType bindingType)
+{
+    switch (bindingType)
+    {
+        case mctpw::BindingType::mctpOverPcieVdm:
+            return {200, 20};
+        case mctpw::BindingType::mctpOverSmBus:
+        default:
+            // SMBus devices are usually behind muxes and share the bus with
+            // other management traffic. Keep the limit conservative.
+            return {20, 5};
+    }
+}
+
+TokenBucket::TokenBucket(const RateLimit& rateLimit) :
+    _rateLimit(rateLimit), tokens(rateLimit.burst),
+    lastRefill(std::chrono::steady_clock::now()), dispatchTimer(*getIoContext())
+{
+}
+
+void TokenBucket::refill()
+{
+    auto now = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed = now - lastRefill;
+    lastRefill = now;
+    tokens = std::min(_rateLimit.burst,
+                      tokens + elapsed.count() * _rateLimit.msgsPerSec);
+}
+
+bool TokenBucket::hasWaiters() const
+{
+    return std::any_of(waiters.begin(), waiters.end(),
+                       [](const auto& queue) { return !queue.empty(); });
+}
+
+void TokenBucket::dispatch()
+{
+    refill();
+    // Highest priority first
+    for (auto queue = waiters.rbegin(); queue != waiters.rend(); queue++)
+    {
+        while (tokens >= 1 && !queue->empty())
+        {
+            std::shared_ptr<Waiter> waiter = queue->front();
+            queue->pop_front();
+            tokens -= 1;
+            waiter->granted = true;
+            waiter->wakeUp.cancel();
+        }
+    }
+    if (dispatchScheduled || !hasWaiters())
+    {
+        return;
+    }
+
+    std::chrono::duration<double> wait((1 - tokens) / _rateLimit.msgsPerSec);
+    dispatchScheduled = true;
+    dispatchTimer.expires_after(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(wait));
+    // Buckets are never destroyed, see RateLimiter
+    dispatchTimer.async_wait([this](const boost::system::error_code&) {
+        // Cancelled when the rate changes, the wait is computed again then
+        dispatchScheduled = false;
+        dispatch();
+    });
+}
+
+bool TokenBucket::acquire(boost::asio::yield_context yield,
+                          const MessagePriority priority)
+{
+    refill();
+    if (!hasWaiters() && tokens >= 1)
+    {
+        tokens -= 1;
+        return true;
+    }
+
+    auto waiter = std::make_shared<Waiter>(*getIoContext());
+    auto& queue = waiters[static_cast<size_t>(priority)];
+    queue.push_back(waiter);
+    dispatch();
+    if (!waiter->granted)
+    {
+        boost::system::error_code ec;
+        waiter->wakeUp.async_wait(yield[ec]);
+    }
+    if (!waiter->granted)
+    {
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "Rate limiter wait failed");
+        queue.erase(std::remove(queue.begin(), queue.end(), waiter),
+                    queue.end());
+        return false;
+    }
+    return true;
+}
+
+void TokenBucket::setRateLimit(const RateLimit& rateLimit)
+{
+    refill();
+    _rateLimit = rateLimit;
+    tokens = std::min(_rateLimit.burst, tokens);
+    dispatchTimer.cancel();
+}
+
+bool RateLimiter::isValid(const RateLimit& rateLimit)
+{
+    return rateLimit.msgsPerSec > 0 && rateLimit.burst >= 1;
+}
+
+bool RateLimiter::setDefaultLimit(const RateLimit& rateLimit)
+{
+    if (!isValid(rateLimit))
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Invalid default rate limit configuration");
+        return false;
+    }
+    defaultLimit = rateLimit;
+    for (auto& [domain, bucket] : buckets)
+    {
+        bucket.setRateLimit(getLimit(domain));
+    }
+    return true;
+}
+
+bool RateLimiter::setDomainLimits(
+    const std::map<ContentionDomain, RateLimit>& limits)
+{
+    for (const auto& [domain, rateLimit] : limits)
+    {
+        if (!isValid(rateLimit))
+        {
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                "Invalid rate limit configuration",
+                phosphor::logging::entry("DOMAIN=%s", domain.c_str()));
+            return false;
+        }
+    }
+    domainLimits = limits;
+    for (auto& [domain, bucket] : buckets)
+    {
+        bucket.setRateLimit(getLimit(domain));
+    }
+    return true;
+}
+
+RateLimit RateLimiter::getLimit(const ContentionDomain& domain) const
+{
+    auto it = domainLimits.find(domain);
+    return it == domainLimits.end() ? defaultLimit : it->second;
+}
+
+bool RateLimiter::acquire(boost::asio::yield_context yield,
+                          const ContentionDomain& domain,
+                          const MessagePriority priority)
+{
+    auto bucket = buckets.find(domain);
+    if (bucket == buckets.end())
+    {
+        bucket = buckets.try_emplace(domain, getLimit(domain)).first;
+    }
+    return bucket->second.acquire(yield, priority);
+}
+
+} // namespace pldm
@@ -18,6 +18,7 @@
 
 #include "platform.hpp"
 
+#include <algorithm>
 #include <phosphor-logging/log.hpp>
 
 namespace pldm
@@ -27,6 +28,9 @@ namespace platform
 static const char* pldmPath = "/xyz/openbmc_project/pldm/";
 constexpr const size_t errorThreshold = 5;
 constexpr const uint8_t transitionIntervalSec = 3;
+// Composite effecter count range as per spec DSP0248 Table 89
+constexpr const size_t maxCompositeEffecterCount =
+    PLDM_COMPOSITE_EFFECTER_COUNT_MAX;
 
 StateEffecterHandler::StateEffecterHandler(
     const pldm_tid_t tid, const EffecterID effecterID, const std::string& name,
@@ -34,10 +38,17 @@ StateEffecterHandler::StateEffecterHandler(
     _tid(tid),
     _effecterID(effecterID), _name(name), _pdr(pdr)
 {
-    if (_pdr->possibleStates.empty())
+    if (_pdr->possibleStates.empty() ||
+        _pdr->possibleStates.size() > maxCompositeEffecterCount)
     {
         throw std::runtime_error("State effecter PDR data invalid");
     }
+    compositeEffecterCount =
+        static_cast<uint8_t>(_pdr->possibleStates.size());
+    currentStateReadings.resize(compositeEffecterCount,
+                                std::numeric_limits<uint8_t>::max());
+    pendingStateReadings.resize(compositeEffecterCount,
+                                std::numeric_limits<uint8_t>::max());
     setInitialProperties();
 }
 
@@ -48,12 +59,28 @@ void StateEffecterHandler::setInitialProperties()
 
     effecterInterface =
         addUniqueInterface(path, "xyz.openbmc_project.Effecter.State");
-    // Composite effecters are not supported. Thus extract only first effecter
-    // state
+    // StateSetID, PossibleStates, CurrentState and PendingState always
+    // represent the first effecter instance. States of all the instances are
+    // exposed additionally in case of composite effecter.
     effecterInterface->register_property("StateSetID",
                                          _pdr->possibleStates[0].stateSetID);
     effecterInterface->register_property(
         "PossibleStates", _pdr->possibleStates[0].possibleStateSetValues);
+    if (isCompositeEffecter())
+    {
+        std::vector<uint16_t> stateSetIDs;
+        std::vector<std::vector<uint8_t>> possibleStates;
+        for (const PossibleStates& states : _pdr->possibleStates)
+        {
+            stateSetIDs.emplace_back(states.stateSetID);
+            possibleStates.emplace_back(states.possibleStateSetValues.begin(),
+                                        states.possibleStateSetValues.end());
+        }
+        effecterInterface->register_property("CompositeStateSetIDs",
+                                             stateSetIDs);
+        effecterInterface->register_property("CompositePossibleStates",
+                                             possibleStates);
+    }
 
     availableInterface = addUniqueInterface(
         path, "xyz.openbmc_project.State.Decorator.Availability");
@@ -68,9 +95,16 @@ void StateEffecterHandler::initializeInterface()
         operationalIntfReady)
     {
         effecterInterface->register_property("PendingState",
-                                             pendingStateReading);
+                                             pendingStateReadings[0]);
         effecterInterface->register_property("CurrentState",
-                                             currentStateReading);
+                                             currentStateReadings[0]);
+        if (isCompositeEffecter())
+        {
+            effecterInterface->register_property("CompositePendingStates",
+                                                 pendingStateReadings);
+            effecterInterface->register_property("CompositeCurrentStates",
+                                                 currentStateReadings);
+        }
         effecterInterface->initialize();
 
         availableInterface->register_property("Available", isAvailableReading);
@@ -111,7 +145,9 @@ void StateEffecterHandler::markFunctional(bool isFunctional)
     }
     else
     {
-        updateState(PLDM_INVALID_VALUE, PLDM_INVALID_VALUE);
+        const std::vector<uint8_t> invalidStates(compositeEffecterCount,
+                                                 PLDM_INVALID_VALUE);
+        updateState(invalidStates, invalidStates);
     }
 }
 
@@ -156,8 +192,9 @@ void StateEffecterHandler::incrementError()
     }
 }
 
-void StateEffecterHandler::updateState(const uint8_t currentState,
-                                       const uint8_t pendingState)
+void StateEffecterHandler::updateState(
+    const std::vector<uint8_t>& currentStates,
+    const std::vector<uint8_t>& pendingStates)
 {
     if (!effecterInterface)
     {
@@ -166,21 +203,43 @@ void StateEffecterHandler::updateState(const uint8_t currentState,
         return;
     }
 
+    if (currentStates.size() != compositeEffecterCount ||
+        pendingStates.size() != compositeEffecterCount)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Composite effecter state count mismatch",
+            phosphor::logging::entry("EFFECTER_ID=0x%0X", _effecterID),
+            phosphor::logging::entry("TID=%d", _tid));
+        return;
+    }
+
     if (!interfaceInitialized)
     {
-        currentStateReading = currentState;
-        pendingStateReading = pendingState;
+        currentStateReadings = currentStates;
+        pendingStateReadings = pendingStates;
         effecterIntfReady = true;
         initializeInterface();
     }
     else
     {
-        effecterInterface->set_property("CurrentState", currentState);
-        effecterInterface->set_property("PendingState", pendingState);
+        effecterInterface->set_property("CurrentState", currentStates[0]);
+        effecterInterface->set_property("PendingState", pendingStates[0]);
+        if (isCompositeEffecter())
+        {
+            effecterInterface->set_property("CompositeCurrentStates",
+                                            currentStates);
+            effecterInterface->set_property("CompositePendingStates",
+                                            pendingStates);
+        }
+        currentStateReadings = currentStates;
+        pendingStateReadings = pendingStates;
     }
 
-    if (currentState != PLDM_INVALID_VALUE &&
-        pendingState != PLDM_INVALID_VALUE)
+    auto isInvalid = [](const uint8_t state) {
+        return state == PLDM_INVALID_VALUE;
+    };
+    if (std::none_of(currentStates.begin(), currentStates.end(), isInvalid) &&
+        std::none_of(pendingStates.begin(), pendingStates.end(), isInvalid))
     {
 
         markFunctional(true);
@@ -217,12 +276,16 @@ bool StateEffecterHandler::enableStateEffecter(boost::asio::yield_context yield)
     }
 
     int rc;
-    // TODO: PLDM events and composite effecter supported
-    constexpr uint8_t compositeEffecterCount = 1;
-    std::array<state_effecter_op_field, compositeEffecterCount> opFields = {
-        {effecterOpState, PLDM_DISABLE_EVENTS}};
+    // TODO: PLDM events support
+    std::vector<state_effecter_op_field> opFields(
+        compositeEffecterCount,
+        state_effecter_op_field{effecterOpState, PLDM_DISABLE_EVENTS});
+    // pldm_set_state_effecter_enable_req holds one state_effecter_op_field.
+    // Add the op fields of remaining composite effecter instances.
     std::vector<uint8_t> req(pldmMsgHdrSize +
-                             sizeof(pldm_set_state_effecter_enable_req));
+                             sizeof(pldm_set_state_effecter_enable_req) +
+                             (compositeEffecterCount - 1) *
+                                 sizeof(state_effecter_op_field));
     pldm_msg* reqMsg = reinterpret_cast<pldm_msg*>(req.data());
 
     rc = encode_set_state_effecter_enable_req(
@@ -263,9 +326,37 @@ bool StateEffecterHandler::enableStateEffecter(boost::asio::yield_context yield)
 }
 
 bool StateEffecterHandler::handleStateEffecterState(
-    boost::asio::yield_context yield, get_effecter_state_field& stateReading)
+    boost::asio::yield_context yield,
+    const get_effecter_state_field* stateReadings, const uint8_t effecterCount)
 {
-    switch (stateReading.effecter_op_state)
+    if (effecterCount != compositeEffecterCount)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "GetStateEffecterStates: Composite effecter count mismatch",
+            phosphor::logging::entry("EFFECTER_ID=0x%0X", _effecterID),
+            phosphor::logging::entry("TID=%d", _tid),
+            phosphor::logging::entry("COMPOSITE_EFFECTER_COUNT=%d",
+                                     effecterCount));
+        return false;
+    }
+
+    // Availability and functional status are shared by all the composite
+    // effecter instances. Thus the first instance which is not in steady
+    // enabled state decides the operational state of the effecter.
+    const get_effecter_state_field* stateReadingsEnd =
+        stateReadings + effecterCount;
+    const get_effecter_state_field* notSteady = std::find_if(
+        stateReadings, stateReadingsEnd,
+        [](const get_effecter_state_field& stateReading) {
+            return stateReading.effecter_op_state !=
+                   EFFECTER_OPER_STATE_ENABLED_NOUPDATEPENDING;
+        });
+    const uint8_t effecterOpState =
+        notSteady == stateReadingsEnd
+            ? static_cast<uint8_t>(EFFECTER_OPER_STATE_ENABLED_NOUPDATEPENDING)
+            : notSteady->effecter_op_state;
+
+    switch (effecterOpState)
     {
         case EFFECTER_OPER_STATE_ENABLED_UPDATEPENDING: {
 
@@ -303,7 +394,15 @@ bool StateEffecterHandler::handleStateEffecterState(
             break;
         }
         case EFFECTER_OPER_STATE_ENABLED_NOUPDATEPENDING: {
-            updateState(stateReading.present_state, stateReading.pending_state);
+            std::vector<uint8_t> currentStates;
+            std::vector<uint8_t> pendingStates;
+            for (const get_effecter_state_field* stateReading = stateReadings;
+                 stateReading != stateReadingsEnd; stateReading++)
+            {
+                currentStates.emplace_back(stateReading->present_state);
+                pendingStates.emplace_back(stateReading->pending_state);
+            }
+            updateState(currentStates, pendingStates);
 
             phosphor::logging::log<phosphor::logging::level::DEBUG>(
                 "GetStateEffecterStates success",
@@ -341,8 +440,7 @@ bool StateEffecterHandler::handleStateEffecterState(
             return false;
     }
 
-    if (stateReading.effecter_op_state !=
-        EFFECTER_OPER_STATE_ENABLED_UPDATEPENDING)
+    if (effecterOpState != EFFECTER_OPER_STATE_ENABLED_UPDATEPENDING)
     {
         stateCmdRetryCount = 0;
     }
@@ -376,23 +474,22 @@ bool StateEffecterHandler::getStateEffecterStates(
     }
 
     uint8_t completionCode;
-    // Pass compositeEffecterCount as 1 to indicate that only one effecter
-    // instance is supported
-    uint8_t compositeEffecterCount = PLDM_COMPOSITE_EFFECTER_COUNT_MIN;
-    std::array<get_effecter_state_field, PLDM_COMPOSITE_EFFECTER_COUNT_MAX>
+    // All the composite effecter instances are read in one transaction
+    uint8_t effecterCount = compositeEffecterCount;
+    std::array<get_effecter_state_field, maxCompositeEffecterCount>
         stateField{};
     auto rspMsg = reinterpret_cast<pldm_msg*>(resp.data());
 
     rc = decode_get_state_effecter_states_resp(
-        rspMsg, resp.size() - pldmMsgHdrSize, &completionCode,
-        &compositeEffecterCount, stateField.data());
+        rspMsg, resp.size() - pldmMsgHdrSize, &completionCode, &effecterCount,
+        stateField.data());
     if (!validatePLDMRespDecode(_tid, rc, completionCode,
                                 "GetStateEffecterStates"))
     {
         return false;
     }
 
-    if (!compositeEffecterCount)
+    if (!effecterCount)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "GetStateEffecterStates: Invalid composite effecter count",
@@ -400,9 +497,7 @@ bool StateEffecterHandler::getStateEffecterStates(
             phosphor::logging::entry("TID=%d", _tid));
         return false;
     }
-    // Handle only first value.
-    // TODO: Composite effecter support.
-    return handleStateEffecterState(yield, stateField[0]);
+    return handleStateEffecterState(yield, stateField.data(), effecterCount);
 }
 
 bool StateEffecterHandler::populateEffecterValue(
@@ -416,38 +511,52 @@ bool StateEffecterHandler::populateEffecterValue(
     return true;
 }
 
-bool StateEffecterHandler::isEffecterStateSettable(const uint8_t state)
+bool StateEffecterHandler::isEffecterStateSettable(const size_t effecterOffset,
+                                                   const uint8_t state)
 {
     // Note:- possibleStates will never be empty
-    auto itr =
-        std::find(_pdr->possibleStates[0].possibleStateSetValues.begin(),
-                  _pdr->possibleStates[0].possibleStateSetValues.end(), state);
-    if (itr != _pdr->possibleStates[0].possibleStateSetValues.end())
+    if (effecterOffset < _pdr->possibleStates.size() &&
+        _pdr->possibleStates[effecterOffset].possibleStateSetValues.count(
+            state))
     {
         return true;
     }
     phosphor::logging::log<phosphor::logging::level::WARNING>(
         "State not supported by effecter",
         phosphor::logging::entry("EFFECTER_ID=0x%0X", _effecterID),
-        phosphor::logging::entry("TID=%d", _tid));
+        phosphor::logging::entry("TID=%d", _tid),
+        phosphor::logging::entry("EFFECTER_OFFSET=%zu", effecterOffset));
     return false;
 }
 
-bool StateEffecterHandler::setEffecter(boost::asio::yield_context yield,
-                                       const uint8_t state)
+bool StateEffecterHandler::setEffecter(
+    boost::asio::yield_context yield,
+    const std::vector<set_effecter_state_field>& stateFields)
 {
     int rc;
 
-    // Composite effecters not spported
-    constexpr size_t minSetStateEffecterStatesSize = 5;
-    std::vector<uint8_t> req(pldmMsgHdrSize + minSetStateEffecterStatesSize);
+    if (stateFields.size() != compositeEffecterCount)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "SetStateEffecterStates: Composite effecter count mismatch",
+            phosphor::logging::entry("EFFECTER_ID=0x%0X", _effecterID),
+            phosphor::logging::entry("TID=%d", _tid));
+        return false;
+    }
+
+    // EffecterID and compositeEffecterCount followed by one
+    // set_effecter_state_field per composite effecter instance
+    constexpr size_t setStateEffecterStatesHdrSize = 3;
+    std::vector<uint8_t> req(pldmMsgHdrSize + setStateEffecterStatesHdrSize +
+                             stateFields.size() *
+                                 sizeof(set_effecter_state_field));
     pldm_msg* reqMsg = reinterpret_cast<pldm_msg*>(req.data());
-    set_effecter_state_field stateField = {PLDM_REQUEST_SET, state};
+    // encode_set_state_effecter_states_req takes non-const field pointer
+    std::vector<set_effecter_state_field> fields = stateFields;
 
-    constexpr size_t compositeEffecterCount = 1;
     rc = encode_set_state_effecter_states_req(
         createInstanceId(_tid), _effecterID, compositeEffecterCount,
-        &stateField, reqMsg);
+        fields.data(), reqMsg);
     if (!validatePLDMReqEncode(_tid, rc, "SetStateEffecterStates"))
     {
         return false;
@@ -482,16 +591,50 @@ bool StateEffecterHandler::setEffecter(boost::asio::yield_context yield,
     return true;
 }
 
+void StateEffecterHandler::refreshEffecterInterfaces()
+{
+    if (stateCmdRetryCount != 0)
+    {
+        phosphor::logging::log<phosphor::logging::level::DEBUG>(
+            "state effecter UpdatePending Retry In Progress");
+        return;
+    }
+
+    transitionIntervalTimer->expires_after(
+        boost::asio::chrono::seconds(transitionIntervalSec));
+    transitionIntervalTimer->async_wait(
+        [this](const boost::system::error_code& e) {
+            if (e)
+            {
+                phosphor::logging::log<phosphor::logging::level::ERR>(
+                    "SetStateEffecter: async_wait error");
+            }
+            boost::asio::spawn(
+                *getIoContext(), [this](boost::asio::yield_context yieldCtx) {
+                    if (!populateEffecterValue(yieldCtx))
+                    {
+                        phosphor::logging::log<phosphor::logging::level::ERR>(
+                            "Read state effecter failed",
+                            phosphor::logging::entry("EFFECTER_ID=0x%0X",
+                                                     _effecterID),
+                            phosphor::logging::entry("TID=%d", _tid));
+                    }
+                });
+        });
+}
+
 void StateEffecterHandler::registerSetEffecter()
 {
     const std::string path =
         pldmPath + std::to_string(_tid) + "/state_effecter/" + _name;
     setEffecterInterface = addUniqueInterface(
         path, "xyz.openbmc_project.Effecter.SetStateEffecter");
+    // SetEffecter sets the first effecter instance. Remaining instances of a
+    // composite effecter are left unchanged.
     setEffecterInterface->register_method(
         "SetEffecter",
         [this](boost::asio::yield_context yield, uint8_t effecterState) {
-            if (!isEffecterStateSettable(effecterState))
+            if (!isEffecterStateSettable(0, effecterState))
             {
                 phosphor::logging::log<phosphor::logging::level::WARNING>(
                     "Unsupported effecter data state received",
@@ -502,7 +645,11 @@ void StateEffecterHandler::registerSetEffecter()
                 throw sdbusplus::exception::SdBusError(
                     -EINVAL, "Unsupported effecter state");
             }
-            if (!setEffecter(yield, effecterState))
+            std::vector<set_effecter_state_field> stateFields(
+                compositeEffecterCount,
+                set_effecter_state_field{PLDM_NO_CHANGE, 0x00});
+            stateFields[0] = {PLDM_REQUEST_SET, effecterState};
+            if (!setEffecter(yield, stateFields))
             {
                 phosphor::logging::log<phosphor::logging::level::ERR>(
                     "Failed to SetStateEffecterStates",
@@ -513,45 +660,54 @@ void StateEffecterHandler::registerSetEffecter()
                     -EINVAL, "SetStateEffecterStates failed");
             }
 
-            auto refreshEffecterInterfaces = [this]() {
-                boost::system::error_code ec;
-                if (stateCmdRetryCount != 0)
+            // Refresh the value on D-Bus
+            getIoContext()->post([this]() { refreshEffecterInterfaces(); });
+        });
+    if (isCompositeEffecter())
+    {
+        // SetCompositeEffecter sets all the composite effecter instances in
+        // one transaction. States are ordered as CompositeStateSetIDs.
+        setEffecterInterface->register_method(
+            "SetCompositeEffecter", [this](boost::asio::yield_context yield,
+                                           std::vector<uint8_t> states) {
+                if (states.size() != compositeEffecterCount)
                 {
-                    phosphor::logging::log<phosphor::logging::level::DEBUG>(
-                        "state effecter UpdatePending Retry In Progress");
-                    return;
+                    phosphor::logging::log<phosphor::logging::level::WARNING>(
+                        "Invalid number of composite effecter states",
+                        phosphor::logging::entry("EFFECTER_ID=0x%0X",
+                                                 _effecterID),
+                        phosphor::logging::entry("TID=%d", _tid));
+
+                    throw sdbusplus::exception::SdBusError(
+                        -EINVAL, "Invalid number of effecter states");
+                }
+                std::vector<set_effecter_state_field> stateFields;
+                for (size_t offset = 0; offset < states.size(); offset++)
+                {
+                    if (!isEffecterStateSettable(offset, states[offset]))
+                    {
+                        throw sdbusplus::exception::SdBusError(
+                            -EINVAL, "Unsupported effecter state");
+                    }
+                    stateFields.push_back({PLDM_REQUEST_SET, states[offset]});
+                }
+                if (!setEffecter(yield, stateFields))
+                {
+                    phosphor::logging::log<phosphor::logging::level::ERR>(
+                        "Failed to SetStateEffecterStates",
+                        phosphor::logging::entry("EFFECTER_ID=0x%0X",
+                                                 _effecterID),
+                        phosphor::logging::entry("TID=%d", _tid));
+
+                    throw sdbusplus::exception::SdBusError(
+                        -EINVAL, "SetStateEffecterStates failed");
                 }
 
-                transitionIntervalTimer->expires_after(
-                    boost::asio::chrono::seconds(transitionIntervalSec));
-                transitionIntervalTimer->async_wait(
-                    [this](const boost::system::error_code& e) {
-                        if (e)
-                        {
-                            phosphor::logging::log<
-                                phosphor::logging::level::ERR>(
-                                "SetStateEffecter: async_wait error");
-                        }
-                        boost::asio::spawn(
-                            *getIoContext(),
-                            [this](boost::asio::yield_context yieldCtx) {
-                                if (!populateEffecterValue(yieldCtx))
-                                {
-                                    phosphor::logging::log<
-                                        phosphor::logging::level::ERR>(
-                                        "Read state effecter failed",
-                                        phosphor::logging::entry(
-                                            "EFFECTER_ID=0x%0X", _effecterID),
-                                        phosphor::logging::entry("TID=%d",
-                                                                 _tid));
-                                }
-                            });
-                    });
-            };
-
-            // Refresh the value on D-Bus
-            getIoContext()->post(refreshEffecterInterfaces);
-        });
+                // Refresh the value on D-Bus
+                getIoContext()->post(
+                    [this]() { refreshEffecterInterfaces(); });
+            });
+    }
     setEffecterInterface->initialize();
 }
 
@@ -18,7 +18,9 @@
 
 #include "platform.hpp"
 #include "state_set.hpp"
+#include "utils.hpp"
 
+#include <algorithm>
 #include <phosphor-logging/log.hpp>
 
 namespace pldm
@@ -27,6 +29,8 @@ namespace platform
 {
 const static constexpr char* pldmPath = "/xyz/openbmc_project/pldm/";
 constexpr const size_t errorThreshold = 3;
+// Composite sensor count range as per spec DSP0248 Table 81
+constexpr const size_t maxCompositeSensorCount = 0x08;
 
 StateSensorHandler::StateSensorHandler(
     const pldm_tid_t tid, const SensorID sensorID, const std::string& name,
@@ -34,10 +38,14 @@ StateSensorHandler::StateSensorHandler(
     _tid(tid),
     _sensorID(sensorID), _name(name), _pdr(pdr)
 {
-    if (_pdr->possibleStates.empty())
+    if (_pdr->possibleStates.empty() ||
+        _pdr->possibleStates.size() > maxCompositeSensorCount)
     {
         throw std::runtime_error("State sensor PDR data invalid");
     }
+    compositeSensorCount = static_cast<uint8_t>(_pdr->possibleStates.size());
+    currentStateReadings.resize(compositeSensorCount, PLDM_INVALID_VALUE);
+    previousStateReadings.resize(compositeSensorCount, PLDM_INVALID_VALUE);
 
     setInitialProperties();
 }
@@ -49,18 +57,49 @@ void StateSensorHandler::setInitialProperties()
 
     sensorInterface =
         addUniqueInterface(path, "xyz.openbmc_project.Sensor.State");
-    // Composite sensors are not supported. Thus extract only first sensor
-    // states
+    // StateSetID, PossibleStates, CurrentState and PreviousState always
+    // represent the first sensor instance. States of all the instances are
+    // exposed additionally in case of composite sensor.
     sensorInterface->register_property("StateSetID",
                                        _pdr->possibleStates[0].stateSetID);
     sensorInterface->register_property(
         "PossibleStates", _pdr->possibleStates[0].possibleStateSetValues);
+    if (isCompositeSensor())
+    {
+        std::vector<uint16_t> stateSetIDs;
+        std::vector<std::vector<uint8_t>> possibleStates;
+        for (const PossibleStates& states : _pdr->possibleStates)
+        {
+            stateSetIDs.emplace_back(states.stateSetID);
+            possibleStates.emplace_back(states.possibleStateSetValues.begin(),
+                                        states.possibleStateSetValues.end());
+        }
+        sensorInterface->register_property("CompositeStateSetIDs",
+                                           stateSetIDs);
+        sensorInterface->register_property("CompositePossibleStates",
+                                           possibleStates);
+    }
 
     availableInterface = addUniqueInterface(
         path, "xyz.openbmc_project.State.Decorator.Availability");
 
     operationalInterface = addUniqueInterface(
         path, "xyz.openbmc_project.State.Decorator.OperationalStatus");
+
+    // LastUpdated is computed on read to avoid a PropertiesChanged signal on
+    // every sensor poll
+    timestampInterface =
+        addUniqueInterface(path, "xyz.openbmc_project.PLDM.SensorTimestamp");
+    timestampInterface->register_property(
+        "LastUpdated", static_cast<uint64_t>(0),
+        [](const uint64_t&, uint64_t&) -> int {
+            throw sdbusplus::exception::SdBusError(-EPERM,
+                                                   "LastUpdated is read only");
+        },
+        [this](const uint64_t&) {
+            return utils::toEpochMicroseconds(lastUpdated);
+        });
+    timestampInterface->initialize();
 }
 
 void StateSensorHandler::initializeInterface()
@@ -69,8 +108,16 @@ void StateSensorHandler::initializeInterface()
         operationalIntfReady)
     {
         sensorInterface->register_property("PreviousState",
-                                           previousStateReading);
-        sensorInterface->register_property("CurrentState", currentStateReading);
+                                           previousStateReadings[0]);
+        sensorInterface->register_property("CurrentState",
+                                           currentStateReadings[0]);
+        if (isCompositeSensor())
+        {
+            sensorInterface->register_property("CompositePreviousStates",
+                                               previousStateReadings);
+            sensorInterface->register_property("CompositeCurrentStates",
+                                               currentStateReadings);
+        }
         sensorInterface->initialize();
 
         availableInterface->register_property("Available", isAvailableReading);
@@ -111,7 +158,9 @@ void StateSensorHandler::markFunctional(bool isFunctional)
     }
     else
     {
-        updateState(PLDM_INVALID_VALUE, PLDM_INVALID_VALUE);
+        const std::vector<uint8_t> invalidStates(compositeSensorCount,
+                                                 PLDM_INVALID_VALUE);
+        updateState(invalidStates, invalidStates);
     }
 }
 
@@ -161,10 +210,17 @@ bool StateSensorHandler::sensorErrorCheck()
     return errCount < errorThreshold;
 }
 
-void StateSensorHandler::logStateChangeEvent(const uint8_t currentState,
+void StateSensorHandler::resetErrorCount()
+{
+    errCount = 0;
+}
+
+void StateSensorHandler::logStateChangeEvent(const size_t sensorOffset,
+                                             const uint8_t currentState,
                                              const uint8_t previousState)
 {
-    auto stateSetItr = stateSetMap.find(_pdr->possibleStates[0].stateSetID);
+    auto stateSetItr =
+        stateSetMap.find(_pdr->possibleStates[sensorOffset].stateSetID);
     if (stateSetItr == stateSetMap.end())
     {
         return;
@@ -206,8 +262,8 @@ void StateSensorHandler::logStateChangeEvent(const uint8_t currentState,
                                  currentStateSetValueInfo.stateSetValueName));
 }
 
-void StateSensorHandler::updateState(const uint8_t currentState,
-                                     const uint8_t previousState)
+void StateSensorHandler::updateState(const std::vector<uint8_t>& currentStates,
+                                     const std::vector<uint8_t>& previousStates)
 {
     if (!sensorInterface)
     {
@@ -216,30 +272,54 @@ void StateSensorHandler::updateState(const uint8_t currentState,
         return;
     }
 
+    if (currentStates.size() != compositeSensorCount ||
+        previousStates.size() != compositeSensorCount)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Composite sensor state count mismatch",
+            phosphor::logging::entry("SENSOR_ID=0x%0X", _sensorID),
+            phosphor::logging::entry("TID=%d", _tid));
+        return;
+    }
+
     if (!interfaceInitialized)
     {
-        currentStateReading = currentState;
-        previousStateReading = previousState;
+        currentStateReadings = currentStates;
+        previousStateReadings = previousStates;
         sensorIntfReady = true;
         initializeInterface();
     }
     else
     {
-        if ((currentStateReading != currentState &&
-             currentState != PLDM_INVALID_VALUE) ||
-            (previousStateReading != previousState &&
-             previousState != PLDM_INVALID_VALUE))
+        for (size_t offset = 0; offset < compositeSensorCount; offset++)
         {
-            logStateChangeEvent(currentState, previousState);
+            if ((currentStateReadings[offset] != currentStates[offset] &&
+                 currentStates[offset] != PLDM_INVALID_VALUE) ||
+                (previousStateReadings[offset] != previousStates[offset] &&
+                 previousStates[offset] != PLDM_INVALID_VALUE))
+            {
+                logStateChangeEvent(offset, currentStates[offset],
+                                    previousStates[offset]);
+            }
         }
-        sensorInterface->set_property("CurrentState", currentState);
-        sensorInterface->set_property("PreviousState", previousState);
-        currentStateReading = currentState;
-        previousStateReading = previousState;
+        sensorInterface->set_property("CurrentState", currentStates[0]);
+        sensorInterface->set_property("PreviousState", previousStates[0]);
+        if (isCompositeSensor())
+        {
+            sensorInterface->set_property("CompositeCurrentStates",
+                                          currentStates);
+            sensorInterface->set_property("CompositePreviousStates",
+                                          previousStates);
+        }
+        currentStateReadings = currentStates;
+        previousStateReadings = previousStates;
     }
 
-    if (currentState != PLDM_INVALID_VALUE &&
-        previousState != PLDM_INVALID_VALUE)
+    auto isInvalid = [](const uint8_t state) {
+        return state == PLDM_INVALID_VALUE;
+    };
+    if (std::none_of(currentStates.begin(), currentStates.end(), isInvalid) &&
+        std::none_of(previousStates.begin(), previousStates.end(), isInvalid))
     {
         markFunctional(true);
         markAvailable(true);
@@ -247,9 +327,35 @@ void StateSensorHandler::updateState(const uint8_t currentState,
 }
 
 bool StateSensorHandler::handleSensorReading(
-    get_sensor_state_field& stateReading)
+    const get_sensor_state_field* stateReadings, const uint8_t sensorCount)
 {
-    switch (stateReading.sensor_op_state)
+    if (sensorCount != compositeSensorCount)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "GetStateSensorReadings: Composite sensor count mismatch",
+            phosphor::logging::entry("SENSOR_ID=0x%0X", _sensorID),
+            phosphor::logging::entry("TID=%d", _tid),
+            phosphor::logging::entry("COMPOSITE_SENSOR_COUNT=%d",
+                                     sensorCount));
+        return false;
+    }
+
+    // Availability and functional status are shared by all the composite
+    // sensor instances. Thus the first instance which is not enabled decides
+    // the operational state of the sensor.
+    const get_sensor_state_field* stateReadingsEnd =
+        stateReadings + sensorCount;
+    const get_sensor_state_field* notEnabled =
+        std::find_if(stateReadings, stateReadingsEnd,
+                     [](const get_sensor_state_field& stateReading) {
+                         return stateReading.sensor_op_state !=
+                                PLDM_SENSOR_ENABLED;
+                     });
+    const uint8_t sensorOpState = notEnabled == stateReadingsEnd
+                                      ? static_cast<uint8_t>(PLDM_SENSOR_ENABLED)
+                                      : notEnabled->sensor_op_state;
+
+    switch (sensorOpState)
     {
         case PLDM_SENSOR_DISABLED: {
             markFunctional(false);
@@ -272,8 +378,15 @@ bool StateSensorHandler::handleSensorReading(
             return false;
         }
         case PLDM_SENSOR_ENABLED: {
-            updateState(stateReading.present_state,
-                        stateReading.previous_state);
+            std::vector<uint8_t> currentStates;
+            std::vector<uint8_t> previousStates;
+            for (const get_sensor_state_field* stateReading = stateReadings;
+                 stateReading != stateReadingsEnd; stateReading++)
+            {
+                currentStates.emplace_back(stateReading->present_state);
+                previousStates.emplace_back(stateReading->previous_state);
+            }
+            updateState(currentStates, previousStates);
 
             phosphor::logging::log<phosphor::logging::level::DEBUG>(
                 "GetStateSensorReadings success",
@@ -328,12 +441,16 @@ bool StateSensorHandler::setStateSensorEnables(boost::asio::yield_context yield)
     }
 
     int rc;
-    // TODO: PLDM events and composite sensor support
-    constexpr uint8_t compositeSensorCount = 1;
-    std::array<state_sensor_op_field, compositeSensorCount> opFields = {
-        {sensorOpState, PLDM_NO_EVENT_GENERATION}};
+    // TODO: PLDM events support
+    std::vector<state_sensor_op_field> opFields(
+        compositeSensorCount,
+        state_sensor_op_field{sensorOpState, PLDM_NO_EVENT_GENERATION});
+    // pldm_set_state_sensor_enable_req holds one state_sensor_op_field. Add
+    // the op fields of remaining composite sensor instances.
     std::vector<uint8_t> req(pldmMsgHdrSize +
-                             sizeof(pldm_set_state_sensor_enable_req));
+                             sizeof(pldm_set_state_sensor_enable_req) +
+                             (compositeSensorCount - 1) *
+                                 sizeof(state_sensor_op_field));
     pldm_msg* reqMsg = reinterpret_cast<pldm_msg*>(req.data());
 
     // TODO: Init state as per State Sensor Initialization PDR
@@ -375,13 +492,13 @@ bool StateSensorHandler::setStateSensorEnables(boost::asio::yield_context yield)
 }
 
 bool StateSensorHandler::getStateSensorReadings(
-    boost::asio::yield_context yield)
+    boost::asio::yield_context yield, const MessagePriority priority)
 {
     int rc;
     std::vector<uint8_t> req(pldmMsgHdrSize +
                              PLDM_GET_STATE_SENSOR_READINGS_REQ_BYTES);
     pldm_msg* reqMsg = reinterpret_cast<pldm_msg*>(req.data());
-    // PLDM events and composite sensor are not supported
+    // PLDM events are not supported
     constexpr bitfield8_t sensorRearm = {0x00};
     constexpr uint8_t reserved = 0x00;
 
@@ -394,7 +511,7 @@ bool StateSensorHandler::getStateSensorReadings(
 
     std::vector<uint8_t> resp;
     if (!sendReceivePldmMessage(yield, _tid, commandTimeout, commandRetryCount,
-                                req, resp))
+                                req, resp, std::nullopt, priority))
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "Failed to send or receive GetStateSensorReadings request",
@@ -404,38 +521,37 @@ bool StateSensorHandler::getStateSensorReadings(
     }
 
     uint8_t completionCode;
-    // Pass compositeSensorCount as 1 to indicate that only one sensor instance
-    // is supported
-    uint8_t compositeSensorCount = 1;
-    constexpr size_t maxCompositeSensorCount = 0x08;
+    // All the composite sensor instances are read in one transaction
+    uint8_t sensorCount = compositeSensorCount;
     std::array<get_sensor_state_field, maxCompositeSensorCount> stateField{};
     auto rspMsg = reinterpret_cast<pldm_msg*>(resp.data());
 
     rc = decode_get_state_sensor_readings_resp(
-        rspMsg, resp.size() - pldmMsgHdrSize, &completionCode,
-        &compositeSensorCount, stateField.data());
+        rspMsg, resp.size() - pldmMsgHdrSize, &completionCode, &sensorCount,
+        stateField.data());
     if (!validatePLDMRespDecode(_tid, rc, completionCode,
                                 "GetStateSensorReadings"))
     {
         return false;
     }
 
-    // Handle only first value. Composite sensor not supported.
-    return handleSensorReading(stateField[0]);
+    return handleSensorReading(stateField.data(), sensorCount);
 }
 
-bool StateSensorHandler::populateSensorValue(boost::asio::yield_context yield)
+bool StateSensorHandler::populateSensorValue(
+    boost::asio::yield_context yield, const MessagePriority priority)
 {
     // No need to read the sensor if it is disabled
     if (_pdr->stateSensorData.sensor_init == PLDM_SENSOR_DISABLE)
     {
         return false;
     }
-    if (!getStateSensorReadings(yield))
+    if (!getStateSensorReadings(yield, priority))
     {
         incrementError();
         return false;
     }
+    lastUpdated = std::chrono::steady_clock::now();
     return true;
 }
 
@@ -0,0 +1,218 @@
+/**
+ * Copyright © 2021 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "terminus_health.hpp"
+
+#include <algorithm>
+#include <phosphor-logging/log.hpp>
+
+namespace pldm
+{
+
+// Number of consecutive failed transactions to open the circuit. Each failed
+// transaction is already retried by the transport.
+constexpr size_t openThreshold = 3;
+constexpr std::chrono::milliseconds minProbeInterval{1000};
+constexpr std::chrono::milliseconds maxProbeInterval{64000};
+constexpr uint16_t probeTimeout = 100;
+constexpr size_t probeRetryCount = 1;
+
+static std::unordered_map<pldm_tid_t, std::shared_ptr<CircuitBreaker>>
+    circuitBreakers;
+
+// GetTID is used as probe since every terminus must support it and the
+// response is small. Any response, even with an error completion code, proves
+// that the terminus is reachable.
+static bool probeTerminus(boost::asio::yield_context yield,
+                          const pldm_tid_t tid)
+{
+    auto eid = tidMapper.getMappedEID(tid);
+    if (!eid)
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> getTIDRequest(sizeof(PLDMEmptyRequest), 0x00);
+    auto msg = reinterpret_cast<pldm_msg*>(getTIDRequest.data());
+    int rc = encode_get_tid_req(createInstanceId(tid), msg);
+    if (!validatePLDMReqEncode(tid, rc, "GetTID"))
+    {
+        return false;
+    }
+
+    // Probe is sent without TID so that it is not blocked by the open circuit
+    std::vector<uint8_t> getTIDResponse;
+    return sendReceivePldmMessage(yield, pldmInvalidTid, probeTimeout,
+                                  probeRetryCount, getTIDRequest,
+                                  getTIDResponse, *eid);
+}
+
+CircuitBreaker::CircuitBreaker(const pldm_tid_t tid) :
+    _tid(tid), probeInterval(minProbeInterval), probeTimer(*getIoContext())
+{
+}
+
+CircuitBreaker::~CircuitBreaker()
+{
+    probeTimer.cancel();
+}
+
+void CircuitBreaker::recordSuccess()
+{
+    consecutiveFailures = 0;
+    if (health == TerminusHealth::healthy)
+    {
+        probeInterval = minProbeInterval;
+        return;
+    }
+
+    if (health == TerminusHealth::open)
+    {
+        probeTimer.cancel();
+        health = TerminusHealth::healthy;
+        phosphor::logging::log<phosphor::logging::level::INFO>(
+            "Terminus recovered. Restoring the traffic",
+            phosphor::logging::entry("TID=%d", _tid));
+        platform::resumeTerminusMonitoring(_tid);
+        return;
+    }
+    health = TerminusHealth::healthy;
+}
+
+void CircuitBreaker::recordFailure()
+{
+    if (health == TerminusHealth::open)
+    {
+        return;
+    }
+
+    consecutiveFailures++;
+    if (consecutiveFailures >= openThreshold)
+    {
+        openCircuit();
+        return;
+    }
+    if (health == TerminusHealth::healthy)
+    {
+        health = TerminusHealth::degraded;
+        phosphor::logging::log<phosphor::logging::level::WARNING>(
+            "Terminus degraded", phosphor::logging::entry("TID=%d", _tid));
+    }
+}
+
+void CircuitBreaker::openCircuit()
+{
+    health = TerminusHealth::open;
+    phosphor::logging::log<phosphor::logging::level::ERR>(
+        "Terminus not responding. Blocking the traffic",
+        phosphor::logging::entry("TID=%d", _tid),
+        phosphor::logging::entry(
+            "PROBE_INTERVAL_MS=%lld",
+            static_cast<long long>(probeInterval.count())));
+    scheduleProbe();
+}
+
+void CircuitBreaker::scheduleProbe()
+{
+    std::weak_ptr<CircuitBreaker> weak = weak_from_this();
+    pldm_tid_t tid = _tid;
+    probeTimer.expires_after(probeInterval);
+    probeTimer.async_wait([weak, tid](const boost::system::error_code& ec) {
+        if (ec)
+        {
+            return;
+        }
+        boost::asio::spawn(
+            *getIoContext(), [weak, tid](boost::asio::yield_context yield) {
+                bool success = probeTerminus(yield, tid);
+                // Terminus can be removed while the probe is in progress
+                if (auto self = weak.lock())
+                {
+                    self->onProbeComplete(success);
+                }
+            });
+    });
+}
+
+void CircuitBreaker::onProbeComplete(const bool success)
+{
+    if (health != TerminusHealth::open)
+    {
+        return;
+    }
+
+    probeInterval = std::min(2 * probeInterval, maxProbeInterval);
+    if (success)
+    {
+        recordSuccess();
+        return;
+    }
+    phosphor::logging::log<phosphor::logging::level::DEBUG>(
+        "Terminus probe failed", phosphor::logging::entry("TID=%d", _tid));
+    scheduleProbe();
+}
+
+bool isTerminusAvailable(const pldm_tid_t tid)
+{
+    return getTerminusHealth(tid) != TerminusHealth::open;
+}
+
+void recordTransportOutcome(const pldm_tid_t tid, const bool success)
+{
+    // Messages sent without TID are not bound to a terminus. eg: Discovery and
+    // probe
+    if (tid == pldmInvalidTid)
+    {
+        return;
+    }
+
+    auto it = circuitBreakers.find(tid);
+    if (it == circuitBreakers.end())
+    {
+        if (success)
+        {
+            return;
+        }
+        it = circuitBreakers
+                 .emplace(tid, std::make_shared<CircuitBreaker>(tid))
+                 .first;
+    }
+
+    if (success)
+    {
+        it->second->recordSuccess();
+    }
+    else
+    {
+        it->second->recordFailure();
+    }
+}
+
+TerminusHealth getTerminusHealth(const pldm_tid_t tid)
+{
+    auto it = circuitBreakers.find(tid);
+    if (it == circuitBreakers.end())
+    {
+        return TerminusHealth::healthy;
+    }
+    return it->second->getHealth();
+}
+
+void deleteTerminusHealth(const pldm_tid_t tid)
+{
+    circuitBreakers.erase(tid);
+}
+
+} // namespace pldm
@@ -16,6 +16,7 @@
 
 #include "utils.hpp"
 
+#include <array>
 #include <iomanip>
 #include <phosphor-logging/log.hpp>
 #include <sstream>
@@ -39,4 +40,44 @@ void printVect(const std::string& msg, const std::vector<uint8_t>& vec)
         ssVec.str().c_str());
 }
 
+uint64_t toEpochMicroseconds(
+    const std::chrono::steady_clock::time_point& timePoint)
+{
+    if (timePoint == std::chrono::steady_clock::time_point{})
+    {
+        return 0;
+    }
+    auto age = std::chrono::steady_clock::now() - timePoint;
+    auto wallClockTime = std::chrono::system_clock::now() -
+                         std::chrono::duration_cast<
+                             std::chrono::system_clock::duration>(age);
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            wallClockTime.time_since_epoch())
+            .count());
+}
+
+// Lookup table of the reflected CRC-32 polynomial 0xEDB88320
+static constexpr std::array<uint32_t, 256> crc32Table = [] {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t byte = 0; byte < table.size(); byte++)
+    {
+        uint32_t crc = byte;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320U : crc >> 1;
+        }
+        table[byte] = crc;
+    }
+    return table;
+}();
+
+void Crc32::update(const uint8_t* data, size_t size)
+{
+    while (size--)
+    {
+        crc = crc32Table[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    }
+}
+
 } // namespace utils